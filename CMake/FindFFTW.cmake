@@ -1,4 +1,4 @@
-# Find fftw
+# Find fftw (single precision)
 #
 # This module defines
 # FFTW_INCLUDE_DIRS
@@ -6,7 +6,7 @@
 # FFTW_FOUND
 
 find_path(FFTW_INCLUDE_DIR NAMES fftw3.h HINTS /usr/include $ENV{FFTW_HOME}/include)
-find_library(FFTW_LIBRARY NAMES fftw3 HINTS /lib /usr/lib $ENV{FFTW_HOME}/lib)
+find_library(FFTW_LIBRARY NAMES fftw3f HINTS /lib /usr/lib $ENV{FFTW_HOME}/lib)
 
 set(FFTW_INCLUDE_DIRS ${FFTW_INCLUDE_DIR})
 set(FFTW_LIBRARIES ${FFTW_LIBRARY})
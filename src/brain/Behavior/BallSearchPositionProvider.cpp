@@ -1,7 +1,6 @@
 #include <Eigen/Dense>
 
 #include "Tools/Chronometer.hpp"
-#include "Tools/Math/HungarianMethod.hpp"
 #include "Tools/Math/Hysteresis.hpp"
 #include "Tools/Math/Range.hpp"
 
@@ -370,9 +369,14 @@ void BallSearchPositionProvider::assignSearchAreas()
       return;
     }
 
+    if (explorers_.size() > static_cast<std::size_t>(HungarianMethod::maxRows))
+    {
+      Log(LogLevel::ERROR) << "BallSearchPositionProvider: Too many explorers for the assignment";
+      return;
+    }
+
     // the consts for every explorer to get to the search area's cellToExplore
-    Eigen::MatrixXi costs = Eigen::MatrixXi::Constant(explorers_.size(), explorers_.size(),
-                                                      std::numeric_limits<int>::max());
+    costs_.setConstant(explorers_.size(), explorers_.size(), std::numeric_limits<int>::max());
 
     // calculate the costs for each explorer.
     for (unsigned int i = 0; i < searchAreas_.size(); i++)
@@ -380,13 +384,14 @@ void BallSearchPositionProvider::assignSearchAreas()
       for (unsigned int playerIndex = 0; playerIndex < explorers_.size(); playerIndex++)
       {
         const ProbCell* cellToExplore = searchAreas_[i].cellToExplore;
-        costs(i, playerIndex) =
+        costs_(i, playerIndex) =
             static_cast<int>(timeToReachCell(*(explorers_[playerIndex]), *cellToExplore) * 1000.f);
       }
     }
-    HungarianMethod minimizer;
-    // minimize the overall costs to go to the cellToExplore for all explorers
-    Eigen::Array2Xi minimumMatching = minimizer.findMaximumMatching(costs, true);
+    // minimize the overall costs to go to the cellToExplore for all explorers (starting from the
+    // previous assignment if the number of explorers did not change)
+    const HungarianMethod::Matching& minimumMatching =
+        minimizer_.findMaximumMatching(costs_, true);
     // apply the minimizer's results.
     for (int col = 0; col < minimumMatching.cols(); col++)
     {
@@ -19,6 +19,8 @@
 #include "Data/TeamBallModel.hpp"
 #include "Data/TeamPlayers.hpp"
 
+#include "Tools/Math/HungarianMethod.hpp"
+
 class Brain;
 
 class BallSearchPositionProvider : public Module<BallSearchPositionProvider, Brain>
@@ -154,6 +156,10 @@ private:
 
   /// List of all search areas managed by this module.
   std::vector<SearchArea> searchAreas_;
+  /// the costs for every explorer to reach the cellToExplore of every search area
+  HungarianMethod::CostMatrix costs_;
+  /// assigns the explorers to the search areas (keeps the previous assignment as warm start)
+  HungarianMethod minimizer_;
 
   /// Field length in m
   const float fieldLength_;
@@ -0,0 +1,550 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Behavior/ActionCommand.hpp"
+#include "Behavior/DataSet.hpp"
+#include "Data/EyeLEDRequest.hpp"
+#include "Data/MotionRequest.hpp"
+#include "Framework/ModuleManagerInterface.hpp"
+#include "Hardware/BehaviorBenchmark/BehaviorBenchmarkInterface.hpp"
+#include "Modules/Configuration/Configuration.h"
+#include "Modules/Debug/Debug.h"
+#include "Modules/NaoProvider.h"
+#include "Tools/Math/Random.hpp"
+#include "Tools/Storage/UniValue/UniValue2Json.hpp"
+
+/*
+ * This is an offline benchmark for the behavior. It evaluates rootBehavior and
+ * ActionCommand::toMotionRequest for synthetic or recorded world states without a Brain and reports
+ * the latency and the number of heap allocations per playing role.
+ *
+ * Usage: behaviorBenchmark [-i <iterations>] [-s <samples per role>] [-r <world states.json>]
+ *
+ * A file with recorded world states contains an array of objects. Each object maps the names of
+ * data types (e.g. "RobotPosition", as they are sent by the debug protocol) to their values. Data
+ * types that are missing in a world state keep their default values.
+ */
+
+/*
+ * The behavior units are defined in the translation unit of the BehaviorModule because Units.hpp
+ * may only be included once. The benchmark is linked against the Brain objects and only needs the
+ * declaration of the root behavior.
+ */
+ActionCommand rootBehavior(const DataSet& d);
+
+namespace
+{
+  /*
+   * The counters only see allocations through the global operator new. Eigen's aligned allocations
+   * (Eigen::aligned_allocator, dynamic matrices, EIGEN_MAKE_ALIGNED_OPERATOR_NEW) call malloc
+   * directly and are not counted.
+   */
+  /// the number of heap allocations of the calling thread
+  thread_local std::size_t allocationCount = 0;
+  /// the number of bytes that have been allocated on the heap by the calling thread
+  thread_local std::size_t allocatedBytes = 0;
+}
+
+void* operator new(std::size_t size)
+{
+  allocationCount++;
+  allocatedBytes += size;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  std::free(pointer);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  allocationCount++;
+  allocatedBytes += size;
+  // aligned_alloc needs a size that is a multiple of the alignment
+  const auto align = static_cast<std::size_t>(alignment);
+  const std::size_t alignedSize = std::max<std::size_t>((size + align - 1) / align, 1) * align;
+  if (void* pointer = std::aligned_alloc(align, alignedSize))
+  {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+  std::free(pointer);
+}
+
+/**
+ * @brief BenchmarkManager is a module manager that only exists to construct modules
+ *
+ * It has the name of the Brain so that the configuration of the behavior is loaded from the same
+ * mount points.
+ */
+class BenchmarkManager : public ModuleManagerInterface
+{
+public:
+  /**
+   * @brief BenchmarkManager initializes the module manager
+   * @param debug the Debug instance
+   * @param configuration the Configuration instance
+   * @param robotInterface the RobotInterface instance
+   */
+  BenchmarkManager(Debug& debug, Configuration& configuration, RobotInterface& robotInterface)
+    : ModuleManagerInterface("Brain", ConfigurationType::HEAD, {}, {}, debug, configuration,
+                             robotInterface)
+  {
+  }
+  /**
+   * @brief cycle does nothing since the benchmark calls the behavior directly
+   */
+  void cycle() override {}
+};
+
+/**
+ * @brief BenchmarkModule provides the parameters of the BehaviorModule to the data sets
+ */
+class BenchmarkModule : public ModuleBase
+{
+public:
+  /**
+   * @brief BenchmarkModule mounts the configuration of the BehaviorModule
+   * @param manager the benchmark module manager
+   */
+  BenchmarkModule(const ModuleManagerInterface& manager)
+    : ModuleBase(manager, "BehaviorModule")
+  {
+  }
+  /**
+   * @brief runCycle does nothing since the benchmark calls the behavior directly
+   */
+  void runCycle() override {}
+};
+
+/**
+ * @brief BenchmarkWorld holds one world state and the data set that references it
+ */
+struct BenchmarkWorld
+{
+  /**
+   * @brief BenchmarkWorld resets all data types and creates the data set
+   * @param module the module that provides the behavior parameters
+   * @param fieldDimensions the field dimensions that are shared by all worlds
+   */
+  BenchmarkWorld(const ModuleBase& module, const FieldDimensions& fieldDimensions)
+    : actionCommand(ActionCommand::dead())
+    , dataSet(module, gameControllerState, ballState, robotPosition, bodyPose, playerConfiguration,
+              playingRoles, motionState, headMotionOutput, sitDownOutput, teamBallModel,
+              teamPlayers, fieldDimensions, strikerAction, penaltyStrikerAction,
+              setPlayStrikerAction, keeperAction, penaltyKeeperAction, pointOfInterests, cycleInfo,
+              setPosition, defenderAction, defendingPosition, bishopPosition, supportingPosition,
+              replacementKeeperAction, buttonData, worldState, kickConfigurationData,
+              ballSearchPosition, headPositionData, actionCommand)
+  {
+    for (auto data : getDataTypes())
+    {
+      data->reset();
+    }
+  }
+  /**
+   * @brief getDataTypes returns all data types of this world that can be loaded from a recording
+   * @return pointers to the data types
+   */
+  std::vector<DataTypeBase*> getDataTypes()
+  {
+    return {&gameControllerState, &ballState,           &robotPosition,
+            &bodyPose,            &playerConfiguration, &playingRoles,
+            &motionState,         &headMotionOutput,    &sitDownOutput,
+            &teamBallModel,       &teamPlayers,         &strikerAction,
+            &penaltyStrikerAction, &setPlayStrikerAction, &keeperAction,
+            &penaltyKeeperAction, &pointOfInterests,    &cycleInfo,
+            &setPosition,         &defenderAction,      &defendingPosition,
+            &bishopPosition,      &supportingPosition,  &replacementKeeperAction,
+            &buttonData,          &worldState,          &kickConfigurationData,
+            &ballSearchPosition,  &headPositionData};
+  }
+
+  GameControllerState gameControllerState;
+  BallState ballState;
+  RobotPosition robotPosition;
+  BodyPose bodyPose;
+  PlayerConfiguration playerConfiguration;
+  PlayingRoles playingRoles;
+  MotionState motionState;
+  HeadMotionOutput headMotionOutput;
+  SitDownOutput sitDownOutput;
+  TeamBallModel teamBallModel;
+  TeamPlayers teamPlayers;
+  StrikerAction strikerAction;
+  PenaltyStrikerAction penaltyStrikerAction;
+  SetPlayStrikerAction setPlayStrikerAction;
+  KeeperAction keeperAction;
+  PenaltyKeeperAction penaltyKeeperAction;
+  PointOfInterests pointOfInterests;
+  CycleInfo cycleInfo;
+  SetPosition setPosition;
+  DefenderAction defenderAction;
+  DefendingPosition defendingPosition;
+  BishopPosition bishopPosition;
+  SupportingPosition supportingPosition;
+  ReplacementKeeperAction replacementKeeperAction;
+  ButtonData buttonData;
+  WorldState worldState;
+  KickConfigurationData kickConfigurationData;
+  BallSearchPosition ballSearchPosition;
+  HeadPositionData headPositionData;
+  /// the last action command of this world (referenced by the data set)
+  ActionCommand actionCommand;
+  /// the data set that is passed to the behavior
+  DataSet dataSet;
+};
+
+/**
+ * @brief RoleStatistics accumulates the measurements of one playing role
+ */
+struct RoleStatistics
+{
+  /// the number of evaluations
+  std::size_t evaluations = 0;
+  /// the accumulated duration of rootBehavior in nanoseconds
+  double behaviorTime = 0.0;
+  /// the longest duration of rootBehavior in nanoseconds
+  double maxBehaviorTime = 0.0;
+  /// the accumulated duration of toMotionRequest in nanoseconds
+  double motionRequestTime = 0.0;
+  /// the number of heap allocations in rootBehavior
+  std::size_t behaviorAllocations = 0;
+  /// the number of allocated bytes in rootBehavior
+  std::size_t behaviorBytes = 0;
+  /// the number of heap allocations in toMotionRequest
+  std::size_t motionRequestAllocations = 0;
+};
+
+/**
+ * @brief getRoleName returns a human readable name of a playing role
+ * @param role the playing role
+ * @return the name of the role
+ */
+std::string getRoleName(const PlayingRole role)
+{
+  switch (role)
+  {
+    case PlayingRole::NONE:
+      return "NONE";
+    case PlayingRole::KEEPER:
+      return "KEEPER";
+    case PlayingRole::DEFENDER_LEFT:
+      return "DEFENDER_LEFT";
+    case PlayingRole::DEFENDER_RIGHT:
+      return "DEFENDER_RIGHT";
+    case PlayingRole::SUPPORT_STRIKER:
+      return "SUPPORT_STRIKER";
+    case PlayingRole::STRIKER:
+      return "STRIKER";
+    case PlayingRole::BISHOP:
+      return "BISHOP";
+    case PlayingRole::REPLACEMENT_KEEPER:
+      return "REPLACEMENT_KEEPER";
+  }
+  return "UNKNOWN";
+}
+
+/**
+ * @brief randomizeWorld fills a world with a synthetic state of a playing game
+ * @param world the world that is filled
+ * @param role the playing role of the robot
+ * @param fieldDimensions the field dimensions
+ * @param random the random stream that is used
+ */
+void randomizeWorld(BenchmarkWorld& world, const PlayingRole role,
+                    const FieldDimensions& fieldDimensions, Random::Stream& random)
+{
+  const float halfLength = fieldDimensions.fieldLength * 0.5f;
+  const float halfWidth = fieldDimensions.fieldWidth * 0.5f;
+
+  world.gameControllerState.valid = true;
+  world.gameControllerState.gameState = GameState::PLAYING;
+  world.gameControllerState.penalty = Penalty::NONE;
+
+  world.playingRoles.role = role;
+
+  world.bodyPose.fallen = false;
+  world.bodyPose.footContact = true;
+
+  world.robotPosition.valid = true;
+  world.robotPosition.pose =
+      Pose(random.uniformFloat(-halfLength, halfLength), random.uniformFloat(-halfWidth, halfWidth),
+           random.uniformFloat(-static_cast<float>(M_PI), static_cast<float>(M_PI)));
+
+  const Vector2f absoluteBallPosition(random.uniformFloat(-halfLength, halfLength),
+                                      random.uniformFloat(-halfWidth, halfWidth));
+  const bool ballFound = random.uniformFloat() < 0.8f;
+  world.ballState.found = ballFound;
+  world.ballState.confident = ballFound;
+  world.ballState.age = ballFound ? random.uniformFloat(0.f, 1.f) : 1337.f;
+  world.ballState.position = world.robotPosition.pose.inverse() * absoluteBallPosition;
+  world.ballState.destination = world.ballState.position;
+
+  world.teamBallModel.found = ballFound || random.uniformFloat() < 0.5f;
+  world.teamBallModel.seen = world.teamBallModel.found;
+  world.teamBallModel.ballType = ballFound ? TeamBallModel::BallType::SELF
+                                           : world.teamBallModel.found
+                                                 ? TeamBallModel::BallType::TEAM
+                                                 : TeamBallModel::BallType::NONE;
+  world.teamBallModel.insideField = true;
+  world.teamBallModel.position = absoluteBallPosition;
+
+  world.worldState.robotValid = true;
+  world.worldState.ballValid = world.teamBallModel.found;
+  world.worldState.robotInOwnHalf = world.robotPosition.pose.position.x() < 0.f;
+  world.worldState.robotInLeftHalf = world.robotPosition.pose.position.y() > 0.f;
+  world.worldState.ballInOwnHalf = absoluteBallPosition.x() < 0.f;
+  world.worldState.ballInLeftHalf = absoluteBallPosition.y() > 0.f;
+  world.worldState.ballIsFree = true;
+  world.worldState.ballIsToMyLeft = world.ballState.position.y() > 0.f;
+
+  world.cycleInfo.startTime = TimePoint::getCurrentTime();
+  world.cycleInfo.cycleTime = 0.01f;
+}
+
+/**
+ * @brief loadWorlds loads recorded world states from a file
+ * @param path the path to the JSON file
+ * @param module the module that provides the behavior parameters
+ * @param fieldDimensions the field dimensions
+ * @param worlds the loaded worlds are appended to this
+ * @return true iff the file could be loaded
+ */
+bool loadWorlds(const std::string& path, const ModuleBase& module,
+                const FieldDimensions& fieldDimensions,
+                std::vector<std::unique_ptr<BenchmarkWorld>>& worlds)
+{
+  std::ifstream stream(path);
+  Json::Reader reader;
+  Json::Value root;
+  if (!stream.is_open() || !reader.parse(stream, root))
+  {
+    Log(LogLevel::ERROR) << "Could not read recorded world states from " << path;
+    return false;
+  }
+  const Uni::Value recording = Uni::Converter::toUniValue(root);
+  if (recording.type() != Uni::ValueType::ARRAY)
+  {
+    Log(LogLevel::ERROR) << "The root of " << path << " is not an array of world states";
+    return false;
+  }
+  for (auto it = recording.vectorBegin(); it != recording.vectorEnd(); it++)
+  {
+    worlds.emplace_back(std::make_unique<BenchmarkWorld>(module, fieldDimensions));
+    for (auto data : worlds.back()->getDataTypes())
+    {
+      if (it->contains(data->getName()))
+      {
+        (*it)[data->getName()] >> *data;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief BehaviorBenchmark sets up the configuration and runs the measurements
+ */
+class BehaviorBenchmark
+{
+public:
+  /**
+   * @brief run parses the command line, evaluates the behavior and prints the statistics
+   * @param argc the number of command line arguments
+   * @param argv the command line arguments
+   * @return the exit code of the program
+   */
+  static int run(int argc, char* argv[]);
+};
+
+int BehaviorBenchmark::run(int argc, char* argv[])
+{
+  std::size_t iterations = 1000;
+  std::size_t samplesPerRole = 1000;
+  std::string recordingPath;
+  const auto printUsage = [] {
+    Log(LogLevel::ERROR) << "Usage: behaviorBenchmark [-i <iterations>] [-s <samples per role>] "
+                            "[-r <world states.json>]";
+  };
+  for (int i = 1; i < argc; i += 2)
+  {
+    const std::string option = argv[i];
+    if (i + 1 == argc)
+    {
+      Log(LogLevel::ERROR) << "Option " << option << " has no value";
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    try
+    {
+      if (option == "-i")
+      {
+        iterations = std::stoul(argv[i + 1]);
+      }
+      else if (option == "-s")
+      {
+        samplesPerRole = std::stoul(argv[i + 1]);
+      }
+      else if (option == "-r")
+      {
+        recordingPath = argv[i + 1];
+      }
+      else
+      {
+        printUsage();
+        return EXIT_FAILURE;
+      }
+    }
+    catch (const std::invalid_argument&)
+    {
+      Log(LogLevel::ERROR) << "Option " << option << " needs a number but got " << argv[i + 1];
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    catch (const std::out_of_range&)
+    {
+      Log(LogLevel::ERROR) << "The value of option " << option << " is out of range";
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  BehaviorBenchmarkInterface robotInterface;
+  const auto standaloneConfiguration =
+      Configuration::createStandalone(robotInterface.getFileRoot());
+  Configuration& configuration = *standaloneConfiguration;
+  configuration.mount("tuhhSDK.base", "sdk.json", ConfigurationType::HEAD);
+  configuration.setLocationName(configuration.get("tuhhSDK.base", "location").asString());
+  NaoInfo info;
+  robotInterface.getNaoInfo(configuration, info);
+  configuration.setNaoHeadName(info.headName);
+  configuration.setNaoBodyName(info.bodyName);
+  NaoProvider::init(configuration, info);
+
+  Debug debug;
+  BenchmarkManager manager(debug, configuration, robotInterface);
+  BenchmarkModule module(manager);
+
+  FieldDimensions fieldDimensions;
+  fieldDimensions.init(configuration);
+  PlayerConfiguration playerConfiguration;
+  playerConfiguration.init(configuration);
+
+  // the same seed in every run makes the synthetic world states comparable between runs
+  Random::Stream random(0, Random::getStreamId("BehaviorBenchmark"));
+  std::vector<std::unique_ptr<BenchmarkWorld>> worlds;
+  if (!recordingPath.empty())
+  {
+    if (!loadWorlds(recordingPath, module, fieldDimensions, worlds))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  else
+  {
+    for (int role = static_cast<int>(PlayingRole::KEEPER);
+         role <= static_cast<int>(PlayingRole::REPLACEMENT_KEEPER); role++)
+    {
+      for (std::size_t i = 0; i < samplesPerRole; i++)
+      {
+        worlds.emplace_back(std::make_unique<BenchmarkWorld>(module, fieldDimensions));
+        worlds.back()->playerConfiguration = playerConfiguration;
+        randomizeWorld(*worlds.back(), static_cast<PlayingRole>(role), fieldDimensions, random);
+      }
+    }
+  }
+
+  // Only the behavior itself is measured. Each evaluation uses its own motion request so that
+  // its memory is allocated once outside of the measurement.
+  std::map<PlayingRole, RoleStatistics> statistics;
+  MotionRequest motionRequest;
+  EyeLEDRequest eyeLEDRequest;
+  for (std::size_t iteration = 0; iteration < iterations; iteration++)
+  {
+    for (auto& world : worlds)
+    {
+      RoleStatistics& roleStatistics = statistics[world->playingRoles.role];
+
+      const std::size_t allocationsBefore = allocationCount;
+      const std::size_t bytesBefore = allocatedBytes;
+      const auto behaviorStart = std::chrono::steady_clock::now();
+      ActionCommand actionCommand = rootBehavior(world->dataSet);
+      const auto behaviorEnd = std::chrono::steady_clock::now();
+      const std::size_t allocationsAfterBehavior = allocationCount;
+      const std::size_t bytesAfterBehavior = allocatedBytes;
+      actionCommand.toMotionRequest(motionRequest);
+      const auto motionRequestEnd = std::chrono::steady_clock::now();
+      actionCommand.toEyeLEDRequest(eyeLEDRequest);
+
+      const double behaviorTime =
+          std::chrono::duration<double, std::nano>(behaviorEnd - behaviorStart).count();
+      roleStatistics.evaluations++;
+      roleStatistics.behaviorTime += behaviorTime;
+      roleStatistics.maxBehaviorTime = std::max(roleStatistics.maxBehaviorTime, behaviorTime);
+      roleStatistics.motionRequestTime +=
+          std::chrono::duration<double, std::nano>(motionRequestEnd - behaviorEnd).count();
+      roleStatistics.behaviorAllocations += allocationsAfterBehavior - allocationsBefore;
+      roleStatistics.behaviorBytes += bytesAfterBehavior - bytesBefore;
+      roleStatistics.motionRequestAllocations += allocationCount - allocationsAfterBehavior;
+
+      // the behavior of the next evaluation of this world sees this action command as the last one
+      world->actionCommand = actionCommand;
+    }
+  }
+
+  std::cout << std::left << std::setw(20) << "role" << std::right << std::setw(12) << "evals"
+            << std::setw(14) << "behavior[ns]" << std::setw(14) << "max[ns]" << std::setw(14)
+            << "request[ns]" << std::setw(14) << "allocs" << std::setw(14) << "bytes"
+            << std::setw(16) << "request allocs" << "\n";
+  for (const auto& roleStatistics : statistics)
+  {
+    const RoleStatistics& s = roleStatistics.second;
+    const double evaluations = static_cast<double>(std::max<std::size_t>(s.evaluations, 1));
+    std::cout << std::left << std::setw(20) << getRoleName(roleStatistics.first) << std::right
+              << std::setw(12) << s.evaluations << std::fixed << std::setprecision(1)
+              << std::setw(14) << s.behaviorTime / evaluations << std::setw(14)
+              << s.maxBehaviorTime << std::setw(14) << s.motionRequestTime / evaluations
+              << std::setw(14) << s.behaviorAllocations / evaluations << std::setw(14)
+              << s.behaviorBytes / evaluations << std::setw(16)
+              << s.motionRequestAllocations / evaluations << "\n";
+  }
+  std::cout << "allocs and bytes count the global operator new only, the aligned allocations of "
+               "Eigen (e.g. Eigen::aligned_allocator) are not included.\n";
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+  return BehaviorBenchmark::run(argc, argv);
+}
@@ -15,6 +15,8 @@
 #include "Data/KeeperAction.hpp"
 #include "Data/KickConfigurationData.hpp"
 #include "Data/MotionState.hpp"
+#include "Data/PenaltyKeeperAction.hpp"
+#include "Data/PenaltyStrikerAction.hpp"
 #include "Data/PlayerConfiguration.hpp"
 #include "Data/PlayingRoles.hpp"
 #include "Data/PointOfInterests.hpp"
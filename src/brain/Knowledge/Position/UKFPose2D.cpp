@@ -96,228 +96,47 @@ void UKFPose2D::generateSigmaPoints()
 
 void UKFPose2D::poseSensorUpdate(const Vector3f& poseObservation, const Matrix3f& covObservation)
 {
-  // first generate the sigma points:
-  generateSigmaPoints();
-
-  // the sigmaPoints are propagated through the observation function h(sigmaPoint) into the space of
-  // observation this produces the predicted observation. Here h is the identity matrix, thus the
-  // predictedObservations match the sigmaPoints_
-  std::array<Vector3f, 7> predictedObservations = sigmaPoints_;
-
-  // compute mean of predicted observations:
-  Vector3f predictedObservationMean = Vector3f::Zero();
-  float mX = 0;
-  float mY = 0;
-  Vector2f mDirection = Vector2f::Zero();
-
-  for (auto& predictedObservation : predictedObservations)
-  {
-    mX += predictedObservation.x();
-    mY += predictedObservation.y();
-    mDirection += Vector2f(std::cos(predictedObservation.z()), std::sin(predictedObservation.z()));
-  }
-  mX *= 1.f / 7.f;
-  mY *= 1.f / 7.f;
-  mDirection *= 1.f / 7.f;
-  predictedObservationMean = Vector3f(mX, mY, atan2(mDirection.y(), mDirection.x()));
-  predictedObservationMean.z() = Angle::normalized(predictedObservationMean.z());
-
-  // Pzz - compute covariance of predicted observations - as computed above:
-  Matrix3f predictedObservationsCov = Matrix3f::Zero();
-  for (auto& predictedObservation : predictedObservations)
-  {
-    Vector3f diff = predictedObservation - predictedObservationMean;
-    diff.z() = Angle::normalizeAngleDiff(diff.z());
-    predictedObservationsCov +=
-        (Matrix3f() << diff * diff.x(), diff * diff.y(), diff * diff.z()).finished();
-  }
-  predictedObservationsCov *= 0.5f;
-
-  // Pxz - cross-covaraince matrix of sigma Points and observations
-  Matrix3f predictedObservationsCrossCov = Matrix3f::Zero();
-  for (int i = 0; i < 7; i++)
-  {
-    Vector3f diffX = sigmaPoints_[i] - stateMean_;
-    diffX.z() = Angle::normalizeAngleDiff(diffX.z());
-    Vector3f diffZ = predictedObservations[i] - predictedObservationMean;
-    diffZ.z() = Angle::normalizeAngleDiff(diffZ.z());
-    predictedObservationsCrossCov += diffX * diffZ.transpose();
-  }
-  predictedObservationsCrossCov *= 0.5f;
-
-  // compute the UKF Kalman gain
-  const Matrix3f kalmanGain =
-      predictedObservationsCrossCov * (predictedObservationsCov + covObservation).inverse();
-
-  // residuum
-  Vector3f residuum = poseObservation - predictedObservationMean;
-  residuum.z() = Angle::normalizeAngleDiff(residuum.z());
-
-  // a posteriori state estimate
-  stateMean_ += kalmanGain * residuum;
-  stateMean_.z() = Angle::normalized(stateMean_.z());
-
-  // a posterior state covariance
-  stateCov_ -= kalmanGain * predictedObservationsCrossCov.transpose();
-  fixCovariance(stateCov_);
+  // Here h is the identity, thus the predicted observations match the sigma points. The
+  // orientation is the third component of the observation.
+  sensorUpdate<3>(poseObservation, covObservation, 2,
+                  [](const Vector3f& sigmaPoint) { return sigmaPoint; });
 }
 
 void UKFPose2D::pose1DSensorUpdate(const Vector2f& pose1DObservation, const bool updateXDirection,
                                    const Matrix2f& distAndAngleCov)
 {
-  // first generate the sigma points:
-  generateSigmaPoints();
-
-  // the sigmaPoints are propagated through the observation function h(sigmaPoint) into the space of
-  // observation this produces the predicted observation. Here h is a map, pruning the dimension
-  // along which the line runs
-  std::array<Vector2f, 7> predictedObservations;
+  // Here h is a map, pruning the dimension along which the line runs. The orientation is the
+  // second component of the observation.
   if (updateXDirection)
   {
     // The space of observation for a line along y constits of: (x-position, orientation)
-    for (int i = 0; i < 7; i++)
-    {
-      predictedObservations[i] = Vector2f(sigmaPoints_[i].x(), sigmaPoints_[i].z());
-    }
+    sensorUpdate<2>(pose1DObservation, distAndAngleCov, 1, [](const Vector3f& sigmaPoint) {
+      return Vector2f(sigmaPoint.x(), sigmaPoint.z());
+    });
   }
   else
   {
     // The space of observation for a line along x constits of: (y-position, orientation)
-    for (int i = 0; i < 7; i++)
-    {
-      predictedObservations[i] = Vector2f(sigmaPoints_[i].y(), sigmaPoints_[i].z());
-    }
-  }
-
-  // compute mean of predicted observations:
-  // TODO: this should be obsolete due to the fact that h is the (pruning) identity (maybe log the
-  // diff to pruned stateMean_)
-  Vector2f predictedObservationMean = Vector2f::Zero();
-  float mCoordinate = 0;
-  Vector2f mDirection = Vector2f::Zero();
-
-  for (auto& predictedObservation : predictedObservations)
-  {
-    mCoordinate += predictedObservation.x();
-    mDirection += Vector2f(std::cos(predictedObservation.y()), std::sin(predictedObservation.y()));
-  }
-
-  mCoordinate *= 1.f / 7.f;
-  mDirection *= 1.f / 7.f;
-  predictedObservationMean = Vector2f(mCoordinate, atan2(mDirection.y(), mDirection.x()));
-  predictedObservationMean.y() = Angle::normalized(predictedObservationMean.y());
-
-  // Pzz - compute covariance of predicted observations - as computed above:
-  Matrix2f predictedObservationsCov = Matrix2f::Zero();
-  for (auto& predictedObservation : predictedObservations)
-  {
-    Vector2f diff = predictedObservation - predictedObservationMean;
-    diff.y() = Angle::normalizeAngleDiff(diff.y());
-    predictedObservationsCov += (Matrix2f() << diff * diff.x(), diff * diff.y()).finished();
-  }
-  predictedObservationsCov *= 0.5f;
-
-  // Pxz - cross-covaraince matrix of sigma Points and observations
-  Eigen::Matrix<float, 3, 2> predictedObservationsCrossCov = Eigen::Matrix<float, 3, 2>::Zero();
-  for (int i = 0; i < 7; i++)
-  {
-    Vector3f diffX = sigmaPoints_[i] - stateMean_;
-    diffX.z() = Angle::normalizeAngleDiff(diffX.z());
-    Vector2f diffZ = predictedObservations[i] - predictedObservationMean;
-    diffZ.y() = Angle::normalizeAngleDiff(diffZ.y());
-    predictedObservationsCrossCov += diffX * diffZ.transpose();
+    sensorUpdate<2>(pose1DObservation, distAndAngleCov, 1, [](const Vector3f& sigmaPoint) {
+      return Vector2f(sigmaPoint.y(), sigmaPoint.z());
+    });
   }
-  predictedObservationsCrossCov *= 0.5f;
-
-  // compute the UKF Kalman gain
-  const Eigen::Matrix<float, 3, 2> kalmanGain =
-      predictedObservationsCrossCov * (predictedObservationsCov + distAndAngleCov).inverse();
-
-  // residuum
-  Vector2f residuum = pose1DObservation - predictedObservationMean;
-  residuum.y() = Angle::normalizeAngleDiff(residuum.y());
-
-  // a posteriori state estimate
-  stateMean_ += kalmanGain * residuum;
-  stateMean_.z() = Angle::normalized(stateMean_.z());
-
-  // a posterior state covariance
-  // xk = x_k + K * Pzz * K^T
-  // xk = x_k + Pxz*Pzz^(-1)*Pzz^(-1)^T*Pxz^T | Pzz^(-1)^T = Pzz^(-1)
-  // xk = x_k + Pxz*Pzz^(-1) * Pxz^T          | Pxz*Pzz^(-1) = K
-  // xk = x_k + K*Pxz^T
-  stateCov_ -= kalmanGain * predictedObservationsCrossCov.transpose();
-  fixCovariance(stateCov_);
 }
 
 void UKFPose2D::fieldPointUpdate(const Vector2f& relativeFieldPoint,
                                  const Vector2f& absoluteFieldPointPosition,
                                  const Matrix2f& covObservation)
 {
-  // first generate the sigma points:
-  generateSigmaPoints();
-
-  // the sigmaPoints are propagated through the observation function h(sigmaPoint) into the space of
-  // observation this produces the predicted observation. Here h maps to the the
-  // absoluteFieldPointPosition to the corresponding relative position
-  std::array<Vector2f, 7> predictedObservations;
-  for (int i = 0; i < 7; i++)
-  {
-    // Where would the field mark be in relative coordinates of this sigma point:
-    const Rotation2Df sigmaPointRotation(sigmaPoints_[i].z());
-    const Vector2f absoluteSigmaPointPosition(sigmaPoints_[i].x(), sigmaPoints_[i].y());
-    predictedObservations[i] =
-        sigmaPointRotation.inverse() * (absoluteFieldPointPosition - absoluteSigmaPointPosition);
-  }
-
-  // compute mean of predicted observations:
-  Vector2f predictedObservationMean = Vector2f::Zero();
-  float mX = 0;
-  float mY = 0;
-
-  for (auto& predictedObservation : predictedObservations)
-  {
-    mX += predictedObservation.x();
-    mY += predictedObservation.y();
-  }
-  mX *= 1.f / 7.f;
-  mY *= 1.f / 7.f;
-  predictedObservationMean = Vector2f(mX, mY);
-
-  // Pzz - compute covariance of predicted observations - as computed above:
-  Matrix2f predictedObservationsCov = Matrix2f::Zero();
-  for (auto& predictedObservation : predictedObservations)
-  {
-    Vector2f diff = predictedObservation - predictedObservationMean;
-    predictedObservationsCov += (Matrix2f() << diff * diff.x(), diff * diff.y()).finished();
-  }
-  predictedObservationsCov *= 0.5f;
-
-  // Pxz - cross-covaraince matrix of sigma Points and observations
-  Eigen::Matrix<float, 3, 2> predictedObservationsCrossCov = Eigen::Matrix<float, 3, 2>::Zero();
-  for (int i = 0; i < 7; i++)
-  {
-    Vector3f diffX = sigmaPoints_[i] - stateMean_;
-    diffX.z() = Angle::normalizeAngleDiff(diffX.z());
-    Vector2f diffZ = predictedObservations[i] - predictedObservationMean;
-    predictedObservationsCrossCov += diffX * diffZ.transpose();
-  }
-  predictedObservationsCrossCov *= 0.5f;
-
-  // compute the UKF Kalman gain
-  const Eigen::Matrix<float, 3, 2> kalmanGain =
-      predictedObservationsCrossCov * (predictedObservationsCov + covObservation).inverse();
-
-  // residuum
-  Vector2f residuum = relativeFieldPoint - predictedObservationMean;
-
-  // a posteriori state estimate
-  stateMean_ += kalmanGain * residuum;
-  stateMean_.z() = Angle::normalized(stateMean_.z());
-
-  // a posterior state covariance
-  stateCov_ -= kalmanGain * predictedObservationsCrossCov.transpose();
-  fixCovariance(stateCov_);
+  // Here h maps the absoluteFieldPointPosition to the corresponding relative position. The
+  // observation does not contain an orientation.
+  sensorUpdate<2>(relativeFieldPoint, covObservation, -1,
+                  [&absoluteFieldPointPosition](const Vector3f& sigmaPoint) {
+                    // Where would the field mark be in relative coordinates of this sigma point:
+                    const Rotation2Df sigmaPointRotation(sigmaPoint.z());
+                    const Vector2f absoluteSigmaPointPosition(sigmaPoint.x(), sigmaPoint.y());
+                    return Vector2f(sigmaPointRotation.inverse() *
+                                    (absoluteFieldPointPosition - absoluteSigmaPointPosition));
+                  });
 }
 
 float UKFPose2D::hesseNormalDist(const Line<float>& line, const Vector2f& point) const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Data/OdometryOffset.hpp"
+#include "Tools/Math/Angle.hpp"
 #include "Tools/Math/Eigen.hpp"
 #include "Tools/Math/Line.hpp"
 #include "Tools/Math/Pose.hpp"
@@ -102,6 +103,101 @@ protected:
   /// the sigma points - a minimal set of representive samples
   std::array<Vector3f, 7> sigmaPoints_;
 
+  /**
+   * @brief sensorUpdate performs an UC update of the UKF with an observation whose observation
+   * function is given as template parameter, so that it is inlined for every sigma point
+   *
+   * Several observations of a cycle are applied one after another and not stacked into one joint
+   * update, because the lines are associated against the mean that the previous update produced.
+   * @tparam nZ the dimension of the observation
+   * @tparam ObservationFunction a callable Eigen::Matrix<float, nZ, 1>(const Vector3f& sigmaPoint)
+   * @param observation the observation
+   * @param covObservation the covariance of the observation
+   * @param angleIndex the index of the component of the observation that is an angle (it is
+   * averaged and subtracted as a circular quantity), -1 if there is none
+   * @param observationFunction the mapping h from the state space to the space of observation
+   */
+  template <int nZ, typename ObservationFunction>
+  void sensorUpdate(const Eigen::Matrix<float, nZ, 1>& observation,
+                    const Eigen::Matrix<float, nZ, nZ>& covObservation, const int angleIndex,
+                    ObservationFunction&& observationFunction)
+  {
+    using VectorZ = Eigen::Matrix<float, nZ, 1>;
+    // first generate the sigma points:
+    generateSigmaPoints();
+
+    // the sigmaPoints are propagated through the observation function h(sigmaPoint) into the space
+    // of observation this produces the predicted observation
+    std::array<VectorZ, 7> predictedObservations;
+    for (int i = 0; i < 7; i++)
+    {
+      predictedObservations[i] = observationFunction(sigmaPoints_[i]);
+    }
+
+    // compute mean of predicted observations:
+    VectorZ predictedObservationMean = VectorZ::Zero();
+    Vector2f mDirection = Vector2f::Zero();
+    for (auto& predictedObservation : predictedObservations)
+    {
+      predictedObservationMean += predictedObservation;
+      if (angleIndex >= 0)
+      {
+        // special treatment for the angle as a circular quantity
+        mDirection += Vector2f(std::cos(predictedObservation(angleIndex)),
+                               std::sin(predictedObservation(angleIndex)));
+      }
+    }
+    predictedObservationMean *= 1.f / 7.f;
+    if (angleIndex >= 0)
+    {
+      mDirection *= 1.f / 7.f;
+      predictedObservationMean(angleIndex) =
+          Angle::normalized(std::atan2(mDirection.y(), mDirection.x()));
+    }
+
+    // Pzz - compute covariance of predicted observations
+    // Pxz - cross-covaraince matrix of sigma Points and observations
+    Eigen::Matrix<float, nZ, nZ> predictedObservationsCov = Eigen::Matrix<float, nZ, nZ>::Zero();
+    Eigen::Matrix<float, 3, nZ> predictedObservationsCrossCov =
+        Eigen::Matrix<float, 3, nZ>::Zero();
+    for (int i = 0; i < 7; i++)
+    {
+      Vector3f diffX = sigmaPoints_[i] - stateMean_;
+      diffX.z() = Angle::normalizeAngleDiff(diffX.z());
+      VectorZ diffZ = predictedObservations[i] - predictedObservationMean;
+      if (angleIndex >= 0)
+      {
+        diffZ(angleIndex) = Angle::normalizeAngleDiff(diffZ(angleIndex));
+      }
+      predictedObservationsCov += diffZ * diffZ.transpose();
+      predictedObservationsCrossCov += diffX * diffZ.transpose();
+    }
+    predictedObservationsCov *= 0.5f;
+    predictedObservationsCrossCov *= 0.5f;
+
+    // compute the UKF Kalman gain
+    const Eigen::Matrix<float, 3, nZ> kalmanGain =
+        predictedObservationsCrossCov * (predictedObservationsCov + covObservation).inverse();
+
+    // residuum
+    VectorZ residuum = observation - predictedObservationMean;
+    if (angleIndex >= 0)
+    {
+      residuum(angleIndex) = Angle::normalizeAngleDiff(residuum(angleIndex));
+    }
+
+    // a posteriori state estimate
+    stateMean_ += kalmanGain * residuum;
+    stateMean_.z() = Angle::normalized(stateMean_.z());
+
+    // a posterior state covariance
+    // xk = x_k + K * Pzz * K^T
+    // xk = x_k + Pxz*Pzz^(-1)*Pzz^(-1)^T*Pxz^T | Pzz^(-1)^T = Pzz^(-1)
+    // xk = x_k + Pxz*Pzz^(-1) * Pxz^T          | Pxz*Pzz^(-1) = K
+    // xk = x_k + K*Pxz^T
+    stateCov_ -= kalmanGain * predictedObservationsCrossCov.transpose();
+    fixCovariance(stateCov_);
+  }
   /**
    * @brief hesseNormalDist calculates the signed distance of a point to a line (result > 0 <=>
    * point left of Vector(line.p2 - line.p1))
@@ -1,3 +1,4 @@
+#include <cassert>
 #include <numeric>
 
 #include "Tools/Chronometer.hpp"
@@ -20,9 +21,17 @@ WhistleDetection::WhistleDetection(const ModuleManagerInterface& manager)
   , minWhistleCount_(*this, "minWhistleCount", [] {})
   , channel_(*this, "channel", [] {})
   , fft_(fftBufferSize_)
+  , window_(fftBufferSize_)
+  , fftBufferFill_(0)
+  , absFreqData_(fftBufferSize_, 0.f)
   , lastTimeWhistleHeard_()
   , foundWhistlesBuffer_(foundWhistlesBufferSize_, false)
 {
+  for (unsigned int i = 0; i < fftBufferSize_; i++)
+  {
+    window_[i] =
+        std::pow(std::sin(static_cast<float>(M_PI) * static_cast<float>(i) / fftBufferSize_), 2.0f);
+  }
 }
 
 void WhistleDetection::cycle()
@@ -39,8 +48,8 @@ void WhistleDetection::cycle()
 
   for (auto& sample : recordData_->samples[channel_()])
   {
-    fftBuffer_.push_back(sample);
-    if (fftBuffer_.size() == fftBufferSize_)
+    fft_.realBuffer()[fftBufferFill_++] = sample;
+    if (fftBufferFill_ == fftBufferSize_)
     {
       // check current fft buffer for whistle
       foundWhistlesBuffer_.push_back(fftBufferContainsWhistle());
@@ -53,7 +62,7 @@ void WhistleDetection::cycle()
       {
         lastTimeWhistleHeard_ = cycleInfo_->startTime;
       }
-      fftBuffer_.clear();
+      fftBufferFill_ = 0;
       break;
     }
   }
@@ -64,13 +73,14 @@ void WhistleDetection::cycle()
 bool WhistleDetection::fftBufferContainsWhistle()
 {
   // apply Hann window to reduce spectral leakage
+  float* fftBuffer = fft_.realBuffer();
   for (unsigned int i = 0; i < fftBufferSize_; i++)
   {
-    fftBuffer_[i] *=
-        std::pow(std::sin(static_cast<float>(M_PI) * static_cast<float>(i) / fftBufferSize_), 2.0f);
+    fftBuffer[i] *= window_[i];
   }
   // perform the fft
-  auto freqData = fft_.fft(fftBuffer_);
+  fft_.fft();
+  const std::complex<float>* freqData = fft_.complexBuffer();
 
   // the indices corresponding to the whistle band are computed by dividing by the frequency
   // resolution
@@ -85,14 +95,15 @@ bool WhistleDetection::fftBufferContainsWhistle()
   }
 
   // the absolute values of the comlpex spectrum, the mean and the standard deviation
-  std::vector<float> absFreqData(freqData.size());
-  for (unsigned int i = 0; i < freqData.size(); i++)
+  // The mean and standard deviation are computed over fftBufferSize_ bins of which the ones above
+  // the nyquist frequency are zero, which is what the scaling parameters are tuned for.
+  for (unsigned int i = 0; i < fft_.spectrumSize(); i++)
   {
-    absFreqData[i] = std::abs(freqData[i]);
+    absFreqData_[i] = std::abs(freqData[i]);
   }
-  debug().update(mount_ + ".absFreqData", absFreqData);
-  const float mean = Statistics::mean(absFreqData);
-  const float standardDeviation = Statistics::standardDeviation(absFreqData, mean);
+  debug().update(mount_ + ".absFreqData", absFreqData_);
+  const float mean = Statistics::mean(absFreqData_);
+  const float standardDeviation = Statistics::standardDeviation(absFreqData_, mean);
 
   // the spectrum is divided into several bands. for each band, the mean is compared to the
   // background threshold to find the whistle band
@@ -102,11 +113,7 @@ bool WhistleDetection::fftBufferContainsWhistle()
   // find the start of the the whistle band
   for (unsigned int i = 0; i < numberOfBands_(); i++)
   {
-    const std::vector<float>::const_iterator bandStart = absFreqData.begin() + minFreqIndex;
-    const std::vector<float>::const_iterator bandEnd =
-        absFreqData.begin() + minFreqIndex + bandSize;
-    const float bandMean = Statistics::mean(std::vector<float>(bandStart, bandEnd));
-    if (bandMean < backgroundThreshold)
+    if (bandMean(minFreqIndex, minFreqIndex + bandSize) < backgroundThreshold)
     {
       minFreqIndex += bandSize;
     }
@@ -119,11 +126,7 @@ bool WhistleDetection::fftBufferContainsWhistle()
   // find the end of the whistle band
   for (unsigned int i = 0; i < numberOfBands_(); i++)
   {
-    const std::vector<float>::const_iterator bandStart =
-        absFreqData.begin() + maxFreqIndex - bandSize;
-    const std::vector<float>::const_iterator bandEnd = absFreqData.begin() + maxFreqIndex;
-    const float bandMean = Statistics::mean(std::vector<float>(bandStart, bandEnd));
-    if (bandMean < backgroundThreshold)
+    if (bandMean(maxFreqIndex - bandSize, maxFreqIndex) < backgroundThreshold)
     {
       maxFreqIndex -= bandSize;
     }
@@ -142,9 +145,7 @@ bool WhistleDetection::fftBufferContainsWhistle()
   // threshold
   if (minFreqIndex < maxFreqIndex)
   {
-    const std::vector<float>::const_iterator bandStart = absFreqData.begin() + minFreqIndex;
-    const std::vector<float>::const_iterator bandEnd = absFreqData.begin() + maxFreqIndex;
-    const float whistleMean = Statistics::mean(std::vector<float>(bandStart, bandEnd));
+    const float whistleMean = bandMean(minFreqIndex, maxFreqIndex);
     const float whistleThreshold = mean + whistleScaling_() * standardDeviation;
     if (whistleMean > whistleThreshold)
     {
@@ -160,3 +161,11 @@ bool WhistleDetection::fftBufferContainsWhistle()
     return false;
   }
 }
+
+float WhistleDetection::bandMean(unsigned int begin, unsigned int end) const
+{
+  assert(begin < end && "empty band in bandMean");
+  const float sum =
+      std::accumulate(absFreqData_.begin() + begin, absFreqData_.begin() + end, 0.f);
+  return sum / (end - begin);
+}
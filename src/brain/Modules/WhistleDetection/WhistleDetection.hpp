@@ -64,11 +64,15 @@ private:
 
   /// The fft buffer size. For performance, this should be a power of two.
   static constexpr unsigned int fftBufferSize_ = 1024;
-  /// FFT wich can transform the buffer
+  /// FFT wich can transform the buffer. Its real buffer stores recorded samples until it reaches
+  /// the fft buffer size and a detection can be made.
   FFT fft_;
-  /// The buffer to store recorded samples until it reaches the fft buffer size and a detection can
-  /// be made.
-  RealVector fftBuffer_;
+  /// the Hann window that is applied to the samples before the fft
+  std::vector<float> window_;
+  /// the number of samples that are currently stored in the real buffer of the fft
+  unsigned int fftBufferFill_;
+  /// the absolute values of the spectrum (the bins above the nyquist frequency stay zero)
+  std::vector<float> absFreqData_;
   /// the last timestamp when the whistle has been detected
   TimePoint lastTimeWhistleHeard_;
 
@@ -79,4 +83,11 @@ private:
 
   /// The main function that checks whether the buffer contains a whistle sound
   bool fftBufferContainsWhistle();
+  /**
+   * @brief bandMean computes the mean of the absolute spectrum in a range of bins
+   * @param begin the first bin of the band
+   * @param end the bin after the last bin of the band
+   * @return the mean of the band
+   */
+  float bandMean(unsigned int begin, unsigned int end) const;
 };
@@ -82,7 +82,7 @@ void SPLMessageReceiver::cycle()
                   rawGameControllerState_->penalties[p.playerNumber - 1] != Penalty::NONE;
 
     // Parse the data array of the SPL standard message (DS msg and HULKs msg)
-    auto bytesRead = parseDSMsg(msg, remainingBytes, message.receiveTimePoint, p);
+    auto bytesRead = parseDSMsg(message, p);
     remainingBytes = remainingBytes - bytesRead;
     // Check if parsing DS message failed
     if (bytesRead == 0)
@@ -152,55 +152,37 @@ void SPLMessageReceiver::cycle()
   debug().update(mount_ + ".RawTeamPlayers", *rawTeamPlayers_);
 }
 
-unsigned int SPLMessageReceiver::parseDSMsg(const SPLStandardMessage& msg,
-                                            unsigned int remainingBytes,
-                                            const TimePoint& receiveTime, RawTeamPlayer& p)
+unsigned int SPLMessageReceiver::parseDSMsg(const SPLNetworkData::IncomingMessage& message,
+                                            RawTeamPlayer& p)
 {
-  DevilSmash::StandardMessage devilSmashMsg;
+  const SPLStandardMessage& msg = message.stdMsg;
+  const DevilSmash::StandardMessage& devilSmashMsg = message.dsMsg;
+  const TimePoint& receiveTime = message.receiveTimePoint;
 
-  // Return if there is no data left
-  if (remainingBytes == 0)
-  {
-    Log(LogLevel::INFO) << "Received a SPL msg without DevilSMASH msg in custom data field";
-    return 0;
-  }
-
-  // return if we cannot parse the header safely
-  if (remainingBytes < sizeof(devilSmashMsg.header))
-  {
-    Log(LogLevel::ERROR) << "RemainingBytes is smaller than size of DevilSMASH header. WTF";
-    assert(false);
-    return 0;
-  }
-  // This check is not completely safe. devilSmashMsg.sizeOfDSMessage returns the size of a message
-  // with no obstacles and no NTP messages. If a malformatted message is received, bhmsg.read
-  // could read more bytes than allowed.
-  const bool minimumSizeReached =
-      remainingBytes >= static_cast<unsigned int>(devilSmashMsg.sizeOfDSMessage());
-
-  if (!minimumSizeReached)
-  {
-    Log(LogLevel::ERROR) << "sizeOfDSMessage > remaining SPL message bytes!";
-    return 0;
-  }
-
-  if (!devilSmashMsg.read(msg.data))
+  switch (message.dsMsgStatus)
   {
-    // invalidate data that may have been written to p.
-    p.isHULK = false;
-    p.currentlyPerformingRole = PlayingRole::DEFENDER_LEFT;
-    p.headYaw = 0;
-    p.timeWhenReachBall = cycleInfo_->startTime + 600000;
-    p.timeWhenReachBallStriker = cycleInfo_->startTime + 600000;
-    p.lastTimeWhistleHeard = TimePoint(0);
-    p.currentPassTarget = -1;
+    case SPLNetworkData::IncomingMessage::DSMessageStatus::VALID:
+      break;
+    case SPLNetworkData::IncomingMessage::DSMessageStatus::MISSING:
+      Log(LogLevel::INFO) << "Received a SPL msg without DevilSMASH msg in custom data field";
+      return 0;
+    case SPLNetworkData::IncomingMessage::DSMessageStatus::TRUNCATED:
+      Log(LogLevel::ERROR) << "sizeOfDSMessage > remaining SPL message bytes!";
+      return 0;
+    case SPLNetworkData::IncomingMessage::DSMessageStatus::MALFORMED:
+      // invalidate data that may have been written to p.
+      p.isHULK = false;
+      p.currentlyPerformingRole = PlayingRole::DEFENDER_LEFT;
+      p.headYaw = 0;
+      p.timeWhenReachBall = cycleInfo_->startTime + 600000;
+      p.timeWhenReachBallStriker = cycleInfo_->startTime + 600000;
+      p.lastTimeWhistleHeard = TimePoint(0);
+      p.currentPassTarget = -1;
 
-    Log(LogLevel::ERROR) << "Received a SPL msg with malformatted DevilSMASH msg!";
-    return 0;
+      Log(LogLevel::ERROR) << "Received a SPL msg with malformatted DevilSMASH msg!";
+      return 0;
   }
 
-  assert(minimumSizeReached);
-
   if (devilSmashMsg.requestsNTPMessage)
   {
     NTPData::NTPRequest request;
@@ -59,16 +59,14 @@ private:
   std::vector<NTPRobot> ntpRobots_;
 
   /**
-   * @brief parseDSMsg tries to extract the DSmsg from msg.data and writes all information into p
+   * @brief parseDSMsg writes all information of the DSmsg that has been decoded by the network
+   * thread into p
    *
-   * @param msg the received standard message
-   * @param remainingBytes the number of bytes that were not parsed yet
-   * @param receiveTime the time when the message was received
+   * @param message the received message
    * @param p the player object to write the parsed data into
    * @return the number of bytes that were parsed (0 on failure)
    */
-  unsigned int parseDSMsg(const SPLStandardMessage& msg, unsigned int remainingBytes,
-                          const TimePoint& receiveTime, RawTeamPlayer& p);
+  unsigned int parseDSMsg(const SPLNetworkData::IncomingMessage& message, RawTeamPlayer& p);
 
   /**
    * @brief parseHULKMsg tries to extract the HULKmsg from msg data and writes all info into p
@@ -15,6 +15,7 @@ SPLMessageTransmitter::SPLMessageTransmitter(const ModuleManagerInterface& manag
   , transmitViaEthernet_(*this, "transmitViaEthernet", [] {})
   , sendSonarObstacles_(*this, "sendSonarObstacles", [] {})
   , fakeMemberFlag_(*this, "fakeMemberFlag", [] {})
+  , packDSMessage_(*this, "packDSMessage", [] {})
   , playerConfiguration_(*this)
   , networkServiceData_(*this)
   , ballState_(*this)
@@ -93,6 +94,10 @@ void SPLMessageTransmitter::cycle()
   msg.ball[1] = ballState_->position.y() * 1000.f;
 
   DevilSmash::StandardMessage devilSmashMsg;
+  if (packDSMessage_())
+  {
+    devilSmashMsg.version = DS_STANDARD_MESSAGE_PACKED_VERSION;
+  }
   devilSmashMsg.member = fakeMemberFlag_() ? DEVIL_MEMBER : HULKS_MEMBER;
   devilSmashMsg.isPenalized = (gameControllerState_->penalty != Penalty::NONE) ||
                               (gameControllerState_->gameState == GameState::INITIAL &&
@@ -52,6 +52,8 @@ private:
   const Parameter<bool> sendSonarObstacles_;
   /// whether the transmitter should fake the member flag (aka saying that we are a non HULK robot)
   const Parameter<bool> fakeMemberFlag_;
+  /// whether the DevilSmash message should be sent bit packed (all receivers must support it)
+  const Parameter<bool> packDSMessage_;
   /// player and team number are needed for identification
   const Dependency<PlayerConfiguration> playerConfiguration_;
   /// Network service data to determine if there is any wifi connected
@@ -1,6 +1,3 @@
-#include <cstring>
-#include <stdexcept>
-
 // This needs to be here because of windows includes
 #include "Tools/Storage/Image.hpp"
 #include "Tools/Storage/Image422.hpp"
@@ -20,6 +17,8 @@ SPLNetworkService::SPLNetworkService(const ModuleManagerInterface& manager)
   , useMulticast_(*this, "useMulticast")
   , playerConfiguration_(*this)
   , splNetworkData_(*this)
+  , decoder_()
+  , droppedMessages_(0)
   , ioService_()
   , lastSenderEndpoint_()
   , foreignEndpoint_()
@@ -92,10 +91,15 @@ SPLNetworkService::~SPLNetworkService()
 
 void SPLNetworkService::cycle()
 {
+  while (receivedMessages_.pop(receivedMessage_))
+  {
+    splNetworkData_->messages.push_back(receivedMessage_);
+  }
+  const unsigned int droppedMessages = droppedMessages_.exchange(0);
+  if (droppedMessages > 0)
   {
-    std::lock_guard<std::mutex> lg(lock_);
-    splNetworkData_->messages = messages_;
-    messages_.clear();
+    Log(LogLevel::WARNING) << "SPLNetworkService dropped " << droppedMessages
+                           << " messages because they were not processed in time";
   }
   splNetworkData_->sendMessage = sendMessageHandle_;
 }
@@ -116,33 +120,21 @@ void SPLNetworkService::onSocketReceive(const boost::system::error_code& error,
   {
     print("Received team message", LogLevel::DEBUG);
 
-    // Perform some data checks
-    try
+    // The message is checked and decoded here so that the brain only has to copy it.
+    const SPLMessageDecoder::Result result =
+        decoder_.decode(receive_.data(), bytesTransferred, decodedMessage_);
+    if (result == SPLMessageDecoder::Result::VALID)
     {
-      SPLStandardMessage msg;
-      if (bytesTransferred < sizeof(msg) - SPL_STANDARD_MESSAGE_DATA_SIZE)
-      {
-        throw std::runtime_error("Message size is too small");
-      }
-      memcpy(&msg, receive_.data(), sizeof(msg));
-      if (memcmp(msg.header, SPL_STANDARD_MESSAGE_STRUCT_HEADER, sizeof(msg.header)) != 0)
-      {
-        throw std::runtime_error("SPLStandardMessage header does not match");
-      }
-
-      // SPLStandardMessage Version check
-      if (msg.version != SPL_STANDARD_MESSAGE_STRUCT_VERSION)
-      {
-        throw std::runtime_error("SPLStandardMessage does not match the implemented version");
-      }
+      decodedMessage_.receiveTimePoint = receivedTime;
+      decodedMessage_.senderAddr = lastSenderEndpoint_.address();
+      if (!receivedMessages_.push(decodedMessage_))
       {
-        std::lock_guard<std::mutex> lg(lock_);
-        messages_.emplace_back(msg, receivedTime, lastSenderEndpoint_.address());
+        droppedMessages_++;
       }
     }
-    catch (const std::exception& e)
+    else
     {
-      print(e.what(), LogLevel::ERROR);
+      print(SPLMessageDecoder::describe(result), LogLevel::ERROR);
     }
   }
   else
@@ -1,8 +1,7 @@
 #pragma once
 
-#include <mutex>
+#include <atomic>
 #include <thread>
-#include <vector>
 
 #include <boost/array.hpp>
 #include <boost/asio.hpp>
@@ -12,6 +11,8 @@
 #include "Data/SPLNetworkData.hpp"
 #include "Definitions/SPLStandardMessage.h"
 #include "Framework/Module.hpp"
+#include "Modules/Network/SPLMessageDecoder.hpp"
+#include "Tools/Var/SpscQueue.hpp"
 
 
 class Brain;
@@ -36,7 +37,7 @@ public:
    */
   ~SPLNetworkService() override;
   /**
-   * @brief cycle copies received messages to exposed list
+   * @brief cycle moves the received messages to the exposed list
    */
   void cycle() override;
 
@@ -62,10 +63,21 @@ private:
   const Dependency<PlayerConfiguration> playerConfiguration_;
   /// exports the sendMessage function and received messages
   Production<SPLNetworkData> splNetworkData_;
-  /// internal list of messages
-  std::vector<SPLNetworkData::IncomingMessage> messages_;
-  /// lock for the messages
-  std::mutex lock_;
+  /// decodes the received messages in the IO service thread
+  const SPLMessageDecoder decoder_;
+  /// the message that is decoded in the IO service thread (reused to avoid allocations)
+  SPLNetworkData::IncomingMessage decodedMessage_;
+  /// the message that is taken out of the ring in cycle
+  SPLNetworkData::IncomingMessage receivedMessage_;
+  /**
+   * decoded messages from the IO service thread to the brain thread. The messages are copied into
+   * and out of the slots, including the vectors of the DevilSmash message. The copies reuse the
+   * capacity of the slots, so they only allocate while a slot has not yet held a message with as
+   * many elements. Appending the messages to the SPLNetworkData in cycle allocates as before.
+   */
+  SpscRing<SPLNetworkData::IncomingMessage, 32> receivedMessages_;
+  /// the number of messages that have been dropped because the ring was full
+  std::atomic<unsigned int> droppedMessages_;
   /// an IO service that runs in a seperate thread
   boost::asio::io_service ioService_;
   /// the endpoint of the last incoming message
@@ -0,0 +1,748 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Data/CollisionDetectorData.hpp"
+#include "Data/EyeLEDRequest.hpp"
+#include "Data/GameControllerState.hpp"
+#include "Data/MotionPlannerOutput.hpp"
+#include "Data/MotionRequest.hpp"
+#include "Data/WhistleData.hpp"
+#include "Framework/Database.hpp"
+#include "Framework/Messaging.hpp"
+#include "Hardware/MotionBenchmark/MotionBenchmarkInterface.hpp"
+#include "Modules/Configuration/Configuration.h"
+#include "Modules/Debug/Debug.h"
+#include "Modules/NaoProvider.h"
+#include "Modules/Poses.h"
+#include "Odometry/SensorFusion.hpp"
+#include "Tools/Storage/UniValue/UniValue2Json.hpp"
+#include "print.h"
+
+#include "Motion.hpp"
+
+/*
+ * This is a headless benchmark for the motion. It runs the complete Motion module chain as fast as
+ * possible on recorded or synthetic sensor data while a script provides the data types that are
+ * normally sent by the Brain (most importantly the MotionRequest). It reports the duration of every
+ * module and of every cycle per script phase and checks that all cycles fit into the hardware
+ * period with the given margin.
+ *
+ * Usage: motionBenchmark [-r <replay.json>] [-s <script.json>] [-i <repetitions>]
+ *                        [-p <period in ms>] [-m <margin>] [-c <replay.json>]
+ *
+ * The replay file is a file as written by the ReplayRecorder. Only the sensor values of its frames
+ * are used and the frames are looped. Without a replay file, the robot stands upright and its
+ * joints follow the commands without delay.
+ *
+ * A script file contains an array of phases. Each phase is an object with a "name", the number of
+ * "cycles" and optionally values for the data types that Motion imports (e.g. "MotionRequest" or
+ * "GameControllerState", as they are sent by the debug protocol) and an "imu" array that overrides
+ * the IMU values during the phase. Data types keep their values from previous phases unless they
+ * are given. The MotionPlannerOutput follows the MotionRequest unless it is given explicitly.
+ * Without a script file, a built-in script with walk, kick, stand up and sit down transitions is
+ * used.
+ *
+ * The exit code is EXIT_FAILURE iff a cycle took longer than period * (1 - margin).
+ *
+ * With -c, the Motion is not run. Instead, the single precision SensorFusion of the IMUOdometry is
+ * compared to the same filter in double precision on the IMU values of the given replay file. The
+ * deviation of the orientation and the body tilt and the time per update are reported.
+ */
+
+/**
+ * @brief ModuleStatistics accumulates the durations of one module
+ */
+struct ModuleStatistics
+{
+  /// the mount point of the module
+  std::string name;
+  /// the accumulated duration in nanoseconds
+  double time = 0.0;
+  /// the longest duration in nanoseconds
+  double maxTime = 0.0;
+};
+
+/**
+ * @brief BenchmarkMotion is the Motion module manager with time measurements for each module
+ */
+class BenchmarkMotion : public Motion
+{
+public:
+  /**
+   * @brief BenchmarkMotion creates all motion modules
+   * @param senders the list of senders for motion
+   * @param receivers the list of receivers for motion
+   * @param d a reference to the Debug instance
+   * @param c a reference to the Configuration instance
+   * @param ri a reference to the RobotInterface instance
+   */
+  BenchmarkMotion(const std::vector<Sender*>& senders, const std::vector<Receiver*>& receivers,
+                  Debug& d, Configuration& c, RobotInterface& ri)
+    : Motion(senders, receivers, d, c, ri)
+  {
+    statistics_.push_back({"Motion.receive"});
+    for (auto& module : modules_)
+    {
+#ifdef ITTNOTIFY_FOUND
+      statistics_.push_back({module.first->getMount()});
+#else
+      statistics_.push_back({module->getMount()});
+#endif
+    }
+    statistics_.push_back({"Motion.send"});
+  }
+  /**
+   * @brief cycle runs all motion modules and measures their durations
+   */
+  void cycle() override
+  {
+    auto start = std::chrono::steady_clock::now();
+    auto statistics = statistics_.begin();
+    getDatabase().receive();
+    measure(*statistics++, start);
+    for (auto& module : modules_)
+    {
+#ifdef ITTNOTIFY_FOUND
+      module.first->runCycle();
+#else
+      module->runCycle();
+#endif
+      measure(*statistics++, start);
+    }
+    getDatabase().send();
+    measure(*statistics, start);
+  }
+  /**
+   * @brief getStatistics returns the statistics of all modules in execution order
+   * @return the statistics of the modules, framed by the receiving and sending of data types
+   */
+  const std::vector<ModuleStatistics>& getStatistics() const
+  {
+    return statistics_;
+  }
+
+private:
+  /**
+   * @brief measure adds the duration since start to the statistics and restarts the measurement
+   * @param statistics the statistics of the measured module
+   * @param start the start of the measurement, is set to the current time
+   */
+  static void measure(ModuleStatistics& statistics, std::chrono::steady_clock::time_point& start)
+  {
+    const auto end = std::chrono::steady_clock::now();
+    const double time = std::chrono::duration<double, std::nano>(end - start).count();
+    statistics.time += time;
+    statistics.maxTime = std::max(statistics.maxTime, time);
+    start = end;
+  }
+
+  /// the statistics of all modules in execution order
+  std::vector<ModuleStatistics> statistics_;
+};
+
+/**
+ * @brief ScriptPhase is a section of the script in which the imported data types are constant
+ */
+struct ScriptPhase
+{
+  /// the name of the phase (phases with the same name are evaluated together)
+  std::string name;
+  /// the number of motion cycles of this phase
+  unsigned int cycles;
+  /// the values of data types (and the IMU override) that are set at the beginning of the phase
+  Uni::Value data;
+};
+
+/**
+ * @brief PhaseStatistics accumulates the cycle durations of the phases with the same name
+ */
+struct PhaseStatistics
+{
+  /// the name of the phases
+  std::string name;
+  /// the durations of all cycles in nanoseconds
+  std::vector<double> cycleTimes;
+  /// the duration of the longest cycle in nanoseconds
+  double maxCycleTime = 0.0;
+  /// the index of the longest cycle relative to the beginning of the script (phases with the
+  /// same name occur several times in the script)
+  unsigned int maxCycleIndex = 0;
+};
+
+/**
+ * @brief createPhase creates a phase of the built-in script
+ * @param name the name of the phase
+ * @param cycles the number of cycles of the phase
+ * @param motionRequest the motion request during the phase
+ * @return the phase
+ */
+ScriptPhase createPhase(const std::string& name, const unsigned int cycles,
+                        const MotionRequest& motionRequest)
+{
+  ScriptPhase phase{name, cycles, Uni::Value(Uni::ValueType::OBJECT)};
+  phase.data["MotionRequest"] << motionRequest;
+  return phase;
+}
+
+/**
+ * @brief createDefaultScript creates a script that contains the most expensive transitions
+ * @return the phases of the script
+ */
+std::vector<ScriptPhase> createDefaultScript()
+{
+  std::vector<ScriptPhase> script;
+  MotionRequest motionRequest;
+  motionRequest.reset();
+
+  ScriptPhase initial = createPhase("dead", 100, motionRequest);
+  GameControllerState gameControllerState;
+  gameControllerState.reset();
+  gameControllerState.valid = true;
+  gameControllerState.gameState = GameState::PLAYING;
+  initial.data["GameControllerState"] << gameControllerState;
+  script.push_back(initial);
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::STAND;
+  script.push_back(createPhase("stand", 300, motionRequest));
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::WALK;
+  motionRequest.walkData.mode = WalkMode::VELOCITY;
+  motionRequest.walkData.target = Pose(1.f, 0.f, 0.f);
+  motionRequest.walkData.velocity = Velocity(Vector2f(1.f, 0.f), 0.f);
+  motionRequest.walkStopData.gracefully = true;
+  script.push_back(createPhase("walk", 500, motionRequest));
+
+  motionRequest.walkData.velocity = Velocity(Vector2f(0.5f, 0.5f), 0.5f);
+  script.push_back(createPhase("walkTurn", 300, motionRequest));
+
+  motionRequest.walkData.inWalkKickType = InWalkKickType::FORWARD;
+  motionRequest.walkData.kickFoot = KickFoot::RIGHT;
+  script.push_back(createPhase("inWalkKick", 200, motionRequest));
+  motionRequest.walkData.inWalkKickType = InWalkKickType::NONE;
+  motionRequest.walkData.kickFoot = KickFoot::NONE;
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::STAND;
+  script.push_back(createPhase("stand", 200, motionRequest));
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::KICK;
+  motionRequest.kickData.ballSource = Vector2f(0.17f, -0.05f);
+  motionRequest.kickData.ballDestination = Vector2f(2.f, -0.05f);
+  motionRequest.kickData.kickType = KickType::FORWARD;
+  script.push_back(createPhase("kick", 300, motionRequest));
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::STAND;
+  script.push_back(createPhase("stand", 100, motionRequest));
+
+  // The robot lies on its front until the stand up brings it back to an upright position.
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::STAND_UP;
+  ScriptPhase fallen = createPhase("standUp", 200, motionRequest);
+  std::array<float, keys::sensor::IMU_MAX> lyingOnFront;
+  lyingOnFront.fill(0.f);
+  lyingOnFront[keys::sensor::IMU_ACC_X] = -9.81f;
+  lyingOnFront[keys::sensor::IMU_ANGLE_Y] = static_cast<float>(M_PI_2);
+  fallen.data["imu"] << lyingOnFront;
+  script.push_back(fallen);
+  script.push_back(createPhase("standUp", 400, motionRequest));
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::STAND;
+  script.push_back(createPhase("stand", 200, motionRequest));
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::SIT_DOWN;
+  script.push_back(createPhase("sitDown", 300, motionRequest));
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::STAND;
+  script.push_back(createPhase("sitUp", 300, motionRequest));
+
+  motionRequest.bodyMotion = MotionRequest::BodyMotion::PENALIZED;
+  script.push_back(createPhase("penalized", 100, motionRequest));
+  return script;
+}
+
+/**
+ * @brief loadScript loads a script from a file
+ * @param path the path to the JSON file
+ * @param script the loaded phases are appended to this
+ * @return true iff the file could be loaded
+ */
+bool loadScript(const std::string& path, std::vector<ScriptPhase>& script)
+{
+  std::ifstream stream(path);
+  Json::Reader reader;
+  Json::Value root;
+  if (!stream.is_open() || !reader.parse(stream, root))
+  {
+    Log(LogLevel::ERROR) << "Could not read the script from " << path;
+    return false;
+  }
+  const Uni::Value phases = Uni::Converter::toUniValue(root);
+  if (phases.type() != Uni::ValueType::ARRAY)
+  {
+    Log(LogLevel::ERROR) << "The root of " << path << " is not an array of phases";
+    return false;
+  }
+  for (auto it = phases.vectorBegin(); it != phases.vectorEnd(); it++)
+  {
+    if (!it->contains("name") || !it->contains("cycles"))
+    {
+      Log(LogLevel::ERROR) << "A phase in " << path << " has no name or number of cycles";
+      return false;
+    }
+    script.push_back({(*it)["name"].asString(),
+                      static_cast<unsigned int>((*it)["cycles"].asInt32()), *it});
+  }
+  return true;
+}
+
+/**
+ * @brief SensorFusionModule provides the parameters of the IMUOdometry to the compared filters
+ */
+class SensorFusionModule : public ModuleBase
+{
+public:
+  /**
+   * @brief SensorFusionModule mounts the configuration of the IMUOdometry
+   * @param manager the Motion module manager
+   */
+  SensorFusionModule(const ModuleManagerInterface& manager)
+    : ModuleBase(manager, "IMUOdometry")
+  {
+  }
+  /**
+   * @brief runCycle does nothing since the benchmark updates the filters directly
+   */
+  void runCycle() override {}
+};
+
+/**
+ * @brief runSensorFusion feeds the IMU values of all frames to a new SensorFusion
+ * @tparam T the floating point type of the SensorFusion
+ * @param module the module that provides the parameters
+ * @param frames the recorded frames
+ * @param cycleTimes the time between each frame and its predecessor in seconds
+ * @param repetitions the number of passes over the frames (each with a new SensorFusion)
+ * @param orientations the orientation after each frame (of the last pass)
+ * @param bodyTilts the body tilt after each frame (of the last pass)
+ * @return the mean duration of an update (including reading the outputs) in nanoseconds
+ */
+template <typename T>
+double runSensorFusion(const ModuleBase& module, const std::vector<ReplayFrame>& frames,
+                       const std::vector<float>& cycleTimes, const std::size_t repetitions,
+                       std::vector<Vector3<T>>& orientations,
+                       std::vector<Matrix3<T>>& bodyTilts)
+{
+  orientations.resize(frames.size());
+  bodyTilts.resize(frames.size());
+  double time = 0.0;
+  for (std::size_t repetition = 0; repetition < repetitions; repetition++)
+  {
+    SensorFusion<T> sensorFusion(module);
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < frames.size(); i++)
+    {
+      const auto& imu = frames[i].imu;
+      sensorFusion.update(Vector3f(imu[keys::sensor::IMU_GYR_X], imu[keys::sensor::IMU_GYR_Y],
+                                   imu[keys::sensor::IMU_GYR_Z]),
+                          Vector3f(imu[keys::sensor::IMU_ACC_X], imu[keys::sensor::IMU_ACC_Y],
+                                   imu[keys::sensor::IMU_ACC_Z]),
+                          cycleTimes[i]);
+      // the IMUOdometry reads both outputs in every cycle
+      orientations[i] = sensorFusion.getOrientation();
+      bodyTilts[i] = sensorFusion.getBodyTilt();
+    }
+    time += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+                .count();
+  }
+  return time / static_cast<double>(std::max<std::size_t>(repetitions * frames.size(), 1));
+}
+
+/**
+ * @brief compareSensorFusion compares the single and double precision SensorFusion
+ * @param manager the Motion module manager
+ * @param frames the recorded frames whose IMU values are fed to the filters
+ * @param period the time between two frames in ms if the timestamps are not increasing
+ * @param repetitions the number of passes over the frames for the time measurement
+ */
+void compareSensorFusion(const ModuleManagerInterface& manager,
+                         const std::vector<ReplayFrame>& frames, const unsigned int period,
+                         const std::size_t repetitions)
+{
+  std::vector<float> cycleTimes(frames.size(), period * 0.001f);
+  for (std::size_t i = 1; i < frames.size(); i++)
+  {
+    const int difference = frames[i].timestamp - frames[i - 1].timestamp;
+    if (difference > 0)
+    {
+      cycleTimes[i] = difference * 0.001f;
+    }
+  }
+
+  SensorFusionModule module(manager);
+  std::vector<Vector3<float>> floatOrientations;
+  std::vector<Matrix3<float>> floatBodyTilts;
+  std::vector<Vector3<double>> doubleOrientations;
+  std::vector<Matrix3<double>> doubleBodyTilts;
+  const double floatTime = runSensorFusion(module, frames, cycleTimes, repetitions,
+                                           floatOrientations, floatBodyTilts);
+  const double doubleTime = runSensorFusion(module, frames, cycleTimes, repetitions,
+                                            doubleOrientations, doubleBodyTilts);
+
+  // the deviations of roll, pitch, yaw and the body tilt (largest absolute coefficient)
+  std::array<double, 4> maxError;
+  std::array<double, 4> sumError;
+  maxError.fill(0.0);
+  sumError.fill(0.0);
+  for (std::size_t i = 0; i < frames.size(); i++)
+  {
+    std::array<double, 4> error;
+    for (int axis = 0; axis < 3; axis++)
+    {
+      error[axis] = std::abs(std::remainder(
+          floatOrientations[i](axis) - doubleOrientations[i](axis), 2.0 * M_PI));
+    }
+    error[3] = (floatBodyTilts[i].cast<double>() - doubleBodyTilts[i]).cwiseAbs().maxCoeff();
+    for (std::size_t j = 0; j < error.size(); j++)
+    {
+      maxError[j] = std::max(maxError[j], error[j]);
+      sumError[j] += error[j];
+    }
+  }
+
+  const std::array<const char*, 4> names = {{"roll [rad]", "pitch [rad]", "yaw [rad]", "tilt"}};
+  std::cout << "SensorFusion on " << frames.size() << " frames, " << repetitions
+            << " repetitions\n\n"
+            << std::left << std::setw(16) << "precision" << std::right << std::setw(14)
+            << "update[ns]" << "\n"
+            << std::fixed << std::setprecision(1) << std::left << std::setw(16) << "float"
+            << std::right << std::setw(14) << floatTime << "\n"
+            << std::left << std::setw(16) << "double" << std::right << std::setw(14) << doubleTime
+            << "\n\n"
+            << std::left << std::setw(16) << "float - double" << std::right << std::setw(14)
+            << "max" << std::setw(14) << "mean" << "\n"
+            << std::scientific << std::setprecision(2);
+  for (std::size_t j = 0; j < names.size(); j++)
+  {
+    std::cout << std::left << std::setw(16) << names[j] << std::right << std::setw(14)
+              << maxError[j] << std::setw(14)
+              << sumError[j] / static_cast<double>(std::max<std::size_t>(frames.size(), 1))
+              << "\n";
+  }
+  std::cout << "(tilt is the largest absolute difference of the body tilt matrix coefficients)\n";
+}
+
+/**
+ * @brief MotionBenchmark sets up the configuration and runs the measurements
+ */
+class MotionBenchmark
+{
+public:
+  /**
+   * @brief run parses the command line, runs the motion and prints the statistics
+   * @param argc the number of command line arguments
+   * @param argv the command line arguments
+   * @return the exit code of the program
+   */
+  static int run(int argc, char* argv[]);
+};
+
+int MotionBenchmark::run(int argc, char* argv[])
+{
+  std::string replayPath;
+  std::string scriptPath;
+  std::string comparisonPath;
+  std::size_t repetitions = 10;
+  unsigned int period = 10;
+  double margin = 0.2;
+  const auto printUsage = [] {
+    Log(LogLevel::ERROR) << "Usage: motionBenchmark [-r <replay.json>] [-s <script.json>] "
+                            "[-i <repetitions>] [-p <period in ms>] [-m <margin>] "
+                            "[-c <replay.json>]";
+  };
+  for (int i = 1; i < argc; i += 2)
+  {
+    const std::string option = argv[i];
+    if (i + 1 == argc)
+    {
+      Log(LogLevel::ERROR) << "Option " << option << " has no value";
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    try
+    {
+      if (option == "-r")
+      {
+        replayPath = argv[i + 1];
+      }
+      else if (option == "-s")
+      {
+        scriptPath = argv[i + 1];
+      }
+      else if (option == "-i")
+      {
+        repetitions = std::stoul(argv[i + 1]);
+      }
+      else if (option == "-p")
+      {
+        period = std::stoul(argv[i + 1]);
+      }
+      else if (option == "-m")
+      {
+        margin = std::stod(argv[i + 1]);
+      }
+      else if (option == "-c")
+      {
+        comparisonPath = argv[i + 1];
+      }
+      else
+      {
+        printUsage();
+        return EXIT_FAILURE;
+      }
+    }
+    catch (const std::invalid_argument&)
+    {
+      Log(LogLevel::ERROR) << "Option " << option << " needs a number but got " << argv[i + 1];
+      printUsage();
+      return EXIT_FAILURE;
+    }
+    catch (const std::out_of_range&)
+    {
+      Log(LogLevel::ERROR) << "The value of option " << option << " is out of range";
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::vector<ScriptPhase> script;
+  if (scriptPath.empty())
+  {
+    script = createDefaultScript();
+  }
+  else if (!loadScript(scriptPath, script))
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::vector<ReplayFrame> frames;
+  if (!replayPath.empty())
+  {
+    try
+    {
+      frames = MotionBenchmarkInterface::loadFrames(replayPath);
+    }
+    catch (const std::exception& e)
+    {
+      Log(LogLevel::ERROR) << e.what();
+      return EXIT_FAILURE;
+    }
+  }
+  std::vector<ReplayFrame> comparisonFrames;
+  if (!comparisonPath.empty())
+  {
+    try
+    {
+      comparisonFrames = MotionBenchmarkInterface::loadFrames(comparisonPath);
+    }
+    catch (const std::exception& e)
+    {
+      Log(LogLevel::ERROR) << e.what();
+      return EXIT_FAILURE;
+    }
+  }
+  MotionBenchmarkInterface robotInterface(std::move(frames), period);
+  const auto standaloneConfiguration =
+      Configuration::createStandalone(robotInterface.getFileRoot());
+  Configuration& configuration = *standaloneConfiguration;
+  configuration.mount("tuhhSDK.base", "sdk.json", ConfigurationType::HEAD);
+  configuration.setLocationName(configuration.get("tuhhSDK.base", "location").asString());
+  NaoInfo info;
+  robotInterface.getNaoInfo(configuration, info);
+  configuration.setNaoHeadName(info.headName);
+  configuration.setNaoBodyName(info.bodyName);
+  robotInterface.configure(configuration, info);
+  if (!Poses::initStandalone(robotInterface.getFileRoot()))
+  {
+    return EXIT_FAILURE;
+  }
+  NaoProvider::init(configuration, info);
+  tuhhprint::setLogLevel(
+      tuhhprint::getLogLevel(configuration.get("tuhhSDK.base", "loglevel").asString()));
+  // the module setup is loaded in the same way as by the SharedObjectManager
+  configuration.mount("tuhhSDK.autoload", "tuhh_autoload.json", ConfigurationType::HEAD);
+  configuration.mount("tuhhSDK.moduleSetup", "moduleSetup_default.json", ConfigurationType::HEAD);
+  configuration.mount(
+      "tuhhSDK.moduleSetup",
+      "moduleSetup_" + configuration.get("tuhhSDK.autoload", "moduleSetup").asString() + ".json",
+      ConfigurationType::HEAD);
+
+  // The script replaces the Brain. Its database sends the scripted data types to Motion.
+  Debug debug;
+  DuplexChannel channel;
+  Database scriptDatabase;
+  scriptDatabase.addSender(&channel.getA2BSender());
+  auto& motionRequest = scriptDatabase.get<MotionRequest>();
+  auto& motionPlannerOutput = scriptDatabase.get<MotionPlannerOutput>();
+  const std::vector<DataTypeBase*> scriptedDataTypes = {
+      &motionRequest,
+      &motionPlannerOutput,
+      &scriptDatabase.get<GameControllerState>(),
+      &scriptDatabase.get<EyeLEDRequest>(),
+      &scriptDatabase.get<WhistleData>(),
+      &scriptDatabase.get<CollisionDetectorData>()};
+  std::unordered_set<std::type_index> scriptedTypes;
+  for (auto data : scriptedDataTypes)
+  {
+    scriptedTypes.emplace(typeid(*data));
+    scriptDatabase.produce(typeid(*data));
+  }
+
+  BenchmarkMotion motion({&channel.getB2ASender()}, {&channel.getA2BReceiver()}, debug,
+                         configuration, robotInterface);
+  for (auto& requested : channel.getA2BSender().getRequested())
+  {
+    if (scriptedTypes.count(requested) == 0)
+    {
+      Log(LogLevel::ERROR) << "Motion depends on " << requested.name()
+                           << " which the benchmark script can not provide";
+      return EXIT_FAILURE;
+    }
+  }
+  if (!comparisonFrames.empty())
+  {
+    compareSensorFusion(motion, comparisonFrames, period, repetitions);
+    return EXIT_SUCCESS;
+  }
+
+  std::vector<PhaseStatistics> phaseStatistics;
+  for (std::size_t repetition = 0; repetition < repetitions; repetition++)
+  {
+    unsigned int scriptCycle = 0;
+    for (auto& phase : script)
+    {
+      for (auto data : scriptedDataTypes)
+      {
+        if (phase.data.contains(data->getName()))
+        {
+          phase.data[data->getName()] >> *data;
+        }
+      }
+      if (!phase.data.contains(motionPlannerOutput.getName()))
+      {
+        static_cast<MotionRequest&>(motionPlannerOutput) = motionRequest;
+      }
+      if (phase.data.contains("imu"))
+      {
+        std::array<float, keys::sensor::IMU_MAX> imu;
+        phase.data["imu"] >> imu;
+        robotInterface.overrideIMU(imu);
+      }
+      else
+      {
+        robotInterface.clearIMUOverride();
+      }
+
+      auto statistics =
+          std::find_if(phaseStatistics.begin(), phaseStatistics.end(),
+                       [&phase](const PhaseStatistics& s) { return s.name == phase.name; });
+      if (statistics == phaseStatistics.end())
+      {
+        phaseStatistics.emplace_back();
+        phaseStatistics.back().name = phase.name;
+        statistics = std::prev(phaseStatistics.end());
+      }
+      statistics->cycleTimes.reserve(statistics->cycleTimes.size() + phase.cycles);
+      for (unsigned int cycle = 0; cycle < phase.cycles; cycle++, scriptCycle++)
+      {
+        // On the robot, the Brain sends its data types with a lower frequency. Sending them in
+        // every cycle gives an upper bound for the cost of receiving them.
+        scriptDatabase.send();
+        const auto cycleStart = std::chrono::steady_clock::now();
+        motion.runCycle();
+        const auto cycleEnd = std::chrono::steady_clock::now();
+        const double cycleTime =
+            std::chrono::duration<double, std::nano>(cycleEnd - cycleStart).count();
+        if (cycleTime > statistics->maxCycleTime)
+        {
+          statistics->maxCycleTime = cycleTime;
+          statistics->maxCycleIndex = scriptCycle;
+        }
+        statistics->cycleTimes.push_back(cycleTime);
+      }
+    }
+  }
+
+  const double limit = period * 1e6 * (1.0 - margin);
+  std::size_t numberOfCycles = 0;
+  std::size_t cyclesOverLimit = 0;
+  double maxCycleTime = 0.0;
+  std::cout << std::left << std::setw(16) << "phase" << std::right << std::setw(10) << "cycles"
+            << std::setw(12) << "mean[ms]" << std::setw(12) << "p99[ms]" << std::setw(12)
+            << "max[ms]" << std::setw(14) << "max at cycle" << std::setw(12) << "over limit"
+            << "\n";
+  for (auto& statistics : phaseStatistics)
+  {
+    auto& cycleTimes = statistics.cycleTimes;
+    if (cycleTimes.empty())
+    {
+      continue;
+    }
+    double sum = 0.0;
+    std::size_t overLimit = 0;
+    for (const auto cycleTime : cycleTimes)
+    {
+      sum += cycleTime;
+      overLimit += cycleTime > limit;
+    }
+    const auto p99 = cycleTimes.begin() + (cycleTimes.size() - 1) * 99 / 100;
+    std::nth_element(cycleTimes.begin(), p99, cycleTimes.end());
+    numberOfCycles += cycleTimes.size();
+    cyclesOverLimit += overLimit;
+    maxCycleTime = std::max(maxCycleTime, statistics.maxCycleTime);
+    std::cout << std::left << std::setw(16) << statistics.name << std::right << std::setw(10)
+              << cycleTimes.size() << std::fixed << std::setprecision(3) << std::setw(12)
+              << sum / cycleTimes.size() * 1e-6 << std::setw(12) << *p99 * 1e-6 << std::setw(12)
+              << statistics.maxCycleTime * 1e-6 << std::setw(14) << statistics.maxCycleIndex
+              << std::setw(12) << overLimit << "\n";
+  }
+
+  std::cout << "(max at cycle counts the cycles from the beginning of the script)\n";
+
+  std::cout << "\n"
+            << std::left << std::setw(40) << "module" << std::right << std::setw(12) << "mean[us]"
+            << std::setw(12) << "max[us]" << std::setw(10) << "share" << "\n";
+  double totalModuleTime = 0.0;
+  for (const auto& statistics : motion.getStatistics())
+  {
+    totalModuleTime += statistics.time;
+  }
+  for (const auto& statistics : motion.getStatistics())
+  {
+    std::cout << std::left << std::setw(40) << statistics.name << std::right << std::fixed
+              << std::setprecision(1) << std::setw(12)
+              << statistics.time / std::max<std::size_t>(numberOfCycles, 1) * 1e-3
+              << std::setw(12) << statistics.maxTime * 1e-3 << std::setw(9)
+              << 100.0 * statistics.time / std::max(totalModuleTime, 1.0) << "%\n";
+  }
+
+  std::cout << "\nlimit: " << std::setprecision(3) << limit * 1e-6 << " ms (period " << period
+            << " ms, margin " << margin * 100.0 << " %), worst cycle: " << maxCycleTime * 1e-6
+            << " ms, cycles over limit: " << cyclesOverLimit << "/" << numberOfCycles << "\n";
+  return cyclesOverLimit == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int main(int argc, char* argv[])
+{
+  return MotionBenchmark::run(argc, argv);
+}
@@ -16,13 +16,11 @@ void HeadMatrixBufferProvider::cycle()
 {
   Chronometer time(debug(), mount_ + ".cycleTime");
 
-  // index should always point to the oldest entry in the buffer.
-  buffer_[index_].head2torso = robotKinematics_->matrices[JOINTS::HEAD_PITCH];
-  buffer_[index_].torso2ground = robotKinematics_->matrices[JOINTS::TORSO2GROUND_IMU];
-  buffer_[index_].timestamp = cycleInfo_->startTime;
-  index_++;
-  index_ %= bufferSize_;
-
-  headMatrixBuffer_->buffer.assign(buffer_.begin(), buffer_.end());
+  HeadMatrixWithTimestamp entry;
+  entry.head2torso = robotKinematics_->matrices[JOINTS::HEAD_PITCH];
+  entry.torso2ground = robotKinematics_->matrices[JOINTS::TORSO2GROUND_IMU];
+  entry.timestamp = cycleInfo_->startTime;
+  // The production keeps its entries across cycles, so only the newest one has to be appended.
+  headMatrixBuffer_->push(entry);
   headMatrixBuffer_->valid = true;
 }
@@ -29,7 +29,7 @@ public:
 
 private:
   /// filter that estimates body angles using the accelerometer and gyroscope
-  SensorFusion sensorFusion_;
+  SensorFusion<float> sensorFusion_;
   /// the output of the walking engine for translational odometry
   const Dependency<WalkingEngineWalkOutput> walkingEngineWalkOutput_;
   /// the cycle data
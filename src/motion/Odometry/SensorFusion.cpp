@@ -1,7 +1,8 @@
 #include "SensorFusion.hpp"
 #include "Modules/NaoProvider.h"
 
-SensorFusion::SensorFusion(const ModuleBase& module)
+template <typename T>
+SensorFusion<T>::SensorFusion(const ModuleBase& module)
   : initialized_(false)
   , reset_(module, "reset",
            [=] {
@@ -16,54 +17,57 @@ SensorFusion::SensorFusion(const ModuleBase& module)
   , gyro_prev_(0, 0, 0)
   , gyro_bias_(0, 0, 0)
   , global_to_local_(1, 0, 0, 0)
+  , axisAnglesValid_(false)
 {
+  updateOutputs();
 }
 
-void SensorFusion::update(const Vector3f& extGyro, const Vector3f& extAccel, const float cycleTime)
+template <typename T>
+void SensorFusion<T>::update(const Vector3f& extGyro, const Vector3f& extAccel,
+                             const float cycleTime)
 {
 #ifdef NAOV6
-  Vector3d eigenExtGyro(extGyro.x(), extGyro.y(), extGyro.z());
-  Vector3d eigenExtAccel(-extAccel.x(), -extAccel.y(), -extAccel.z());
+  const Vector3<T> gyro(extGyro.x(), extGyro.y(), extGyro.z());
+  const Vector3<T> accel(-extAccel.x(), -extAccel.y(), -extAccel.z());
 #else
-  Vector3d eigenExtGyro(extGyro.x(), extGyro.y(), -extGyro.z());
-  Vector3d eigenExtAccel(-extAccel.x(), +extAccel.y(), -extAccel.z());
+  const Vector3<T> gyro(extGyro.x(), extGyro.y(), -extGyro.z());
+  const Vector3<T> accel(-extAccel.x(), +extAccel.y(), -extAccel.z());
 #endif
+  const T accelNorm = accel.norm();
 
-  if (!initialized_ && eigenExtAccel.norm() >= 1.0)
-  {
-    calculateOrientation(eigenExtGyro, eigenExtAccel);
-    initialized_ = true;
-    return;
-  }
-  else if (!initialized_ && eigenExtAccel.norm() < 1.0)
+  if (!initialized_)
   {
     // Calculating the orientation of the nao while falling (low gravity)
     // would lead to big errors anyway
+    if (accelNorm >= 1)
+    {
+      calculateOrientation(accel);
+      initialized_ = true;
+      updateOutputs();
+    }
     return;
   }
 
-  updateGyroBias(eigenExtGyro, eigenExtAccel);
-  updateOrientationGyro(eigenExtGyro, cycleTime);
-  updateOrientationAccel(eigenExtAccel);
+  updateGyroBias(gyro, accelNorm);
+  updateOrientationGyro(gyro, cycleTime);
+  updateOrientationAccel(accel, accelNorm);
+  updateOutputs();
 }
 
-bool SensorFusion::checkSteadyState(const Vector3d& extGyro, const Vector3d& extAccel)
+template <typename T>
+bool SensorFusion<T>::checkSteadyState(const Vector3<T>& extGyro, const T accelNorm) const
 {
-  double acc_norm = extAccel.norm();
-  if (std::fabs(acc_norm - gravity_()) > acceleration_threshold_())
+  if (std::abs(accelNorm - gravity_()) > acceleration_threshold_())
   {
     return false;
   }
 
-  Vector3d gyro_delta = (extGyro - gyro_prev_).cwiseAbs();
-  if (gyro_delta(0) > delta_angular_velocity_threshold_() || gyro_delta(1) > delta_angular_velocity_threshold_() ||
-      gyro_delta(2) > delta_angular_velocity_threshold_())
+  if ((extGyro - gyro_prev_).cwiseAbs().maxCoeff() > delta_angular_velocity_threshold_())
   {
     return false;
   }
 
-  Vector3d gyro = (extGyro - gyro_bias_).cwiseAbs();
-  if (gyro(0) > angular_velocity_threshold_() || gyro(1) > angular_velocity_threshold_() || gyro(2) > angular_velocity_threshold_())
+  if ((extGyro - gyro_bias_).cwiseAbs().maxCoeff() > angular_velocity_threshold_())
   {
     return false;
   }
@@ -71,71 +75,73 @@ bool SensorFusion::checkSteadyState(const Vector3d& extGyro, const Vector3d& ext
   return true;
 }
 
-void SensorFusion::updateGyroBias(const Vector3d& extGyro, const Vector3d& extAccel)
+template <typename T>
+void SensorFusion<T>::updateGyroBias(const Vector3<T>& extGyro, const T accelNorm)
 {
-  bool steady_state = checkSteadyState(extGyro, extAccel);
-
-  if (steady_state)
+  if (checkSteadyState(extGyro, accelNorm))
   {
-    gyro_bias_ = gyro_bias_alpha_() * (extGyro - gyro_bias_);
+    gyro_bias_ = static_cast<T>(gyro_bias_alpha_()) * (extGyro - gyro_bias_);
   }
 
   gyro_prev_ = extGyro;
 }
 
-void SensorFusion::calculateOrientation(const Vector3d& /*extGyro*/, const Vector3d& extAccel)
+template <typename T>
+void SensorFusion<T>::calculateOrientation(const Vector3<T>& extAccel)
 {
-  Vector3d accel = extAccel.normalized();
-  double q0, q1, q2, q3;
+  const Vector3<T> accel = extAccel.normalized();
+  T q0, q1, q2, q3;
 
   if (accel(2) >= 0)
   {
-    q0 = std::sqrt((accel(2) + 1.0) * 0.5);
+    q0 = std::sqrt((accel(2) + 1) / 2);
     q1 = -accel(1) / (2 * q0);
     q2 = +accel(0) / (2 * q0);
     q3 = 0;
   }
   else
   {
-    double intermediate = std::sqrt((1 - accel(2)) * 0.5);
-    q0 = -accel(1) / (2.0 * intermediate);
+    const T intermediate = std::sqrt((1 - accel(2)) / 2);
+    q0 = -accel(1) / (2 * intermediate);
     q1 = intermediate;
     q2 = 0;
-    q3 = +accel(0) / (2.0 * intermediate);
+    q3 = +accel(0) / (2 * intermediate);
   }
 
-  global_to_local_ = Quaterniond(q0, q1, q2, q3);
+  global_to_local_ = Quaternion(q0, q1, q2, q3);
 }
 
-void SensorFusion::updateOrientationGyro(const Vector3d& extGyro, const float cycleTime)
+template <typename T>
+void SensorFusion<T>::updateOrientationGyro(const Vector3<T>& extGyro, const T cycleTime)
 {
   // See paper page 15
   // https://www.mdpi.com/1424-8220/15/8/19302/pdf
-  Vector3d gyro = extGyro - gyro_bias_;
+  const Vector3<T> gyro = extGyro - gyro_bias_;
 
-  Quaterniond omega(0, gyro(0), gyro(1), gyro(2));
-  Quaterniond dq = omega * global_to_local_;
+  const Quaternion omega(0, gyro(0), gyro(1), gyro(2));
+  const Quaternion dq = omega * global_to_local_;
 
-  global_to_local_.coeffs() += dq.coeffs() * -0.5 * cycleTime;
+  global_to_local_.coeffs() += dq.coeffs() * (-cycleTime / 2);
 
   // Last thing to do is normalize the quaternion
   global_to_local_.normalize();
 }
 
-void SensorFusion::updateOrientationAccel(const Vector3d& extAccel)
+template <typename T>
+void SensorFusion<T>::updateOrientationAccel(const Vector3<T>& extAccel, const T accelNorm)
 {
-  double eps = 0.9; /// SLERP threshold
-  double alpha = 0;
-  double n = extAccel.norm();
-  double error = std::abs((n - gravity_())) / gravity_();
+  const T eps = 0.9; /// SLERP threshold
+  T alpha = 0;
+  const T gravity = gravity_();
+  const T error = std::abs(accelNorm - gravity) / gravity;
 
-  if (error <= 0.1)
+  if (error <= static_cast<T>(0.1))
   {
     alpha = 1;
   }
-  else if (error <= 0.2)
+  else if (error <= static_cast<T>(0.2))
   {
-    alpha = -10 * (error - 0.2);
+    alpha = -10 * (error - static_cast<T>(0.2));
   }
 
   if (alpha == 0)
@@ -146,28 +152,27 @@ void SensorFusion::updateOrientationAccel(const Vector3d& extAccel)
   alpha *= accelweight_();
 
   // Normalize factors, we need the original vector later for the adaptive gain.
-  Vector3d a = extAccel;
-  a /= n;
-  Vector3d gv = global_to_local_.inverse()._transformVector(a);
+  // The state quaternion is normalized, so its conjugate is its inverse.
+  const Vector3<T> gv = global_to_local_.conjugate()._transformVector(extAccel / accelNorm);
 
-  double gx = gv(0);
-  double gy = gv(1);
-  double gz = gv(2);
+  const T gx = gv(0);
+  const T gy = gv(1);
+  const T gz = gv(2);
 
   // Calculate the correction quaternion
-  double q0 = std::sqrt((gz + 1.0) * 0.5);
-  double q1 = -gy / (2.0 * q0);
-  double q2 = +gx / (2.0 * q0);
-  Quaterniond dqa(q0, q1, q2, 0);
+  const T q0 = std::sqrt((gz + 1) / 2);
+  const T q1 = -gy / (2 * q0);
+  const T q2 = +gx / (2 * q0);
+  const Quaternion dqa(q0, q1, q2, 0);
 
-  Quaterniond eye = Quaterniond::Identity();
-  Quaterniond dqab;
+  const Quaternion eye = Quaternion::Identity();
+  Quaternion dqab;
 
   // Do interpolation between current frame and accelerometer frame
   // Based on how close we are to the "correct" frame
   // If we are far away use LERP
   // Otherwise use SLERP
-  double dot = eye.dot(dqa);
+  const T dot = eye.dot(dqa);
   if (dot > eps)
   {
     dqab = (1 - alpha) * eye.coeffs() + alpha * dqa.coeffs();
@@ -182,7 +187,8 @@ void SensorFusion::updateOrientationAccel(const Vector3d& extAccel)
   global_to_local_.normalize();
 }
 
-void SensorFusion::setOrientation(const Vector3d& orient)
+template <typename T>
+void SensorFusion<T>::setOrientation(const Vector3<T>& orient)
 {
   reset_() = false;
   // Code from: https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles
@@ -191,13 +197,13 @@ void SensorFusion::setOrientation(const Vector3d& orient)
   auto& pitch = orient(1);
   auto& yaw = orient(2);
 
-  Quaterniond q;
-  double t0 = std::cos(yaw * 0.5f);
-  double t1 = std::sin(yaw * 0.5f);
-  double t2 = std::cos(roll * 0.5f);
-  double t3 = std::sin(roll * 0.5f);
-  double t4 = std::cos(pitch * 0.5f);
-  double t5 = std::sin(pitch * 0.5f);
+  Quaternion q;
+  const T t0 = std::cos(yaw / 2);
+  const T t1 = std::sin(yaw / 2);
+  const T t2 = std::cos(roll / 2);
+  const T t3 = std::sin(roll / 2);
+  const T t4 = std::cos(pitch / 2);
+  const T t5 = std::sin(pitch / 2);
 
   q.w() = t0 * t2 * t4 + t1 * t3 * t5;
   q.x() = t0 * t3 * t4 - t1 * t2 * t5;
@@ -205,36 +211,31 @@ void SensorFusion::setOrientation(const Vector3d& orient)
   q.z() = t1 * t2 * t4 - t0 * t3 * t5;
   initialized_ = true;
   global_to_local_ = q.inverse();
+  updateOutputs();
 }
 
-Vector3f SensorFusion::getOrientation() const
+template <typename T>
+void SensorFusion<T>::updateOutputs()
 {
   // Code from: https://en.wikipedia.org/wiki/Conversion_between_quaternions_and_Euler_angles
-  auto q = global_to_local_.inverse();
-  double ysqr = q.y() * q.y();
+  const Quaternion q = global_to_local_.conjugate();
+  const T ysqr = q.y() * q.y();
 
   // roll (x-axis rotation)
-  double t0 = +2.0f * (q.w() * q.x() + q.y() * q.z());
-  double t1 = +1.0f - 2.0f * (q.x() * q.x() + ysqr);
-  double roll = std::atan2(t0, t1);
+  const T t0 = +2 * (q.w() * q.x() + q.y() * q.z());
+  const T t1 = +1 - 2 * (q.x() * q.x() + ysqr);
 
   // pitch (y-axis rotation)
-  double t2 = +2.0f * (q.w() * q.y() - q.z() * q.x());
-  t2 = t2 > 1.0f ? 1.0f : t2;
-  t2 = t2 < -1.0f ? -1.0f : t2;
-  double pitch = std::asin(t2);
+  T t2 = +2 * (q.w() * q.y() - q.z() * q.x());
+  t2 = t2 > 1 ? 1 : t2;
+  t2 = t2 < -1 ? -1 : t2;
 
   // yaw (z-axis rotation)
-  double t3 = +2.0f * (q.w() * q.z() + q.x() * q.y());
-  double t4 = +1.0f - 2.0f * (ysqr + q.z() * q.z());
-  double yaw = std::atan2(t3, t4);
+  const T t3 = +2 * (q.w() * q.z() + q.x() * q.y());
+  const T t4 = +1 - 2 * (ysqr + q.z() * q.z());
 
-  return Vector3f(roll, pitch, yaw);
-}
+  orientation_ = Vector3<T>(std::atan2(t0, t1), std::asin(t2), std::atan2(t3, t4));
 
-Matrix3f SensorFusion::getBodyTilt() const
-{
-  Vector3f rpy = getOrientation();
   // the tilt should not contain the yaw. Thus one obtains from rotation matrix:
   // R(yaw, pitch, roll) = R(yaw) * R(pitch) * R(roll)
   //
@@ -242,30 +243,40 @@ Matrix3f SensorFusion::getBodyTilt() const
   //  sin(rpy.z)*cos(rpy.y), sin(rpy.z)*sin(rpy.y)*sin(rpy.x)+cos(rpy.z)*cos(rpy.x), sin(rpy.z)*sin(rpy.y)*cos(rpy.x)-cos(rpy.z)*sin(rpy.x),
   //  -sin(rpy.y),           cos(rpy.y)*sin(rpy.x),                                  cos(rpy.y)*cos(rpy.x));
   //
-  // By canceling some ones and zeros:
-  const float sx = sin(rpy.x());
-  const float cx = cos(rpy.x());
-  const float sy = sin(rpy.y());
-  const float cy = cos(rpy.y());
-
-  Matrix3f ret;
-  ret << cy, sy * sx, sy * cx, 0, cx, -sx, -sy, cy * sx, cy * cx;
-  return ret;
+  // By canceling some ones and zeros. The sines and cosines of roll and pitch follow directly from
+  // the arguments of atan2 and asin above.
+  const T rollNorm = std::sqrt(t0 * t0 + t1 * t1);
+  const T sx = rollNorm > 0 ? t0 / rollNorm : 0;
+  const T cx = rollNorm > 0 ? t1 / rollNorm : 1;
+  const T sy = t2;
+  const T cy = std::sqrt(1 - t2 * t2);
+
+  bodyTilt_ << cy, sy * sx, sy * cx, 0, cx, -sx, -sy, cy * sx, cy * cx;
+
+  axisAnglesValid_ = false;
 }
 
-Vector3f SensorFusion::getAxisAngles() const
+template <typename T>
+const Vector3<T>& SensorFusion<T>::getAxisAngles() const
 {
-  auto q = global_to_local_.inverse();
-  float theta = 2 * std::acos(q.x());
-
-  Vector3f w;
+  if (axisAnglesValid_)
+  {
+    return axisAngles_;
+  }
+  const Quaternion q = global_to_local_.conjugate();
+  const T theta = 2 * std::acos(std::min<T>(std::max<T>(q.x(), -1), 1));
   if (theta != 0)
   {
-    float s = 1 / (std::sin(theta / 2));
-    w.x() = static_cast<float>(s * q.y());
-    w.y() = static_cast<float>(s * q.z());
-    w.z() = static_cast<float>(s * q.w());
+    const T s = 1 / (std::sin(theta / 2));
+    axisAngles_ = Vector3<T>(s * q.y(), s * q.z(), s * q.w()) * theta;
   }
-
-  return w * theta;
+  else
+  {
+    axisAngles_ = Vector3<T>::Zero();
+  }
+  axisAnglesValid_ = true;
+  return axisAngles_;
 }
+
+template class SensorFusion<float>;
+template class SensorFusion<double>;
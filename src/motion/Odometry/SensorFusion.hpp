@@ -5,6 +5,14 @@
 #include <Tools/Math/Eigen.hpp>
 
 
+/**
+ * @brief SensorFusion estimates the orientation of the torso from the gyroscope and accelerometer
+ *
+ * The Motion uses the single precision version. The double precision version is only instantiated
+ * as reference for the comparison in the motion benchmark.
+ * @tparam T the floating point type of the state and the outputs
+ */
+template <typename T>
 class SensorFusion
 {
 public:
@@ -24,54 +32,71 @@ public:
    * @brief setOrientation resets to internal orientation quaternion to a givn roll, pitch, yaw
    * @param orient the orientation to be set in terms of (roll, pitch, yaw)
    */
-  void setOrientation(const Vector3d& orient);
+  void setOrientation(const Vector3<T>& orient);
   /**
-   * @brief getOrientation calculates the current orientation in Euler angles from the internatl state
+   * @brief getOrientation returns the current orientation in Euler angles
    * @return the current orientation as (roll, pitch yaw)
    */
-  Vector3f getOrientation() const;
+  const Vector3<T>& getOrientation() const
+  {
+    return orientation_;
+  }
   /**
-   * @brief getBodyTilt calculates the body2ground rotation as RotationMatrix
+   * @brief getBodyTilt returns the body2ground rotation as RotationMatrix
    * @return the body2ground rotation as RotationMatrix
    */
-  Matrix3f getBodyTilt() const;
+  const Matrix3<T>& getBodyTilt() const
+  {
+    return bodyTilt_;
+  }
   /**
-   * @brief getAxisAngles calculates the current orientation in axis angles from the internal state
+   * @brief getAxisAngles returns the current orientation in axis angles
+   *
+   * The axis angles are only calculated on the first call after an update since they are rarely
+   * needed.
    * @return the current orientation as axis angles
    */
-  Vector3f getAxisAngles() const;
+  const Vector3<T>& getAxisAngles() const;
 
 private:
+  /// the type of the state quaternion
+  using Quaternion = Eigen::Quaternion<T>;
+
   /**
    * @brief calculateOrientation calculates the (intial) orientation from the external acceleration measurement
-   * @param extGyro the external gyro measurement
    * @param extAccel the external acceleration measurement
    */
-  void calculateOrientation(const Vector3d& extGyro, const Vector3d& extAccel);
+  void calculateOrientation(const Vector3<T>& extAccel);
   /**
    * @brief updateOrientationGyro integrates the external gyro measurement for on time step
    * @param extGyro the external gyro measurement
    * @param cycleTime the time a cycle needs run
    */
-  void updateOrientationGyro(const Vector3d& extGyro, const float cycleTime);
+  void updateOrientationGyro(const Vector3<T>& extGyro, const T cycleTime);
   /**
    * @brief updateOrientationAccel corrects the orientation with the external acceleration measurement
    * @param extAccel the external accelration measurement
+   * @param accelNorm the norm of the external acceleration measurement
    */
-  void updateOrientationAccel(const Vector3d& extAccel);
+  void updateOrientationAccel(const Vector3<T>& extAccel, const T accelNorm);
   /**
    * @brief updateGyroBias updates the internal bias model
    * @param extGyro the external gyro measurement
-   * @param extAccel the external acceleration measurement
+   * @param accelNorm the norm of the external acceleration measurement
    */
-  void updateGyroBias(const Vector3d& extGyro, const Vector3d& extAccel);
+  void updateGyroBias(const Vector3<T>& extGyro, const T accelNorm);
   /**
    * @brief checkSteadyState checks whether the current state can be considered steady
    * @param extGyro the external gyro measurement
-   * @param extAccel the external acceleration measurement
+   * @param accelNorm the norm of the external acceleration measurement
    * @return whether in steady state or not
    */
-  bool checkSteadyState(const Vector3d& extGyro, const Vector3d& extAccel);
+  bool checkSteadyState(const Vector3<T>& extGyro, const T accelNorm) const;
+  /**
+   * @brief updateOutputs calculates the orientation and body tilt from the internal state (once
+   * per update so that the getters are cheap)
+   */
+  void updateOutputs();
 
   /// whether the sensorFusion has been initialized
   bool initialized_;
@@ -91,10 +116,19 @@ private:
   const Parameter<float> angular_velocity_threshold_;
 
   /// the gyro measurement from the last round
-  Vector3d gyro_prev_;
+  Vector3<T> gyro_prev_;
   /// the current gyro bias (substracted from the gyro measurement to get rid of the drift)
-  Vector3d gyro_bias_;
+  Vector3<T> gyro_bias_;
 
   /// the internal state quaternion holding the orientation
-  Quaterniond global_to_local_;
+  Quaternion global_to_local_;
+
+  /// the current orientation as (roll, pitch, yaw)
+  Vector3<T> orientation_;
+  /// the current body2ground rotation
+  Matrix3<T> bodyTilt_;
+  /// the current orientation as axis angles (valid if axisAnglesValid_)
+  mutable Vector3<T> axisAngles_;
+  /// whether axisAngles_ has been calculated since the last update
+  mutable bool axisAnglesValid_;
 };
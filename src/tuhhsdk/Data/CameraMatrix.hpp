@@ -5,6 +5,7 @@
 
 #include "Tools/Kinematics/KinematicMatrix.h"
 #include "Tools/Math/Eigen.hpp"
+#include "Tools/Time.hpp"
 
 class CameraMatrix : public DataType<CameraMatrix>
 {
@@ -33,6 +34,75 @@ public:
   bool valid = false;
   /// the field of view of the nao
   Vector2f fov = Vector2f::Zero();
+  /// the time point for which the camera matrix has been calculated (image timestamp + offset)
+  TimePoint timestamp;
+  /// the measured time between two images of the camera in s (0 if not valid)
+  float frameDuration = 0.f;
+  /// the projection of homogeneous robot coordinates to homogeneous pixel coordinates - updated
+  /// every cycle by updateProjection
+  Matrix34f robot2pixel = Matrix34f::Zero();
+  /// the homography from homogeneous pixel coordinates to homogeneous ground coordinates - updated
+  /// every cycle by updateProjection
+  Matrix3f pixel2ground = Matrix3f::Zero();
+
+  /**
+   * @brief getRobot2PixelProjection calculates the 3x4 matrix that projects homogeneous robot
+   * coordinates to homogeneous pixel coordinates (with the pinhole model of pixelToCamera)
+   * @param cam2groundInv the transformation from robot to camera coordinates
+   * @return the projection matrix
+   */
+  Matrix34f getRobot2PixelProjection(const KinematicMatrix& cam2groundInv) const
+  {
+    return getRobot2PixelProjection(cam2groundInv.rotM.toRotationMatrix(), cam2groundInv.posV);
+  }
+  /**
+   * @brief getRobot2PixelProjection calculates the 3x4 matrix that projects homogeneous robot
+   * coordinates to homogeneous pixel coordinates (with the pinhole model of pixelToCamera)
+   * @param rotation the rotation of the transformation from robot to camera coordinates
+   * @param translation the translation of the transformation from robot to camera coordinates
+   * @return the projection matrix
+   */
+  Matrix34f getRobot2PixelProjection(const Matrix3f& rotation, const Vector3f& translation) const
+  {
+    // The x axis of the camera is the optical axis, i.e. the homogeneous component.
+    Matrix3f intrinsics;
+    intrinsics << cc.x(), -fc.x(), 0.f, cc.y(), 0.f, -fc.y(), 1.f, 0.f, 0.f;
+    Matrix34f extrinsics;
+    extrinsics << rotation, translation;
+    return intrinsics * extrinsics;
+  }
+  /**
+   * @brief getPixel2GroundHomography calculates the homography that maps homogeneous pixel
+   * coordinates to homogeneous coordinates on the plane at a given height
+   * @param projection a robot to pixel projection as returned by getRobot2PixelProjection
+   * @param z the height of the plane in robot coordinates
+   * @return the homography
+   */
+  static Matrix3f getPixel2GroundHomography(const Matrix34f& projection, const float z = 0.f)
+  {
+    Matrix3f plane2pixel;
+    plane2pixel << projection.col(0), projection.col(1), z * projection.col(2) + projection.col(3);
+    return plane2pixel.inverse();
+  }
+  /**
+   * @brief updateProjection recalculates robot2pixel and pixel2ground from camera2groundInv, fc and cc
+   */
+  void updateProjection()
+  {
+    robot2pixel = getRobot2PixelProjection(camera2groundInv);
+    pixel2ground = getPixel2GroundHomography(robot2pixel);
+  }
+  /**
+   * @brief updateProjection recalculates robot2pixel and pixel2ground from fc, cc and the given
+   * camera2groundInv (for callers that already have its rotation as matrix)
+   * @param rotation the rotation of camera2groundInv
+   * @param translation the translation of camera2groundInv
+   */
+  void updateProjection(const Matrix3f& rotation, const Vector3f& translation)
+  {
+    robot2pixel = getRobot2PixelProjection(rotation, translation);
+    pixel2ground = getPixel2GroundHomography(robot2pixel);
+  }
 
   /**
    * @brief pixelToCamera transforms pixel coordinates to camera coordinates using a pinhole camera
@@ -208,6 +278,70 @@ public:
     pixel_radius = resolution.y() * angle / (fov.y() * TO_RAD);
     return true;
   }
+  /**
+   * @brief pixelToRobot calculates the coordinates (on ground) in the robot coordinate system of a
+   * batch of pixels (equivalent to the scalar version but without rounding)
+   * @param pixels the pixel coordinates (one point per column)
+   * @param robotCoordinates the result is stored here (one point per column)
+   * @param valid whether the transformation was successful for each point
+   */
+  void pixelToRobot(const Matrix2Xf& pixels, Matrix2Xf& robotCoordinates, ArrayXb& valid) const
+  {
+    pixelToRobot(pixels, robotCoordinates, valid, pixel2ground);
+  }
+  void pixelToRobot(const Matrix2Xf& pixels, Matrix2Xf& robotCoordinates, ArrayXb& valid,
+                    const Matrix3f& pixel2groundHomography) const
+  {
+    const Matrix3Xf ground =
+        (pixel2groundHomography.leftCols<2>() * pixels).colwise() + pixel2groundHomography.col(2);
+    // If the ray is parallel to the ground, it does not intersect the ground.
+    valid = (ground.row(2).array() != 0.f).transpose() &&
+            ground.array().isFinite().colwise().all().transpose();
+    robotCoordinates = ground.topRows<2>().array().rowwise() / ground.row(2).array();
+  }
+  /**
+   * @brief robotToPixel calculates the pixel coordinates of a batch of points (on ground) in robot
+   * coordinates (equivalent to the scalar version but without rounding)
+   * @param robotCoordinates coordinates in the plane (one point per column)
+   * @param pixels the result is stored here (one point per column)
+   * @param valid whether the transformation was successful for each point
+   */
+  void robotToPixel(const Matrix2Xf& robotCoordinates, Matrix2Xf& pixels, ArrayXb& valid) const
+  {
+    robotToPixel(robotCoordinates, pixels, valid, robot2pixel);
+  }
+  void robotToPixel(const Matrix2Xf& robotCoordinates, Matrix2Xf& pixels, ArrayXb& valid,
+                    const Matrix34f& projection) const
+  {
+    const Matrix3Xf image =
+        (projection.leftCols<2>() * robotCoordinates).colwise() + projection.col(3);
+    // A position behind the camera cannot be transformed to pixel coordinates.
+    valid = (image.row(2).array() > 0.f).transpose();
+    pixels = image.topRows<2>().array().rowwise() / image.row(2).array();
+  }
+  /**
+   * @brief getPixelRadius estimates the radius in pixel coordinates that circles around a batch of
+   * points in pixel coordinates would have (equivalent to the scalar version but without rounding)
+   * @param resolution the current camera resolution in px
+   * @param pixels the points in pixel coordinates (one point per column)
+   * @param robotRadius the known radius in robot coordinates
+   * @param pixelRadii the estimated radii in pixel coordinates
+   * @param valid whether the projection was actually possible for each point
+   */
+  void getPixelRadius(const Vector2i& resolution, const Matrix2Xf& pixels, const float robotRadius,
+                      ArrayXf& pixelRadii, ArrayXb& valid) const
+  {
+    const Matrix3f pixel2plane = getPixel2GroundHomography(robot2pixel, robotRadius);
+    const Matrix3Xf plane = (pixel2plane.leftCols<2>() * pixels).colwise() + pixel2plane.col(2);
+    const ArrayXf w = plane.row(2).transpose().array();
+    // The distance is measured to the ground point below the center of the circle.
+    const ArrayXf dx = plane.row(0).transpose().array() / w - camera2ground.posV.x();
+    const ArrayXf dy = plane.row(1).transpose().array() / w - camera2ground.posV.y();
+    const float dz = camera2ground.posV.z();
+    const ArrayXf distance = (dx.square() + dy.square() + dz * dz).sqrt();
+    valid = w != 0.f && distance > robotRadius;
+    pixelRadii = (robotRadius / distance).min(1.f).asin() * (resolution.y() / (fov.y() * TO_RAD));
+  }
   /**
    * calculates the y-pixel-coordinate of the horizon in the x-th column of the image
    * @param x a x-coordinate in the image
@@ -241,6 +375,10 @@ public:
     value["horizonB"] << horizonB;
     value["valid"] << valid;
     value["fov"] << fov;
+    value["timestamp"] << timestamp;
+    value["frameDuration"] << frameDuration;
+    value["robot2pixel"] << robot2pixel;
+    value["pixel2ground"] << pixel2ground;
   }
 
   void fromValue(const Uni::Value& value) override
@@ -253,5 +391,17 @@ public:
     value["horizonB"] >> horizonB;
     value["valid"] >> valid;
     value["fov"] >> fov;
+    value["timestamp"] >> timestamp;
+    value["frameDuration"] >> frameDuration;
+    // recordings from before the projection was cached do not contain it
+    if (value.contains("robot2pixel") && value.contains("pixel2ground"))
+    {
+      value["robot2pixel"] >> robot2pixel;
+      value["pixel2ground"] >> pixel2ground;
+    }
+    else
+    {
+      updateProjection();
+    }
   }
 };
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Framework/DataType.hpp"
+#include "Tools/Storage/Image422.hpp"
+
+/**
+ * @brief ColorClassTable maps YCbCr colors to color classes with a single table lookup
+ *
+ * The table is indexed by the averaged luminance and the chroma of a pixel, quantized to
+ * yBits/chromaBits bits each. Every entry is a combination of the ColorClass bits. The table
+ * itself is owned by the producing module (ColorClassTableProvider).
+ */
+class ColorClassTable : public DataType<ColorClassTable>
+{
+public:
+  /// the name of this DataType
+  DataTypeName name = "ColorClassTable";
+
+  /// the color classes that are stored in an entry
+  enum ColorClass : std::uint8_t
+  {
+    /// the color is field color with certainty 1
+    FIELD_CERTAIN = 1 << 0,
+    /// the color is field color with certainty of at least 0.5
+    FIELD_LIKELY = 1 << 1,
+    /// at least one RGB channel of the color is saturated
+    SATURATED = 1 << 2
+  };
+
+  /// the number of bits of the luminance that are used for indexing
+  static constexpr unsigned int yBits = 5;
+  /// the number of bits of cb and cr that are used for indexing
+  static constexpr unsigned int chromaBits = 6;
+  /// the number of entries of the table
+  static constexpr std::size_t size = std::size_t(1) << (yBits + 2 * chromaBits);
+
+  /// whether the table can be used (the provider builds the first table of a camera at once)
+  bool valid = false;
+  /// the entries of the table for the current camera (size entries, nullptr if not valid)
+  const std::uint8_t* entries = nullptr;
+
+  /**
+   * @brief index computes the table index of a color
+   * @param pixel the color
+   * @return the index of the entry of the color
+   */
+  static std::size_t index(const YCbCr422& pixel)
+  {
+    return (static_cast<std::size_t>(pixel.averagedY() >> (8 - yBits)) << (2 * chromaBits)) |
+           (static_cast<std::size_t>(pixel.cb_ >> (8 - chromaBits)) << chromaBits) |
+           static_cast<std::size_t>(pixel.cr_ >> (8 - chromaBits));
+  }
+
+  /**
+   * @brief representative returns the color at the center of the cell of a table entry
+   * @param index the index of the entry
+   * @return the color that represents all colors of this entry
+   */
+  static YCbCr422 representative(const std::size_t index)
+  {
+    constexpr std::size_t chromaMask = (std::size_t(1) << chromaBits) - 1;
+    const auto y = static_cast<std::uint8_t>(((index >> (2 * chromaBits)) << (8 - yBits)) |
+                                             (1 << (7 - yBits)));
+    const auto cb = static_cast<std::uint8_t>((((index >> chromaBits) & chromaMask)
+                                               << (8 - chromaBits)) |
+                                              (1 << (7 - chromaBits)));
+    const auto cr = static_cast<std::uint8_t>(((index & chromaMask) << (8 - chromaBits)) |
+                                              (1 << (7 - chromaBits)));
+    return YCbCr422(y, cb, y, cr);
+  }
+
+  /**
+   * @brief classes returns the color classes of a color
+   * @param pixel the color
+   * @return a combination of ColorClass bits (no class as long as the table is not valid)
+   */
+  std::uint8_t classes(const YCbCr422& pixel) const
+  {
+    return valid ? entries[index(pixel)] : 0;
+  }
+
+  /**
+   * @brief fieldColor returns how certain a color is field color
+   * @param pixel the color
+   * @return the certainty as it would be returned by FieldColor::isFieldColor
+   */
+  float fieldColor(const YCbCr422& pixel) const
+  {
+    const std::uint8_t entry = classes(pixel);
+    if (entry & FIELD_CERTAIN)
+    {
+      return 1.f;
+    }
+    return (entry & FIELD_LIKELY) ? 0.5f : 0.f;
+  }
+
+  /**
+   * @brief isSaturated returns whether a color has a saturated RGB channel
+   * @param pixel the color
+   * @return true if the color is saturated
+   */
+  bool isSaturated(const YCbCr422& pixel) const
+  {
+    return classes(pixel) & SATURATED;
+  }
+
+  /**
+   * @brief reset sets the table to a defined state
+   */
+  void reset() override
+  {
+    valid = false;
+    entries = nullptr;
+  }
+
+  void toValue(Uni::Value& value) const override
+  {
+    value = Uni::Value(Uni::ValueType::OBJECT);
+    value["valid"] << valid;
+  }
+
+  void fromValue(const Uni::Value& value) override
+  {
+    value["valid"] >> valid;
+  }
+};
@@ -23,6 +23,12 @@ public:
    * @return the probability how certain the pixel is field color
    */
   std::function<float(const YCbCr422& pixel)> isFieldColor;
+  /**
+   * the revision of the isFieldColor classification of the current camera. The producing module
+   * increments it whenever the result of isFieldColor changes noticeably (e.g. because of new
+   * parameters). Consumers must only compare revisions of the same camera. It is not reset.
+   */
+  unsigned int revision = 0;
 
   /**
    * @brief reset sets the field color to a defined state
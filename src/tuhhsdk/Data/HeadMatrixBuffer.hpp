@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <vector>
 
 #include "Framework/DataType.hpp"
 #include "Tools/Kinematics/KinematicMatrix.h"
@@ -39,10 +42,70 @@ class HeadMatrixBuffer : public DataType<HeadMatrixBuffer>
 public:
   /// the name of this DataType
   DataTypeName name = "HeadMatrixBuffer";
-  /// the buffer of matrices
-  std::vector<HeadMatrixWithTimestamp> buffer;
+  /// the fixed capacity of the buffer (measurements indicate that there is never a difference of
+  /// more than 300ms between joint angles and camera image)
+  static constexpr unsigned int capacity = 30;
   /// whether the content is valid
   bool valid = true;
+  /**
+   * @brief empty returns whether there is no entry in the buffer
+   * @return true iff the buffer is empty
+   */
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+  /**
+   * @brief size returns the number of entries in the buffer
+   * @return the number of entries in the buffer
+   */
+  unsigned int size() const
+  {
+    return size_;
+  }
+  /**
+   * @brief operator[] returns an entry of the buffer in chronological order
+   * @param i the index of the entry (0 is the oldest one)
+   * @return the i-th oldest entry
+   */
+  const HeadMatrixWithTimestamp& operator[](const unsigned int i) const
+  {
+    assert(i < size_);
+    return entries_[(begin_ + i) % capacity];
+  }
+  /**
+   * @brief push appends an entry and overwrites the oldest one if the buffer is full
+   *
+   * Entries have to be pushed in chronological order. If the timeline jumps backwards, the
+   * buffer is cleared before the entry is appended.
+   *
+   * @param entry the entry to append
+   */
+  void push(const HeadMatrixWithTimestamp& entry)
+  {
+    if (size_ > 0 && entry.timestamp < (*this)[size_ - 1].timestamp)
+    {
+      clear();
+    }
+    if (size_ < capacity)
+    {
+      entries_[(begin_ + size_) % capacity] = entry;
+      size_++;
+    }
+    else
+    {
+      entries_[begin_] = entry;
+      begin_ = (begin_ + 1) % capacity;
+    }
+  }
+  /**
+   * @brief clear removes all entries from the buffer
+   */
+  void clear()
+  {
+    begin_ = 0;
+    size_ = 0;
+  }
   /**
    * @brief getBestMatch returns the head matrix that was recorded closest to a given timestamp
    * Callers must ensure that the buffer is not empty!
@@ -51,32 +114,75 @@ public:
    */
   const HeadMatrixWithTimestamp& getBestMatch(const TimePoint timestamp) const
   {
-    assert(!buffer.empty());
-    auto minIt = buffer.begin();                       // To make sure that there is a valid entry.
-    float minDiff = std::numeric_limits<float>::max(); // Those are seconds.
-    for (auto it = buffer.begin(); it != buffer.end(); it++)
+    assert(!empty());
+    const unsigned int upper = lowerBound(timestamp);
+    if (upper == 0)
     {
-      // For each element in the buffer, the difference to the searched timestamp is computed.
-      const float diff = std::abs(getTimeDiff(timestamp, it->timestamp, TDT::SECS));
-      if (diff < minDiff)
-      {
-        minIt = it;
-        minDiff = diff;
-      }
+      return (*this)[0];
     }
-    return *minIt;
+    if (upper == size_)
+    {
+      return (*this)[size_ - 1];
+    }
+    const HeadMatrixWithTimestamp& before = (*this)[upper - 1];
+    const HeadMatrixWithTimestamp& after = (*this)[upper];
+    return (timestamp - before.timestamp <= after.timestamp - timestamp) ? before : after;
   }
   /**
-   * @brief reset clears the buffer
+   * @brief getInterpolatedMatch interpolates the head matrices for a given timestamp
+   *
+   * The rotations of the two entries that enclose the timestamp are interpolated spherically, the
+   * translations linearly. Outside of the buffered time range the closest entry is returned.
+   * Callers must ensure that the buffer is not empty!
+   *
+   * @param timestamp the time for which the matrix should be interpolated
+   * @return the interpolated matrix/timepoint pair for the given timestamp
+   */
+  HeadMatrixWithTimestamp getInterpolatedMatch(const TimePoint timestamp) const
+  {
+    assert(!empty());
+    const unsigned int upper = lowerBound(timestamp);
+    if (upper == 0)
+    {
+      return (*this)[0];
+    }
+    if (upper == size_)
+    {
+      return (*this)[size_ - 1];
+    }
+    const HeadMatrixWithTimestamp& before = (*this)[upper - 1];
+    const HeadMatrixWithTimestamp& after = (*this)[upper];
+    const int interval = after.timestamp - before.timestamp;
+    if (interval <= 0)
+    {
+      return after;
+    }
+    const float alpha = static_cast<float>(timestamp - before.timestamp) / interval;
+    HeadMatrixWithTimestamp result;
+    result.head2torso = interpolate(before.head2torso, after.head2torso, alpha);
+    result.torso2ground = interpolate(before.torso2ground, after.torso2ground, alpha);
+    result.timestamp = timestamp;
+    return result;
+  }
+  /**
+   * @brief reset invalidates the buffer
+   *
+   * The entries are kept on purpose so that the provider only has to append the newest entry in
+   * each cycle instead of refilling the whole buffer.
    */
   void reset() override
   {
-    buffer.clear();
     valid = false;
   }
 
   void toValue(Uni::Value& value) const override
   {
+    std::vector<HeadMatrixWithTimestamp> buffer;
+    buffer.reserve(size_);
+    for (unsigned int i = 0; i < size_; i++)
+    {
+      buffer.push_back((*this)[i]);
+    }
     value = Uni::Value(Uni::ValueType::OBJECT);
     value["buffer"] << buffer;
     value["valid"] << valid;
@@ -84,7 +190,64 @@ public:
 
   void fromValue(const Uni::Value& value) override
   {
+    std::vector<HeadMatrixWithTimestamp> buffer;
     value["buffer"] >> buffer;
     value["valid"] >> valid;
+    // Recordings made before the buffer became a ring store the entries in ring order. push would
+    // clear the buffer at the wrap-around, so they are brought into chronological order first.
+    std::stable_sort(buffer.begin(), buffer.end(),
+                     [](const HeadMatrixWithTimestamp& a, const HeadMatrixWithTimestamp& b) {
+                       return a.timestamp < b.timestamp;
+                     });
+    clear();
+    for (const auto& entry : buffer)
+    {
+      push(entry);
+    }
+  }
+
+private:
+  /**
+   * @brief lowerBound finds the oldest entry that has not been recorded before a timestamp
+   * @param timestamp the time to search for
+   * @return the chronological index of that entry (size() if there is none)
+   */
+  unsigned int lowerBound(const TimePoint timestamp) const
+  {
+    unsigned int low = 0;
+    unsigned int high = size_;
+    while (low < high)
+    {
+      const unsigned int mid = (low + high) / 2;
+      if ((*this)[mid].timestamp < timestamp)
+      {
+        low = mid + 1;
+      }
+      else
+      {
+        high = mid;
+      }
+    }
+    return low;
   }
+  /**
+   * @brief interpolate interpolates between two kinematic matrices
+   * @param from the matrix for alpha = 0
+   * @param to the matrix for alpha = 1
+   * @param alpha the interpolation parameter in [0, 1]
+   * @return the interpolated matrix
+   */
+  static KinematicMatrix interpolate(const KinematicMatrix& from, const KinematicMatrix& to,
+                                     const float alpha)
+  {
+    const Quaternionf rotation = Quaternionf(from.rotM).slerp(alpha, Quaternionf(to.rotM));
+    return KinematicMatrix(AngleAxisf(rotation), from.posV + alpha * (to.posV - from.posV));
+  }
+
+  /// the ring of entries, begin_ points to the oldest one
+  std::array<HeadMatrixWithTimestamp, capacity> entries_;
+  /// the index of the oldest entry in entries_
+  unsigned int begin_ = 0;
+  /// the number of valid entries
+  unsigned int size_ = 0;
 };
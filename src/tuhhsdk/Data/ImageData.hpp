@@ -18,6 +18,8 @@ public:
   std::string identification;
   /// the pixel data and size as 422 image
   Image422 image422;
+  /// keeps the camera buffer behind image422 alive (nullptr if the camera does not own its buffers)
+  CameraFrameHandle frame;
   /// the system time at which the first pixel has been recorded
   TimePoint timestamp;
   /// the number of seconds that had to be waited for the image
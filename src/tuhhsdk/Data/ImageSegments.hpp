@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cassert>
 #include <list>
 #include <vector>
 
@@ -93,14 +94,11 @@ struct Scanline : public Uni::To, public Uni::From
   {
   }
 
-  // TODO Preallocate the horizontal scanlines and set the id
   // an identifier for the scanline, adjacent scanlines have sequential IDs
   int id = -1;
   // Its principal position (x coordinate for vertical scanlines and y for horizontal scanlines)
   int pos = -1;
   ScanlineType scanlineType;
-  // the segments on this scanline
-  std::vector<Segment> segments;
 
   /**
    * @see function in DataType
@@ -109,7 +107,6 @@ struct Scanline : public Uni::To, public Uni::From
   {
     value = Uni::Value(Uni::ValueType::OBJECT);
     value["id"] << id;
-    value["segments"] << segments;
     value["scanlineType"] << static_cast<int>(scanlineType);
   }
 
@@ -127,6 +124,8 @@ struct VerticalScanline : public Scanline
   }
   // the maximum y coordinate in this scanline to allow cutting out robot parts
   int yMax = -1;
+  // the segments on this scanline
+  std::vector<Segment> segments;
 
   /**
    * @see function in DataType
@@ -135,6 +134,7 @@ struct VerticalScanline : public Scanline
   {
     value = Uni::Value(Uni::ValueType::OBJECT);
     Scanline::toValue(value);
+    value["segments"] << segments;
     value["yMax"] << yMax;
   }
 
@@ -144,6 +144,53 @@ struct VerticalScanline : public Scanline
   virtual void fromValue(const Uni::Value& /*value*/) {}
 };
 
+/**
+ * @brief a contiguous range of segments that can be iterated like a container
+ */
+template <typename T>
+class SegmentSpan
+{
+public:
+  SegmentSpan(T* first, std::size_t size)
+    : first_(first)
+    , size_(size)
+  {
+  }
+
+  T* begin() const
+  {
+    return first_;
+  }
+  T* end() const
+  {
+    return first_ + size_;
+  }
+  std::size_t size() const
+  {
+    return size_;
+  }
+  bool empty() const
+  {
+    return size_ == 0;
+  }
+  T& operator[](std::size_t i) const
+  {
+    return first_[i];
+  }
+  T& front() const
+  {
+    return first_[0];
+  }
+  T& back() const
+  {
+    return first_[size_ - 1];
+  }
+
+private:
+  T* first_;
+  std::size_t size_;
+};
+
 struct HorizontalScanline : public Scanline
 {
   HorizontalScanline()
@@ -151,6 +198,10 @@ struct HorizontalScanline : public Scanline
   {
   }
   Vector2i step;
+  // the index of the first segment of this scanline in ImageSegments::horizontalSegments
+  std::size_t segmentOffset = 0;
+  // the number of segments on this scanline
+  std::size_t segmentCount = 0;
   /**
    * @see function in DataType
    */
@@ -158,13 +209,25 @@ struct HorizontalScanline : public Scanline
   {
     value = Uni::Value(Uni::ValueType::OBJECT);
     Scanline::toValue(value);
+    value["pos"] << pos;
     value["step"] << step;
+    value["segmentOffset"] << static_cast<int>(segmentOffset);
+    value["segmentCount"] << static_cast<int>(segmentCount);
   }
 
   /**
    * @see function in DataType
    */
-  virtual void fromValue(const Uni::Value& /*value*/) {}
+  virtual void fromValue(const Uni::Value& value)
+  {
+    int valueRead = 0;
+    value["pos"] >> pos;
+    value["step"] >> step;
+    value["segmentOffset"] >> valueRead;
+    segmentOffset = static_cast<std::size_t>(valueRead);
+    value["segmentCount"] >> valueRead;
+    segmentCount = static_cast<std::size_t>(valueRead);
+  }
 };
 
 class ImageSegments : public DataType<ImageSegments>
@@ -173,7 +236,15 @@ public:
   /// the name of this DataType
   DataTypeName name = "ImageSegments";
   std::vector<VerticalScanline> verticalScanlines;
+  /// the horizontal scanlines, their segments are stored in horizontalSegments
   std::vector<HorizontalScanline> horizontalScanlines;
+  /**
+   * @brief The segments of all horizontal scanlines, stored contiguously in scanline order.
+   *
+   * Each scanline references its part of this arena by offset and count. The arena is only
+   * cleared on reset, so its capacity is kept across cycles.
+   */
+  std::vector<Segment> horizontalSegments;
   // TODO: Think about the single valid boolean. Probably split it up for vertical and horizontal
   // scanlines.
   bool valid = false;
@@ -187,7 +258,7 @@ public:
    * @brief Lookup table for (horizontal) scanline distances.
    *
    * Contains a step of approx. 3cm on the worlds ground for every camera and image row, given the
-   * {@link cam2Ground_}.
+   * (quantized) pose of the camera that took the current image.
    */
   std::array<std::vector<Vector2i>, 2> scanGrids;
 
@@ -216,7 +287,27 @@ public:
     reinitialized = true;
   }
 
-  // TODO: Prealocation (init) for horizontal scanlines
+  /**
+   * @brief getSegments returns the segments of a horizontal scanline
+   * @param scanline a horizontal scanline of this datum
+   * @return the contiguous range of segments on that scanline
+   */
+  SegmentSpan<const Segment> getSegments(const HorizontalScanline& scanline) const
+  {
+    assert(scanline.segmentOffset + scanline.segmentCount <= horizontalSegments.size());
+    return {horizontalSegments.data() + scanline.segmentOffset, scanline.segmentCount};
+  }
+
+  /**
+   * @brief getSegments returns the mutable segments of a horizontal scanline
+   * @param scanline a horizontal scanline of this datum
+   * @return the contiguous range of segments on that scanline
+   */
+  SegmentSpan<Segment> getSegments(const HorizontalScanline& scanline)
+  {
+    assert(scanline.segmentOffset + scanline.segmentCount <= horizontalSegments.size());
+    return {horizontalSegments.data() + scanline.segmentOffset, scanline.segmentCount};
+  }
 
   /**
    * @brief reset clears all the vectors
@@ -231,7 +322,9 @@ public:
       scanline.segments.clear();
       scanline.yMax = imageSize.y() - 1;
     }
+    // clear keeps the capacity, so the arena does not need to be reallocated in every cycle
     horizontalScanlines.clear();
+    horizontalSegments.clear();
   }
 
   /**
@@ -242,6 +335,7 @@ public:
     value = Uni::Value(Uni::ValueType::OBJECT);
     value["verticalScanlines"] << verticalScanlines;
     value["horizontalScanlines"] << horizontalScanlines;
+    value["horizontalSegments"] << horizontalSegments;
     value["valid"] << valid;
   }
 
@@ -252,6 +346,7 @@ public:
   {
     value["verticalScanlines"] >> verticalScanlines;
     value["horizontalScanlines"] >> horizontalScanlines;
+    value["horizontalSegments"] >> horizontalSegments;
     value["valid"] >> valid;
   }
 };
@@ -61,6 +61,7 @@ public:
   {
     jointAngles.fill(0);
     headMatrixBuffer.reset();
+    headMatrixBuffer.clear();
     sonarDist.fill(-1.f);
     sonarValid.fill(false);
     fsrLeft.fill(0);
@@ -75,7 +76,12 @@ public:
   void fromValue(const Uni::Value& value) override
   {
     saveDeserial(value, "jointAngles", [](auto& v) { v.fill(0); }, jointAngles);
-    saveDeserial(value, "headMatrixBuffer", [](auto& v) { v.reset(); }, headMatrixBuffer);
+    saveDeserial(value, "headMatrixBuffer",
+                 [](auto& v) {
+                   v.reset();
+                   v.clear();
+                 },
+                 headMatrixBuffer);
     saveDeserial(value, "sonarDist", [](auto& v) { v.fill(-1.f); }, sonarDist);
     saveDeserial(value, "sonarValid", [](auto& v) { v.fill(false); }, sonarValid);
     saveDeserial(value, "fsrLeft", [](auto& v) { v.fill(0); }, fsrLeft);
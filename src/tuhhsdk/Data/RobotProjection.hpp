@@ -3,6 +3,7 @@
 #include "Framework/DataType.hpp"
 #include "Tools/Math/Line.hpp"
 
+#include <algorithm>
 #include <vector>
 
 class RobotProjection : public DataType<RobotProjection>
@@ -10,47 +11,71 @@ class RobotProjection : public DataType<RobotProjection>
 public:
   /// the name of this DataType
   DataTypeName name = "RobotProjection";
+  /// the projected outline of the robot (422 coordinates)
   std::vector<Line<int>> lines;
+  /**
+   * the first row (422 coordinates) of each image column from which on all pixels are on the robot
+   * (std::numeric_limits<int>::max() if no pixel of the column is on the robot)
+   */
+  std::vector<int> firstRowOnRobot;
 
   void reset() override
   {
     lines.clear();
+    firstRowOnRobot.clear();
+  }
+
+  /**
+   * @brief isBelowLine checks whether a pixel is covered by the robot part below a line
+   * @param line a line of the outline
+   * @param pos pixel position
+   * @return whether the given pixel is below the line
+   */
+  static bool isBelowLine(const Line<int>& line, const Vector2i& pos)
+  {
+    const int minX = std::min(line.p1.x(), line.p2.x());
+    if (minX > pos.x())
+    {
+      return false;
+    }
+    const int maxX = std::max(line.p1.x(), line.p2.x());
+    if (maxX < pos.x())
+    {
+      return false;
+    }
+    const int minY = std::min(line.p1.y(), line.p2.y());
+    if (minY > pos.y())
+    {
+      return false;
+    }
+    const int maxY = std::max(line.p1.y(), line.p2.y());
+    if (maxY < pos.y())
+    {
+      return true;
+    }
+    const float crossProduct =
+        static_cast<float>(line.p2.x() - line.p1.x()) * (line.p2.y() - pos.y()) -
+        (line.p2.y() - line.p1.y()) * (line.p2.x() - pos.x());
+    const float sign = line.p1.x() < line.p2.x() ? 1.f : -1.f;
+    return sign * crossProduct < 0.f;
   }
 
   /*
    * @brief Checks whether a pixel is on the own robot
+   *
+   * This is a single lookup for pixels in the image columns of firstRowOnRobot.
    * @param pos pixel position
    * @return whether the given pixel is on the robot
    */
   bool isOnRobot(const Vector2i& pos) const
   {
+    if (pos.x() >= 0 && static_cast<std::size_t>(pos.x()) < firstRowOnRobot.size())
+    {
+      return pos.y() >= firstRowOnRobot[pos.x()];
+    }
     for (auto& line : lines)
     {
-      const int minX = std::min(line.p1.x(), line.p2.x());
-      if (minX > pos.x())
-      {
-        continue;
-      }
-      const int maxX = std::max(line.p1.x(), line.p2.x());
-      if (maxX < pos.x())
-      {
-        continue;
-      }
-      const int minY = std::min(line.p1.y(), line.p2.y());
-      if (minY > pos.y())
-      {
-        continue;
-      }
-      const int maxY = std::max(line.p1.y(), line.p2.y());
-      if (maxY < pos.y())
-      {
-        return true;
-      }
-      const float crossProduct =
-          static_cast<float>(line.p2.x() - line.p1.x()) * (line.p2.y() - pos.y()) -
-          (line.p2.y() - line.p1.y()) * (line.p2.x() - pos.x());
-      const float sign = line.p1.x() < line.p2.x() ? 1.f : -1.f;
-      if (sign * crossProduct < 0.f)
+      if (isBelowLine(line, pos))
       {
         return true;
       }
@@ -4,6 +4,7 @@
 #include <functional>
 #include <vector>
 
+#include "Definitions/DevilSmashStandardMessage.hpp"
 #include "Definitions/SPLStandardMessage.h"
 #include "Framework/DataType.hpp"
 #include "Modules/Debug/Debug.h"
@@ -13,8 +14,26 @@
 class SPLNetworkData : public DataType<SPLNetworkData>
 {
 public:
+  /**
+   * @brief IncomingMessage is a team message that has already been checked and decoded by the
+   * network thread
+   */
   struct IncomingMessage
   {
+    /// the state of the DevilSmash message at the beginning of the data field
+    enum class DSMessageStatus
+    {
+      /// the DevilSmash message has been decoded
+      VALID,
+      /// the data field is empty
+      MISSING,
+      /// the data field is too small for a DevilSmash message
+      TRUNCATED,
+      /// the DevilSmash message could not be decoded
+      MALFORMED
+    };
+
+    IncomingMessage() = default;
     /**
      * @brief IncomingMessage initializes all fields of this struct
      *
@@ -36,6 +55,10 @@ public:
     TimePoint receiveTimePoint;
     /// The origin of this message
     boost::asio::ip::address senderAddr;
+    /// the state of dsMsg
+    DSMessageStatus dsMsgStatus = DSMessageStatus::MISSING;
+    /// the DevilSmash message that has been decoded from stdMsg.data (only if dsMsgStatus is VALID)
+    DevilSmash::StandardMessage dsMsg;
   };
 
   /// the name of this DataType
@@ -1,5 +1,6 @@
 #include "DevilSmashStandardMessage.hpp"
 
+#include <cmath>
 #include <cstring>
 
 namespace DevilSmash
@@ -54,6 +55,261 @@ namespace DevilSmash
     return value;
   }
 
+  /**
+   * @brief BitWriter appends values with an arbitrary number of bits to a data field
+   *
+   * The bits are stored LSB first, i.e. the first value occupies the lowest bits of the first byte.
+   */
+  class BitWriter
+  {
+  public:
+    /**
+     * @brief BitWriter initializes members
+     * @param data the data field to write to
+     */
+    explicit BitWriter(void* data)
+      : data_(static_cast<uint8_t*>(data))
+    {
+    }
+
+    /**
+     * @brief write appends a value
+     * @param value the value (must fit into bits)
+     * @param bits the number of bits [0..32]
+     */
+    void write(uint32_t value, unsigned int bits)
+    {
+      assert(bits <= 32 && (static_cast<uint64_t>(value) >> bits) == 0);
+      buffer_ |= static_cast<uint64_t>(value) << bufferedBits_;
+      bufferedBits_ += bits;
+      while (bufferedBits_ >= 8)
+      {
+        *data_++ = static_cast<uint8_t>(buffer_);
+        buffer_ >>= 8;
+        bufferedBits_ -= 8;
+      }
+    }
+
+    /**
+     * @brief flush writes the remaining bits padded with zeros to a full byte
+     */
+    void flush()
+    {
+      if (bufferedBits_ > 0)
+      {
+        *data_++ = static_cast<uint8_t>(buffer_);
+        buffer_ = 0;
+        bufferedBits_ = 0;
+      }
+    }
+
+  private:
+    /// the next byte of the data field
+    uint8_t* data_;
+    /// bits that do not form a full byte yet
+    uint64_t buffer_ = 0;
+    /// the number of bits in the buffer [0..7] between two calls
+    unsigned int bufferedBits_ = 0;
+  };
+
+  /**
+   * @brief BitReader reads values that have been written by a BitWriter
+   *
+   * Every value is extracted from a 64 bit word that is loaded at the byte of its first bit. The
+   * values do not depend on each other (unlike with a shifted bit buffer), so consecutive reads
+   * can be executed in parallel. Reading beyond the size of the data field returns zeros and marks
+   * the reader as overrun.
+   */
+  class BitReader
+  {
+  public:
+    /**
+     * @brief BitReader initializes members
+     * @param data the data field to read from
+     * @param size the number of bytes that may be read
+     */
+    BitReader(const void* data, std::size_t size)
+      : data_(static_cast<const uint8_t*>(data))
+      , size_(size)
+    {
+    }
+
+    /**
+     * @brief read extracts the next value
+     * @param bits the number of bits of the value [0..32]
+     * @return the value
+     */
+    uint32_t read(unsigned int bits)
+    {
+      assert(bits <= 32);
+      const std::size_t byte = bitsRead_ / 8;
+      uint64_t word = 0;
+      if (byte + sizeof(word) <= size_)
+      {
+        // Like readVal, this relies on a little endian host.
+        std::memcpy(&word, data_ + byte, sizeof(word));
+      }
+      else
+      {
+        for (std::size_t i = byte; i < size_; i++)
+        {
+          word |= static_cast<uint64_t>(data_[i]) << (8 * (i - byte));
+        }
+      }
+      const auto value =
+          static_cast<uint32_t>((word >> (bitsRead_ % 8)) & ((uint64_t(1) << bits) - 1));
+      bitsRead_ += bits;
+      return value;
+    }
+
+    /**
+     * @brief overrun returns whether a read needed more bytes than available
+     * @return true if the data field was too small
+     */
+    bool overrun() const
+    {
+      return bitsRead_ > 8 * size_;
+    }
+
+    /**
+     * @brief bytesRead returns the number of bytes that have been consumed (including padding bits)
+     * @return the number of bytes
+     */
+    std::size_t bytesRead() const
+    {
+      return (bitsRead_ + 7) / 8;
+    }
+
+  private:
+    /// the data field
+    const uint8_t* data_;
+    /// the number of bytes that may be read
+    const std::size_t size_;
+    /// the number of bits that have been returned
+    std::size_t bitsRead_ = 0;
+  };
+
+  /**
+   * @brief QuantizedField describes how a float is streamed in the packed version
+   *
+   * Values are rounded to multiples of quantum and clamped to [min..min + quantum * (2^bits - 1)].
+   */
+  struct QuantizedField
+  {
+    /// the smallest value that can be streamed
+    float min;
+    /// the precision of the value
+    float quantum;
+    /// the number of bits of the value
+    unsigned int bits;
+
+    uint32_t encode(float value) const
+    {
+      const auto maxCode = static_cast<float>((uint64_t(1) << bits) - 1);
+      // NaN is mapped to the smallest value.
+      const float code = std::round((value - min) / quantum);
+      return static_cast<uint32_t>(std::max(0.f, std::min(code, maxCode)));
+    }
+
+    float decode(uint32_t code) const
+    {
+      return min + static_cast<float>(code) * quantum;
+    }
+  };
+
+  /**
+   * @brief DeltaField describes how a time relative to the message timestamp is streamed in the
+   * packed version
+   *
+   * The delta is rounded to multiples of quantum. The largest code marks a delta that is too large
+   * to be streamed, each field defines what this means.
+   */
+  struct DeltaField
+  {
+    /// the precision in ms
+    uint32_t quantum;
+    /// the number of bits of the value
+    unsigned int bits;
+
+    uint32_t maxCode() const
+    {
+      return static_cast<uint32_t>((uint64_t(1) << bits) - 1);
+    }
+
+    uint32_t encode(uint32_t delta) const
+    {
+      const uint64_t code = (static_cast<uint64_t>(delta) + quantum / 2) / quantum;
+      return static_cast<uint32_t>(std::min<uint64_t>(code, maxCode()));
+    }
+
+    uint32_t decode(uint32_t code) const
+    {
+      return code * quantum;
+    }
+  };
+
+  /**
+   * @brief the schema of the packed version
+   *
+   * The values are streamed in the order of this namespace after the message length.
+   */
+  namespace PackedSchema
+  {
+    /// the number of bytes after the version [0..511]
+    constexpr unsigned int lengthBits = 9;
+    constexpr unsigned int timestampBits = 32;
+    /// [-128..126 deg (2 deg)]
+    constexpr QuantizedField headYawAngle{-128.f * pi / 180.f, 2.f * pi / 180.f, 7};
+    /// [delta 0..254 (128ms)], the largest code means "long ago" like in the byte aligned version
+    constexpr DeltaField timestampLastJumped{128, 8};
+    /// [delta 0..65504 (16ms)], the largest code means "not in the near future"
+    constexpr DeltaField timeWhenReachBall{16, 12};
+    /// same as timeWhenReachBall, but never streamed with the largest code
+    constexpr DeltaField timeWhenReachBallStriker{16, 12};
+    /// [delta 0..65520 (8ms)] time before msg timestamp, the largest code is decoded as 0
+    constexpr DeltaField timeWhenBallLastSeen{8, 13};
+    /// [-8192..8184 (8mm/s)]
+    constexpr QuantizedField ballVelocity{-8192.f, 8.f, 11};
+    /// [0..1 (1/15)]
+    constexpr QuantizedField ballValidity{0.f, 1.f / 15.f, 4};
+    /// [delta 0..65504 (16ms)] time before msg timestamp, the largest code is decoded as 0
+    constexpr DeltaField lastTimeWhistleDetected{16, 12};
+    /// the bits of GameStateStruct::toBits
+    constexpr unsigned int gameStateBits = 13;
+    /// per role (currentlyPerformingRole and roleAssignments)
+    constexpr unsigned int roleBits = 4;
+    /// member, isPenalized, isRobotPoseValid, requestsNTPMessage
+    constexpr unsigned int flagBits = 4;
+    /// [0..DS_STANDARD_MESSAGE_MAX_ROBOTS_IN_MAP]
+    constexpr unsigned int robotCountBits = 4;
+    /// [-6400..6387.5 mm (12.5mm)]
+    constexpr QuantizedField robotPosition{-6400.f, 12.5f, 10};
+    constexpr unsigned int robotTypeBits = 2;
+    /// one bit per receiving player
+    constexpr unsigned int ntpReceiverBits = DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS;
+    constexpr unsigned int ntpOriginationBits = 32;
+    /// [delta 0..0xFFFF] like in the byte aligned version
+    constexpr unsigned int ntpReceiptBits = 16;
+
+    constexpr unsigned int fixedBits =
+        lengthBits + timestampBits + headYawAngle.bits + timestampLastJumped.bits +
+        timeWhenReachBall.bits + timeWhenReachBallStriker.bits + timeWhenBallLastSeen.bits +
+        2 * ballVelocity.bits + ballValidity.bits + lastTimeWhistleDetected.bits + gameStateBits +
+        (1 + DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS) * roleBits + flagBits + robotCountBits +
+        ntpReceiverBits;
+    constexpr unsigned int bitsPerRobot = 2 * robotPosition.bits + robotTypeBits;
+    constexpr unsigned int bitsPerNTPMessage = ntpOriginationBits + ntpReceiptBits;
+
+    static_assert(DS_STANDARD_MESSAGE_MAX_ROBOTS_IN_MAP < (1 << robotCountBits),
+                  "The robot count does not fit into its bits");
+    static_assert(static_cast<unsigned int>(Role::MAX) < (1 << roleBits),
+                  "The roles do not fit into their bits");
+    static_assert(static_cast<unsigned int>(RobotMap::Robot::Type::MAX) < (1 << robotTypeBits),
+                  "The robot types do not fit into their bits");
+    static_assert(GameStateStruct::KICKING_TEAM_BITS < (1 << gameStateBits),
+                  "The game state does not fit into its bits");
+  } // namespace PackedSchema
+
   int RobotMap::sizeOf() const
   {
     // since the robot type will be serialized into 2 bits per robot (2 * 16 = 32)
@@ -83,7 +339,7 @@ namespace DevilSmash
     writeVal<uint32_t>(data, robotTypeContainer);
   }
 
-  void RobotMap::read(const void*& data)
+  bool RobotMap::read(const void*& data)
   {
     map.clear();
 
@@ -102,13 +358,17 @@ namespace DevilSmash
     for (auto it = map.rbegin(); it != map.rend(); it++)
     {
       it->type = static_cast<Robot::Type>(robotTypeContainer & 3u);
-      assert(it->type != Robot::Type::MAX);
+      if (it->type == Robot::Type::MAX)
+      {
+        return false;
+      }
       robotTypeContainer >>= 2u;
     }
+    return true;
   }
 
 
-  void GameStateStruct::write(void*& data) const
+  uint16_t GameStateStruct::toBits() const
   {
     const uint16_t setPlayBytes = (setPlay << SET_PLAY_POS) & SET_PLAY_BITS;
     const uint16_t gameStateBytes = (gameState << GAME_STATE_POS) & GAME_STATE_BITS;
@@ -122,20 +382,29 @@ namespace DevilSmash
     const uint16_t kickingTeamBytes =
         (static_cast<uint16_t>(kickingTeam) << KICKING_TEAM_POS) & KICKING_TEAM_BITS;
 
-    writeVal<uint16_t>(data, setPlayBytes | gameStateBytes | gamePhaseBytes | competitionTypeBytes |
-                                 competitionPhaseBytes | firstHalfBytes | kickingTeamBytes);
+    return setPlayBytes | gameStateBytes | gamePhaseBytes | competitionTypeBytes |
+           competitionPhaseBytes | firstHalfBytes | kickingTeamBytes;
+  }
+
+  void GameStateStruct::fromBits(const uint16_t stateBits)
+  {
+    setPlay = (stateBits & SET_PLAY_BITS) >> SET_PLAY_POS;
+    gameState = (stateBits & GAME_STATE_BITS) >> GAME_STATE_POS;
+    gamePhase = (stateBits & GAME_PHASE_BITS) >> GAME_PHASE_POS;
+    competitionType = (stateBits & COMPETITION_TYPE_BITS) >> COMPETITION_TYPE_POS;
+    competitionPhase = (stateBits & COMPETITION_PHASE_BITS) >> COMPETITION_PHASE_POS;
+    firstHalf = (stateBits & FIRST_HALF_BITS) >> FIRST_HALF_POS;
+    kickingTeam = (stateBits & KICKING_TEAM_BITS) >> KICKING_TEAM_POS;
+  }
+
+  void GameStateStruct::write(void*& data) const
+  {
+    writeVal<uint16_t>(data, toBits());
   }
 
   void GameStateStruct::read(const void*& data)
   {
-    auto stateBytes = readVal<uint16_t>(data);
-    setPlay = (stateBytes & SET_PLAY_BITS) >> SET_PLAY_POS;
-    gameState = (stateBytes & GAME_STATE_BITS) >> GAME_STATE_POS;
-    gamePhase = (stateBytes & GAME_PHASE_BITS) >> GAME_PHASE_POS;
-    competitionType = (stateBytes & COMPETITION_TYPE_BITS) >> COMPETITION_TYPE_POS;
-    competitionPhase = (stateBytes & COMPETITION_PHASE_BITS) >> COMPETITION_PHASE_POS;
-    firstHalf = (stateBytes & FIRST_HALF_BITS) >> FIRST_HALF_POS;
-    kickingTeam = (stateBytes & KICKING_TEAM_BITS) >> KICKING_TEAM_POS;
+    fromBits(readVal<uint16_t>(data));
   }
 
   void NTPMessage::write(void*& data, uint32_t timestamp) const
@@ -198,9 +467,15 @@ namespace DevilSmash
 
   int StandardMessage::sizeOfDSMessage() const
   {
-    static_assert(DS_STANDARD_MESSAGE_STRUCT_VERSION == 5,
-                  "Message version mismatch in StandardMessage sizeOfDSMessage()");
+    assert(version == DS_STANDARD_MESSAGE_STRUCT_VERSION ||
+           version == DS_STANDARD_MESSAGE_PACKED_VERSION);
+    return version == DS_STANDARD_MESSAGE_PACKED_VERSION ? sizeOfPacked() : sizeOfByteAligned();
+  }
 
+  int StandardMessage::sizeOfByteAligned() const
+  {
+    static_assert(DS_STANDARD_MESSAGE_STRUCT_VERSION == 5,
+                  "Message version mismatch in StandardMessage sizeOfByteAligned()");
     // clang-format off
     return sizeof(header) + sizeof(version) + sizeof(timestamp)
            + 2 // message length (not a member of this struct)
@@ -221,17 +496,28 @@ namespace DevilSmash
     // clang-format on
   }
 
-  bool StandardMessage::read(const void* data)
+  int StandardMessage::sizeOfPacked() const
   {
-    static_assert(DS_STANDARD_MESSAGE_STRUCT_VERSION == 5,
-                  "Message version mismatch in StandardMessage read()");
-
-#ifndef NDEBUG
-    const void* const begin = data; // For length check
-#endif
+    static_assert(DS_STANDARD_MESSAGE_PACKED_VERSION == 6,
+                  "Message version mismatch in StandardMessage sizeOfPacked()");
+
+    const auto robotsInMap =
+        std::min(static_cast<int>(robotMap.map.size()), DS_STANDARD_MESSAGE_MAX_ROBOTS_IN_MAP);
+    const unsigned int bits = PackedSchema::fixedBits + robotsInMap * PackedSchema::bitsPerRobot +
+                              static_cast<unsigned int>(ntpMessages.size()) *
+                                  PackedSchema::bitsPerNTPMessage;
+    return sizeOfHeader() + static_cast<int>((bits + 7) / 8);
+  }
 
+  bool StandardMessage::read(const void* data, const std::size_t size)
+  {
     ntpMessages.clear();
 
+    if (size < static_cast<std::size_t>(sizeOfHeader()))
+    {
+      return false;
+    }
+
     // check header
     for (unsigned int i = 0; i < sizeof(header); i++)
     {
@@ -242,14 +528,39 @@ namespace DevilSmash
     }
 
     // check version
-    version = readVal<decltype(version)>(data);
-    if (version != DS_STANDARD_MESSAGE_STRUCT_VERSION)
+    const auto receivedVersion = readVal<decltype(version)>(data);
+    if (receivedVersion == DS_STANDARD_MESSAGE_STRUCT_VERSION)
     {
-      return false;
+      version = receivedVersion;
+      return readByteAligned(data, size - sizeOfHeader());
+    }
+    if (receivedVersion == DS_STANDARD_MESSAGE_PACKED_VERSION)
+    {
+      version = receivedVersion;
+      return readPacked(data, size - sizeOfHeader());
     }
+    return false;
+  }
+
+  bool StandardMessage::readByteAligned(const void* data, const std::size_t size)
+  {
+    static_assert(DS_STANDARD_MESSAGE_STRUCT_VERSION == 5,
+                  "Message version mismatch in StandardMessage readByteAligned()");
 
     const void* const payloadBegin = data; // For length check
 
+    // Everything up to the robot map has a fixed size. The sizes of the robot map and the NTP
+    // messages are checked before they are read.
+    RobotMap emptyRobotMap;
+    const auto fixedSize = static_cast<std::size_t>(sizeOfByteAligned() - sizeOfHeader() -
+                                                    robotMap.sizeOf() + emptyRobotMap.sizeOf() -
+                                                    static_cast<int>(ntpMessages.size()) *
+                                                        NTPMessage::sizeOf());
+    if (size < fixedSize)
+    {
+      return false;
+    }
+
     const auto length = readVal<uint16_t>(data);
 
     timestamp = readVal<decltype(timestamp)>(data);
@@ -281,15 +592,37 @@ namespace DevilSmash
 
     auto boolContainer = readVal<uint8_t>(data);
     // according to write() there must not be more than 4 bools in here.
-    assert((boolContainer & 0b11110000) == 0);
+    if ((boolContainer & 0b11110000) != 0)
+    {
+      return false;
+    }
     requestsNTPMessage = (boolContainer & 1u) > 0;
     isRobotPoseValid = ((boolContainer >>= 1u) & 1u) > 0;
     isPenalized = ((boolContainer >>= 1u) & 1u) > 0;
     member = static_cast<decltype(member)>((boolContainer >>= 1u) & 1u);
 
-    robotMap.read(data);
+    const auto robotsInMap = *static_cast<const uint8_t*>(data);
+    if (robotsInMap > DS_STANDARD_MESSAGE_MAX_ROBOTS_IN_MAP ||
+        size < fixedSize + 4 * static_cast<std::size_t>(robotsInMap))
+    {
+      return false;
+    }
+    if (!robotMap.read(data))
+    {
+      return false;
+    }
 
     const auto ntpReceiverContainer = readVal<uint8_t>(data);
+    unsigned int numberOfNTPMessages = 0;
+    for (uint8_t i = 0; i < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS; i++)
+    {
+      numberOfNTPMessages += (ntpReceiverContainer >> i) & 1u;
+    }
+    if (size < fixedSize + 4 * static_cast<std::size_t>(robotsInMap) +
+                   numberOfNTPMessages * NTPMessage::sizeOf())
+    {
+      return false;
+    }
     for (uint8_t i = 0; i < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS; i++)
     {
       if ((ntpReceiverContainer & (1u << i)) > 0)
@@ -303,28 +636,133 @@ namespace DevilSmash
       }
     }
 
-    assert((reinterpret_cast<const char*>(data) - reinterpret_cast<const char*>(begin)) ==
-           sizeOfDSMessage());
+    assert((reinterpret_cast<const char*>(data) - reinterpret_cast<const char*>(payloadBegin)) ==
+           sizeOfByteAligned() - sizeOfHeader());
 
     return (reinterpret_cast<const char*>(data) - reinterpret_cast<const char*>(payloadBegin)) ==
            length;
   }
 
-  void StandardMessage::write(void* data)
+  bool StandardMessage::readPacked(const void* data, const std::size_t size)
   {
-    static_assert(DS_STANDARD_MESSAGE_STRUCT_VERSION == 5,
-                  "Message version mismatch in StandardMessage write()");
+    static_assert(DS_STANDARD_MESSAGE_PACKED_VERSION == 6,
+                  "Message version mismatch in StandardMessage readPacked()");
 
-#ifndef NDEBUG
-    const void* const begin = data; // For length check
-#endif
+    BitReader reader(data, size);
+    const auto length = reader.read(PackedSchema::lengthBits);
+    if (length > size)
+    {
+      return false;
+    }
+
+    timestamp = reader.read(PackedSchema::timestampBits);
+    headYawAngle = PackedSchema::headYawAngle.decode(reader.read(PackedSchema::headYawAngle.bits));
+
+    const auto jumpedDelta = PackedSchema::timestampLastJumped.decode(
+        reader.read(PackedSchema::timestampLastJumped.bits));
+    timestampLastJumped = timestamp - std::min(timestamp, jumpedDelta);
+    timeWhenReachBall = timestamp + PackedSchema::timeWhenReachBall.decode(
+                                        reader.read(PackedSchema::timeWhenReachBall.bits));
+    timeWhenReachBallStriker =
+        timestamp + PackedSchema::timeWhenReachBallStriker.decode(
+                        reader.read(PackedSchema::timeWhenReachBallStriker.bits));
+    const auto ballSeenCode = reader.read(PackedSchema::timeWhenBallLastSeen.bits);
+    const auto ballSeenDelta = PackedSchema::timeWhenBallLastSeen.decode(ballSeenCode);
+    timeWhenBallLastSeen = ballSeenCode == PackedSchema::timeWhenBallLastSeen.maxCode()
+                               ? 0
+                               : timestamp - std::min(timestamp, ballSeenDelta);
+    for (auto& velocity : ballVelocity)
+    {
+      velocity = PackedSchema::ballVelocity.decode(reader.read(PackedSchema::ballVelocity.bits));
+    }
+    ballValidity = PackedSchema::ballValidity.decode(reader.read(PackedSchema::ballValidity.bits));
+    const auto whistleCode = reader.read(PackedSchema::lastTimeWhistleDetected.bits);
+    const auto whistleDelta = PackedSchema::lastTimeWhistleDetected.decode(whistleCode);
+    lastTimeWhistleDetected = whistleCode == PackedSchema::lastTimeWhistleDetected.maxCode()
+                                  ? 0
+                                  : timestamp - std::min(timestamp, whistleDelta);
+
+    gameState.fromBits(static_cast<uint16_t>(reader.read(PackedSchema::gameStateBits)));
+
+    currentlyPerformingRole = static_cast<Role>(reader.read(PackedSchema::roleBits));
+    for (unsigned int player = 0; player < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS; player++)
+    {
+      roleAssignments[player] = static_cast<Role>(reader.read(PackedSchema::roleBits));
+    }
+
+    member = static_cast<decltype(member)>(reader.read(1));
+    isPenalized = reader.read(1) > 0;
+    isRobotPoseValid = reader.read(1) > 0;
+    requestsNTPMessage = reader.read(1) > 0;
+
+    const auto robotsInMap = reader.read(PackedSchema::robotCountBits);
+    if (robotsInMap > DS_STANDARD_MESSAGE_MAX_ROBOTS_IN_MAP)
+    {
+      return false;
+    }
+    robotMap.map.resize(robotsInMap);
+    for (auto& robot : robotMap.map)
+    {
+      robot.x = PackedSchema::robotPosition.decode(reader.read(PackedSchema::robotPosition.bits));
+      robot.y = PackedSchema::robotPosition.decode(reader.read(PackedSchema::robotPosition.bits));
+      robot.type = static_cast<RobotMap::Robot::Type>(reader.read(PackedSchema::robotTypeBits));
+      if (robot.type == RobotMap::Robot::Type::MAX)
+      {
+        return false;
+      }
+    }
+
+    const auto ntpReceiverContainer = reader.read(PackedSchema::ntpReceiverBits);
+    for (uint8_t i = 0; i < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS; i++)
+    {
+      if ((ntpReceiverContainer & (1u << i)) > 0)
+      {
+        NTPMessage msg;
+        msg.receiver = i + 1;
+        msg.requestOrigination = reader.read(PackedSchema::ntpOriginationBits);
+        msg.requestReceipt = timestamp - reader.read(PackedSchema::ntpReceiptBits);
+        ntpMessages.emplace_back(msg);
+      }
+    }
+
+    return !reader.overrun() && reader.bytesRead() == length &&
+           static_cast<int>(length) == sizeOfPacked() - sizeOfHeader();
+  }
+
+  void StandardMessage::write(void* data)
+  {
+    assert(version == DS_STANDARD_MESSAGE_STRUCT_VERSION ||
+           version == DS_STANDARD_MESSAGE_PACKED_VERSION);
 
     for (unsigned int i = 0; i < sizeof(header); i++)
     {
       writeVal<char>(data, header[i]);
     }
-
     writeVal<decltype(version)>(data, version);
+
+    // ntp messages need to be sorted so that the receivers can find their message.
+    std::sort(ntpMessages.begin(), ntpMessages.end(),
+              [&](const NTPMessage& a, const NTPMessage& b) { return a.receiver < b.receiver; });
+
+    if (version == DS_STANDARD_MESSAGE_PACKED_VERSION)
+    {
+      writePacked(data);
+    }
+    else
+    {
+      writeByteAligned(data);
+    }
+  }
+
+  void StandardMessage::writeByteAligned(void* data)
+  {
+    static_assert(DS_STANDARD_MESSAGE_STRUCT_VERSION == 5,
+                  "Message version mismatch in StandardMessage writeByteAligned()");
+
+#ifndef NDEBUG
+    const void* const begin = data; // For length check
+#endif
+
     // write payload length for length check on receiving side.
     writeVal<uint16_t>(data, sizeOfDSMessage() - sizeof(header) - sizeof(version));
     writeVal<decltype(timestamp)>(data, timestamp);
@@ -359,7 +797,7 @@ namespace DevilSmash
     writeVal<int16_t>(data, static_cast<int16_t>(ballVelocity[0]));
     writeVal<int16_t>(data, static_cast<int16_t>(ballVelocity[1]));
     writeVal<uint8_t>(data,
-                      static_cast<uint8_t>(std::max(std::min(ballValidity, 0.f), 1.f) * 255.f));
+                      static_cast<uint8_t>(std::min(std::max(ballValidity, 0.f), 1.f) * 255.f));
 
     writeVal<uint16_t>(data, static_cast<uint16_t>(shiftAndClip<uint32_t>(
                                  timestamp - lastTimeWhistleDetected, 0xFFFE, 0xFFFF, 0)));
@@ -396,9 +834,6 @@ namespace DevilSmash
     // represents player 2, ...)
     static_assert(DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS <= 8,
                   "NTP receiver bits are not adjusted for more than 8 players");
-    // ntp messages need to be sorted so that the receivers can find their message.
-    std::sort(ntpMessages.begin(), ntpMessages.end(),
-              [&](const NTPMessage& a, const NTPMessage& b) { return a.receiver < b.receiver; });
     uint8_t ntpReceiverContainer = 0;
     for (const auto& ntpMessage : ntpMessages)
     {
@@ -413,6 +848,85 @@ namespace DevilSmash
     }
 
     assert((reinterpret_cast<const char*>(data) - reinterpret_cast<const char*>(begin)) ==
-           sizeOfDSMessage());
+           sizeOfByteAligned() - sizeOfHeader());
+  }
+
+  void StandardMessage::writePacked(void* data)
+  {
+    static_assert(DS_STANDARD_MESSAGE_PACKED_VERSION == 6,
+                  "Message version mismatch in StandardMessage writePacked()");
+
+    BitWriter writer(data);
+    writer.write(static_cast<uint32_t>(sizeOfPacked() - sizeOfHeader()), PackedSchema::lengthBits);
+    writer.write(timestamp, PackedSchema::timestampBits);
+    writer.write(PackedSchema::headYawAngle.encode(headYawAngle), PackedSchema::headYawAngle.bits);
+
+    assert(timestampLastJumped <= timestamp);
+    writer.write(PackedSchema::timestampLastJumped.encode(timestamp - timestampLastJumped),
+                 PackedSchema::timestampLastJumped.bits);
+    writer.write(PackedSchema::timeWhenReachBall.encode(std::max(timestamp, timeWhenReachBall) -
+                                                        timestamp),
+                 PackedSchema::timeWhenReachBall.bits);
+    // The striker's time to reach ball should always be smaller than the normal time to reach ball.
+    writer.write(std::min(PackedSchema::timeWhenReachBallStriker.encode(
+                              std::max(timestamp, timeWhenReachBallStriker) - timestamp),
+                          PackedSchema::timeWhenReachBallStriker.maxCode() - 1),
+                 PackedSchema::timeWhenReachBallStriker.bits);
+    // A ball that has never been seen (0) is streamed with the largest code.
+    writer.write(timeWhenBallLastSeen == 0
+                     ? PackedSchema::timeWhenBallLastSeen.maxCode()
+                     : PackedSchema::timeWhenBallLastSeen.encode(
+                           timestamp - std::min(timestamp, timeWhenBallLastSeen)),
+                 PackedSchema::timeWhenBallLastSeen.bits);
+    writer.write(PackedSchema::ballVelocity.encode(ballVelocity[0]),
+                 PackedSchema::ballVelocity.bits);
+    writer.write(PackedSchema::ballVelocity.encode(ballVelocity[1]),
+                 PackedSchema::ballVelocity.bits);
+    writer.write(PackedSchema::ballValidity.encode(ballValidity), PackedSchema::ballValidity.bits);
+    writer.write(PackedSchema::lastTimeWhistleDetected.encode(
+                     timestamp - std::min(timestamp, lastTimeWhistleDetected)),
+                 PackedSchema::lastTimeWhistleDetected.bits);
+
+    writer.write(gameState.toBits(), PackedSchema::gameStateBits);
+
+    assert(static_cast<uint8_t>(currentlyPerformingRole) < static_cast<uint8_t>(Role::MAX));
+    writer.write(static_cast<uint32_t>(currentlyPerformingRole), PackedSchema::roleBits);
+    for (unsigned int player = 0; player < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS; player++)
+    {
+      writer.write(static_cast<uint32_t>(roleAssignments[player]) & 0xFu, PackedSchema::roleBits);
+    }
+
+    assert(member == HULKS_MEMBER || member == DEVIL_MEMBER);
+    writer.write(static_cast<bool>(member) ? 1 : 0, 1);
+    writer.write(isPenalized ? 1 : 0, 1);
+    writer.write(isRobotPoseValid ? 1 : 0, 1);
+    writer.write(requestsNTPMessage ? 1 : 0, 1);
+
+    const unsigned int robotsInMap =
+        std::min(static_cast<int>(robotMap.map.size()), DS_STANDARD_MESSAGE_MAX_ROBOTS_IN_MAP);
+    writer.write(robotsInMap, PackedSchema::robotCountBits);
+    for (unsigned int i = 0; i < robotsInMap; i++)
+    {
+      const auto& robot = robotMap.map[i];
+      assert(robot.type != RobotMap::Robot::Type::MAX);
+      writer.write(PackedSchema::robotPosition.encode(robot.x), PackedSchema::robotPosition.bits);
+      writer.write(PackedSchema::robotPosition.encode(robot.y), PackedSchema::robotPosition.bits);
+      writer.write(static_cast<uint32_t>(robot.type), PackedSchema::robotTypeBits);
+    }
+
+    uint32_t ntpReceiverContainer = 0;
+    for (const auto& ntpMessage : ntpMessages)
+    {
+      assert(ntpMessage.receiver - 1 < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS);
+      ntpReceiverContainer |= 1u << (ntpMessage.receiver - 1);
+    }
+    writer.write(ntpReceiverContainer, PackedSchema::ntpReceiverBits);
+    for (const auto& ntpMessage : ntpMessages)
+    {
+      assert(timestamp - ntpMessage.requestReceipt < 0xFFFFu);
+      writer.write(ntpMessage.requestOrigination, PackedSchema::ntpOriginationBits);
+      writer.write((timestamp - ntpMessage.requestReceipt) & 0xFFFFu, PackedSchema::ntpReceiptBits);
+    }
+    writer.flush();
   }
 } // namespace DevilSmash
@@ -58,6 +58,19 @@
  *   /// [delta 0..10 (64ms)] time since msg timestamp (This will be streamed in relation
  *       to the timestamp of the message in the range of 0 to 10, unit of the values is 64ms
  *   uint32_t time1
+ *
+ *
+ * VERSIONS
+ *
+ * Every message starts with the header and the version byte. The version selects the encoding of
+ * the rest of the message:
+ * - DS_STANDARD_MESSAGE_STRUCT_VERSION: every value is streamed with the byte granularity that is
+ *   described at the members.
+ * - DS_STANDARD_MESSAGE_PACKED_VERSION: the values are streamed as a bit stream with the ranges and
+ *   precisions of the packed schema in DevilSmashStandardMessage.cpp. They are usually coarser than
+ *   the ones described at the members.
+ * The version member of a StandardMessage selects the encoding that is used by write. read accepts
+ * both versions.
  */
 
 
@@ -65,12 +78,14 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <limits>
 #include <stdint.h>
 #include <vector>
 
 #define DS_STANDARD_MESSAGE_STRUCT_HEADER "DESM"
 #define DS_STANDARD_MESSAGE_STRUCT_VERSION 5
+#define DS_STANDARD_MESSAGE_PACKED_VERSION 6
 #define DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS 6
 #define DS_STANDARD_MESSAGE_MAX_ROBOTS_IN_MAP 12
 
@@ -138,8 +153,9 @@ namespace DevilSmash
     /**
      * @brief stores all content from data into this struct.
      * @param data The data to be stored.
+     * @return false if a robot has an invalid type
      */
-    void read(const void*& data);
+    bool read(const void*& data);
   };
 
   /**
@@ -151,22 +167,22 @@ namespace DevilSmash
   struct GameStateStruct
   {
     // The positions of the single pieces of information inside the 2 byte data field.
-    const uint8_t SET_PLAY_POS = 0u;
-    const uint8_t GAME_STATE_POS = 3u;
-    const uint8_t GAME_PHASE_POS = 6u;
-    const uint8_t COMPETITION_TYPE_POS = 8u;
-    const uint8_t COMPETITION_PHASE_POS = 10u;
-    const uint8_t FIRST_HALF_POS = 11u;
-    const uint8_t KICKING_TEAM_POS = 12u;
+    static constexpr uint8_t SET_PLAY_POS = 0u;
+    static constexpr uint8_t GAME_STATE_POS = 3u;
+    static constexpr uint8_t GAME_PHASE_POS = 6u;
+    static constexpr uint8_t COMPETITION_TYPE_POS = 8u;
+    static constexpr uint8_t COMPETITION_PHASE_POS = 10u;
+    static constexpr uint8_t FIRST_HALF_POS = 11u;
+    static constexpr uint8_t KICKING_TEAM_POS = 12u;
     // the bit masks to use for placing the bits into the 2 byte data field
     // clang-format off
-    const uint16_t SET_PLAY_BITS =          0b0000000000000111;
-    const uint16_t GAME_STATE_BITS =        0b0000000000111000;
-    const uint16_t GAME_PHASE_BITS =        0b0000000011000000;
-    const uint16_t COMPETITION_TYPE_BITS =  0b0000001100000000;
-    const uint16_t COMPETITION_PHASE_BITS = 0b0000010000000000;
-    const uint16_t FIRST_HALF_BITS =        0b0000100000000000;
-    const uint16_t KICKING_TEAM_BITS =      0b0001000000000000;
+    static constexpr uint16_t SET_PLAY_BITS =          0b0000000000000111;
+    static constexpr uint16_t GAME_STATE_BITS =        0b0000000000111000;
+    static constexpr uint16_t GAME_PHASE_BITS =        0b0000000011000000;
+    static constexpr uint16_t COMPETITION_TYPE_BITS =  0b0000001100000000;
+    static constexpr uint16_t COMPETITION_PHASE_BITS = 0b0000010000000000;
+    static constexpr uint16_t FIRST_HALF_BITS =        0b0000100000000000;
+    static constexpr uint16_t KICKING_TEAM_BITS =      0b0001000000000000;
     // clang-format on
 
     /// [0..7] set play
@@ -195,6 +211,18 @@ namespace DevilSmash
       return 2;
     }
 
+    /**
+     * @brief toBits combines all values into the bits of the data field
+     * @return the data field (only the lowest 13 bits are used)
+     */
+    uint16_t toBits() const;
+
+    /**
+     * @brief fromBits extracts all values from the bits of the data field
+     * @param stateBits the data field
+     */
+    void fromBits(uint16_t stateBits);
+
     /**
      * @brief stores all data from this struct into the given data field
      * @param data pointer to the data field to store this struct in.
@@ -264,7 +292,8 @@ namespace DevilSmash
   {
     /// DS_STANDARD_MESSAGE_STRUCT_HEADER
     char header[4];
-    /// DS_STANDARD_MESSAGE_STRUCT_VERSION
+    /// DS_STANDARD_MESSAGE_STRUCT_VERSION or DS_STANDARD_MESSAGE_PACKED_VERSION (selects the
+    /// encoding that is used by write)
     uint8_t version;
     /// [0..1] either DEVIL_MEMBER or HULK_MEMBER
     uint8_t member;
@@ -345,6 +374,15 @@ namespace DevilSmash
      */
     int sizeOfDSMessage() const;
 
+    /**
+     * @brief returns the size of the header and the version
+     * @return the number of bytes that are the same for every version
+     */
+    static int sizeOfHeader()
+    {
+      return sizeof(header) + sizeof(version);
+    }
+
     /**
      * @brief Puts all data of this struct into a compressed data package
      *
@@ -357,9 +395,26 @@ namespace DevilSmash
 
     /**
      * @brief Extracts all information from a compressed data package into this struct's members.
+     *
+     * The values are decoded directly from data. Nothing is read beyond size bytes.
      * @param data pointer to the data field to read the data from.
+     * @param size the number of bytes that belong to the message
      * @return true on success
      */
-    bool read(const void* data);
+    bool read(const void* data, std::size_t size = std::numeric_limits<std::size_t>::max());
+
+  private:
+    /**
+     * @brief the version specific parts of sizeOfDSMessage, write and read
+     *
+     * The data pointers point behind the version byte and size is the number of bytes that are
+     * left for the version specific part.
+     */
+    int sizeOfByteAligned() const;
+    int sizeOfPacked() const;
+    void writeByteAligned(void* data);
+    void writePacked(void* data);
+    bool readByteAligned(const void* data, std::size_t size);
+    bool readPacked(const void* data, std::size_t size);
   };
 } // namespace DevilSmash
@@ -3,20 +3,94 @@
 #include "SPLStandardMessage.h"
 
 #include <random>
+#include <vector>
 
 namespace DevilSmash
 {
   constexpr float pi = 3.1415926535897932384626433832795f;
 
+  DevilSmashStandardMessageTest::DevilSmashStandardMessageTest()
+    : engine_(std::random_device()())
+    , success_(true)
+  {
+  }
+
   bool DevilSmash::DevilSmashStandardMessageTest::test()
   {
-    uint8_t data[SPL_STANDARD_MESSAGE_DATA_SIZE];
+    success_ = true;
+
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+      testRoundTrip(DS_STANDARD_MESSAGE_STRUCT_VERSION);
+      testRoundTrip(DS_STANDARD_MESSAGE_PACKED_VERSION);
+    }
+    for (unsigned int i = 0; i < 100; i++)
+    {
+      testInvalidData(DS_STANDARD_MESSAGE_STRUCT_VERSION);
+      testInvalidData(DS_STANDARD_MESSAGE_PACKED_VERSION);
+    }
+
+    return success_;
+  }
+
+  void DevilSmashStandardMessageTest::benchmark(const unsigned int iterations)
+  {
+    for (const uint8_t version :
+         {static_cast<uint8_t>(DS_STANDARD_MESSAGE_STRUCT_VERSION),
+          static_cast<uint8_t>(DS_STANDARD_MESSAGE_PACKED_VERSION)})
+    {
+      std::vector<StandardMessage> messages;
+      messages.reserve(iterations);
+      for (unsigned int i = 0; i < iterations; i++)
+      {
+        messages.emplace_back(randomMessage(version));
+      }
+      // the smallest message that can be sent (no robots, no NTP messages)
+      StandardMessage emptyMessage;
+      emptyMessage.version = version;
+
+      std::vector<uint8_t> data(iterations * SPL_STANDARD_MESSAGE_DATA_SIZE);
+      std::size_t totalSize = 0;
+      const auto writeStart = std::chrono::steady_clock::now();
+      for (unsigned int i = 0; i < iterations; i++)
+      {
+        messages[i].write(data.data() + i * SPL_STANDARD_MESSAGE_DATA_SIZE);
+        totalSize += messages[i].sizeOfDSMessage();
+      }
+      const auto writeEnd = std::chrono::steady_clock::now();
+
+      StandardMessage readMsg;
+      unsigned int validMessages = 0;
+      const auto readStart = std::chrono::steady_clock::now();
+      for (unsigned int i = 0; i < iterations; i++)
+      {
+        validMessages += readMsg.read(data.data() + i * SPL_STANDARD_MESSAGE_DATA_SIZE,
+                                      SPL_STANDARD_MESSAGE_DATA_SIZE);
+      }
+      const auto readEnd = std::chrono::steady_clock::now();
+
+      const double count = std::max(iterations, 1u);
+      std::cout << "version " << static_cast<unsigned int>(version) << ":\n";
+      std::cout << "  minimum size [bytes]: " << emptyMessage.sizeOfDSMessage() << "\n";
+      std::cout << "  average size [bytes]: " << totalSize / count << "\n";
+      std::cout << "  write [ns/msg]:       "
+                << std::chrono::duration<double, std::nano>(writeEnd - writeStart).count() / count
+                << "\n";
+      std::cout << "  read [ns/msg]:        "
+                << std::chrono::duration<double, std::nano>(readEnd - readStart).count() / count
+                << " (" << validMessages << " of " << iterations << " valid)\n";
+    }
+  }
 
+  StandardMessage DevilSmashStandardMessageTest::randomMessage(const uint8_t version)
+  {
     StandardMessage origMsg;
 
+    origMsg.version = version;
     origMsg.member = HULKS_MEMBER;
-    origMsg.timestamp = randomInt(0xFFFFu, 0xFFFFFFu);
+    origMsg.timestamp = randomInt(0x2FFFFu, 0xFFFFFFu);
     origMsg.isPenalized = randomBool();
+    origMsg.isRobotPoseValid = randomBool();
     origMsg.headYawAngle = randomBool() ? 0.5f : -0.5f;
     origMsg.currentlyPerformingRole = Role::STRIKER;
     for (unsigned int player = 0; player < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS; player++)
@@ -34,12 +108,18 @@ namespace DevilSmash
 
     origMsg.timeWhenReachBall = randomInt(origMsg.timestamp, origMsg.timestamp + 120);
     origMsg.timeWhenReachBallStriker = randomInt(origMsg.timestamp, origMsg.timestamp + 110);
-    origMsg.timeWhenBallLastSeen = randomInt(0, origMsg.timestamp);
+    // times in the past are either recent or long ago
+    origMsg.timeWhenBallLastSeen = randomBool()
+                                       ? randomInt(origMsg.timestamp - 60000, origMsg.timestamp)
+                                       : randomInt(0, origMsg.timestamp - 70000);
     origMsg.timestampLastJumped = randomInt(0, origMsg.timestamp);
-    origMsg.lastTimeWhistleDetected = randomInt(origMsg.timestamp - 0xFFFF, origMsg.timestamp);
+    origMsg.lastTimeWhistleDetected =
+        randomBool() ? randomInt(origMsg.timestamp - 60000, origMsg.timestamp)
+                     : randomInt(0, origMsg.timestamp - 70000);
 
     origMsg.ballVelocity[0] = static_cast<float>(randomInt(0, 10000)) - 5000.f;
     origMsg.ballVelocity[1] = static_cast<float>(randomInt(0, 10000)) - 5000.f;
+    origMsg.ballValidity = static_cast<float>(randomInt(0, 1000)) / 1000.f;
 
     const unsigned int numRobots = randomInt(0, DS_STANDARD_MESSAGE_MAX_ROBOTS_IN_MAP);
     for (unsigned int i = 0; i < numRobots; i++)
@@ -54,35 +134,59 @@ namespace DevilSmash
 
     origMsg.requestsNTPMessage = randomBool();
 
-    /*for (unsigned int player = 0; player < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS; player++)
+    for (unsigned int player = 0; player < DS_STANDARD_MESSAGE_MAX_NUM_PLAYERS; player++)
     {
       if (randomBool())
       {
         NTPMessage ntpMsg;
-        ntpMsg.requestOrigination = randomInt();
-        ntpMsg.requestReceipt = randomInt(0, 4000);
-        ntpMsg.receiver = player;
+        ntpMsg.requestOrigination = randomInt(0, 0xFFFFFFFEu);
+        ntpMsg.requestReceipt = origMsg.timestamp - randomInt(0, 4000);
+        ntpMsg.receiver = player + 1;
         origMsg.ntpMessages.emplace_back(ntpMsg);
       }
-    }*/
+    }
+
+    return origMsg;
+  }
+
+  void DevilSmashStandardMessageTest::testRoundTrip(const uint8_t version)
+  {
+    uint8_t data[SPL_STANDARD_MESSAGE_DATA_SIZE];
+
+    StandardMessage origMsg = randomMessage(version);
+    const bool packed = version == DS_STANDARD_MESSAGE_PACKED_VERSION;
 
+    const int size = origMsg.sizeOfDSMessage();
+    checkTrue(size <= static_cast<int>(SPL_STANDARD_MESSAGE_DATA_SIZE), "message fits into the SPL message");
     origMsg.write(data);
 
 
     StandardMessage readMsg;
-    readMsg.read(data);
+    checkTrue(readMsg.read(data, size), "message can be read");
 
     checkEqual<decltype(origMsg.version)>(origMsg.version, readMsg.version);
+    checkEqual<int>(size, readMsg.sizeOfDSMessage());
     checkEqual<decltype(origMsg.timestamp)>(origMsg.timestamp, readMsg.timestamp);
-    checkEqual<decltype(origMsg.headYawAngle)>(origMsg.headYawAngle, readMsg.headYawAngle, 1.1f / 180.f * pi);
+    checkEqual<decltype(origMsg.headYawAngle)>(origMsg.headYawAngle, readMsg.headYawAngle, (packed ? 1.01f : 1.1f) / 180.f * pi);
     if (origMsg.timestamp - origMsg.timestampLastJumped <= (250u << 7u))
-      checkEqual<decltype(origMsg.timestampLastJumped)>(origMsg.timestampLastJumped, readMsg.timestampLastJumped, 129);
-    checkEqual<decltype(origMsg.timeWhenReachBall)>(origMsg.timeWhenReachBall, readMsg.timeWhenReachBall, 9);
-    checkEqual<decltype(origMsg.timeWhenReachBallStriker)>(origMsg.timeWhenReachBallStriker, readMsg.timeWhenReachBallStriker, 9);
-    checkEqual<decltype(origMsg.timeWhenBallLastSeen)>(origMsg.timeWhenBallLastSeen, readMsg.timeWhenBallLastSeen);
-    checkEqual<decltype(origMsg.ballVelocity[0])>(origMsg.ballVelocity[0], readMsg.ballVelocity[0], 1.f);
-    checkEqual<decltype(origMsg.ballVelocity[1])>(origMsg.ballVelocity[1], readMsg.ballVelocity[1], 1.f);
-    checkEqual<decltype(origMsg.lastTimeWhistleDetected)>(origMsg.lastTimeWhistleDetected, readMsg.lastTimeWhistleDetected);
+      checkEqual<decltype(origMsg.timestampLastJumped)>(origMsg.timestampLastJumped, readMsg.timestampLastJumped, packed ? 64 : 129);
+    checkEqual<decltype(origMsg.timeWhenReachBall)>(origMsg.timeWhenReachBall, readMsg.timeWhenReachBall, packed ? 8 : 9);
+    checkEqual<decltype(origMsg.timeWhenReachBallStriker)>(origMsg.timeWhenReachBallStriker, readMsg.timeWhenReachBallStriker, packed ? 8 : 9);
+    // the packed version only knows recent ball percepts, older ones are read as "never seen"
+    if (!packed)
+      checkEqual<decltype(origMsg.timeWhenBallLastSeen)>(origMsg.timeWhenBallLastSeen, readMsg.timeWhenBallLastSeen);
+    else if (origMsg.timestamp - origMsg.timeWhenBallLastSeen <= 60000)
+      checkEqual<decltype(origMsg.timeWhenBallLastSeen)>(origMsg.timeWhenBallLastSeen, readMsg.timeWhenBallLastSeen, 4);
+    else
+      checkEqual<decltype(origMsg.timeWhenBallLastSeen)>(0, readMsg.timeWhenBallLastSeen);
+    checkEqual<decltype(origMsg.ballVelocity[0])>(origMsg.ballVelocity[0], readMsg.ballVelocity[0], packed ? 4.f : 1.f);
+    checkEqual<decltype(origMsg.ballVelocity[1])>(origMsg.ballVelocity[1], readMsg.ballVelocity[1], packed ? 4.f : 1.f);
+    checkEqual<decltype(origMsg.ballValidity)>(origMsg.ballValidity, readMsg.ballValidity, packed ? 1.f / 30.f + 1e-4f : 1.f / 255.f + 1e-4f);
+    // whistles that are too long ago are read as "never detected" by both versions
+    if (origMsg.timestamp - origMsg.lastTimeWhistleDetected <= 60000)
+      checkEqual<decltype(origMsg.lastTimeWhistleDetected)>(origMsg.lastTimeWhistleDetected, readMsg.lastTimeWhistleDetected, packed ? 8 : 0);
+    else
+      checkEqual<decltype(origMsg.lastTimeWhistleDetected)>(0, readMsg.lastTimeWhistleDetected);
 
     checkEqual<decltype(origMsg.gameState.setPlay)>(origMsg.gameState.setPlay, readMsg.gameState.setPlay);
     checkEqual<decltype(origMsg.gameState.gameState)>(origMsg.gameState.gameState, readMsg.gameState.gameState);
@@ -102,19 +206,57 @@ namespace DevilSmash
 
     checkEqual<decltype(origMsg.member)>(origMsg.member, readMsg.member);
     checkEqual<decltype(origMsg.isPenalized)>(origMsg.isPenalized, readMsg.isPenalized);
+    checkEqual<decltype(origMsg.isRobotPoseValid)>(origMsg.isRobotPoseValid, readMsg.isRobotPoseValid);
     checkEqual<decltype(origMsg.requestsNTPMessage)>(origMsg.requestsNTPMessage, readMsg.requestsNTPMessage);
 
     checkEqual<decltype(origMsg.robotMap.map.size())>(origMsg.robotMap.map.size(), readMsg.robotMap.map.size());
     for (unsigned int i = 0; i < readMsg.robotMap.map.size(); i++)
     {
       checkEqual<uint8_t>(static_cast<uint8_t>(origMsg.robotMap.map[i].type), static_cast<uint8_t>(readMsg.robotMap.map[i].type));
-      checkEqual<float>(origMsg.robotMap.map[i].x, readMsg.robotMap.map[i].x, 0.01);
-      checkEqual<float>(origMsg.robotMap.map[i].y, readMsg.robotMap.map[i].y, 0.01);
+      checkEqual<float>(origMsg.robotMap.map[i].x, readMsg.robotMap.map[i].x, packed ? 6.26 : 0.01);
+      checkEqual<float>(origMsg.robotMap.map[i].y, readMsg.robotMap.map[i].y, packed ? 6.26 : 0.01);
     }
 
+    // write has sorted the NTP messages of origMsg by receiver
     checkEqual<decltype(origMsg.ntpMessages.size())>(origMsg.ntpMessages.size(), readMsg.ntpMessages.size());
+    for (unsigned int i = 0; i < readMsg.ntpMessages.size(); i++)
+    {
+      checkEqual<decltype(origMsg.ntpMessages[i].receiver)>(origMsg.ntpMessages[i].receiver, readMsg.ntpMessages[i].receiver);
+      checkEqual<decltype(origMsg.ntpMessages[i].requestOrigination)>(origMsg.ntpMessages[i].requestOrigination, readMsg.ntpMessages[i].requestOrigination);
+      checkEqual<decltype(origMsg.ntpMessages[i].requestReceipt)>(origMsg.ntpMessages[i].requestReceipt, readMsg.ntpMessages[i].requestReceipt);
+    }
+  }
 
-    return true;
+  void DevilSmashStandardMessageTest::testInvalidData(const uint8_t version)
+  {
+    uint8_t data[SPL_STANDARD_MESSAGE_DATA_SIZE];
+
+    StandardMessage origMsg = randomMessage(version);
+    const int size = origMsg.sizeOfDSMessage();
+    origMsg.write(data);
+
+    StandardMessage readMsg;
+    // Every prefix is copied into a buffer of its own size, so that memory checkers can detect
+    // reads beyond the size.
+    for (int length = 0; length < size; length++)
+    {
+      const std::vector<uint8_t> truncated(data, data + length);
+      checkTrue(!readMsg.read(truncated.data(), truncated.size()),
+                "truncated message is rejected");
+    }
+
+    // Corrupted and random data may be accepted, but must not be read beyond its size.
+    std::vector<uint8_t> corrupted(data, data + size);
+    corrupted[randomInt(StandardMessage::sizeOfHeader(), size - 1)] ^=
+        static_cast<uint8_t>(1u << randomInt(0, 7));
+    readMsg.read(corrupted.data(), corrupted.size());
+
+    std::vector<uint8_t> random(data, data + randomInt(size, SPL_STANDARD_MESSAGE_DATA_SIZE));
+    for (std::size_t i = StandardMessage::sizeOfHeader(); i < random.size(); i++)
+    {
+      random[i] = static_cast<uint8_t>(randomInt(0, 0xFF));
+    }
+    readMsg.read(random.data(), random.size());
   }
 
   bool DevilSmashStandardMessageTest::randomBool()
@@ -126,10 +268,8 @@ namespace DevilSmash
   {
     assert(min < max);
 
-    std::random_device r;
-    std::default_random_engine e1(r());
     std::uniform_int_distribution<uint32_t> uniformDist(min, max);
-    uint32_t randomNumber = uniformDist(e1);
+    uint32_t randomNumber = uniformDist(engine_);
     assert(randomNumber >= min && randomNumber <= max);
     return randomNumber;
   }
@@ -8,6 +8,7 @@
 #include <limits>
 #include <chrono>
 #include <cstdint>
+#include <random>
 #include <time.h>
 
 namespace DevilSmash
@@ -15,9 +16,40 @@ namespace DevilSmash
   class DevilSmashStandardMessageTest
   {
   public:
+    DevilSmashStandardMessageTest();
+
+    /**
+     * @brief test runs the round trip tests of both versions and feeds invalid data to read
+     * @return true if all checks passed
+     */
     bool test();
 
+    /**
+     * @brief benchmark prints the sizes and the encoding and decoding times of both versions
+     * @param iterations the number of random messages per version
+     */
+    void benchmark(unsigned int iterations);
+
   private:
+    /**
+     * @brief randomMessage creates a message with random but valid content
+     * @param version the version that the message is written with
+     * @return the message
+     */
+    StandardMessage randomMessage(uint8_t version);
+
+    /**
+     * @brief testRoundTrip writes and reads a random message and compares the content
+     * @param version the version that is tested
+     */
+    void testRoundTrip(uint8_t version);
+
+    /**
+     * @brief testInvalidData checks that truncated, corrupted and random data is handled
+     * @param version the version that is tested
+     */
+    void testInvalidData(uint8_t version);
+
     bool randomBool();
 
     uint32_t randomInt(uint32_t min = 0, uint32_t max = std::numeric_limits<uint16_t>::max());
@@ -28,8 +60,24 @@ namespace DevilSmash
       if (got > expected + delta || got < expected - delta)
       {
         std::cout << "Expected: " << expected << " got " << got << "\n";
+        success_ = false;
+        assert(false);
+      }
+    }
+
+    inline void checkTrue(bool condition, const char* description)
+    {
+      if (!condition)
+      {
+        std::cout << "Check failed: " << description << "\n";
+        success_ = false;
         assert(false);
       }
     }
+
+    /// the random engine of all random values
+    std::default_random_engine engine_;
+    /// whether all checks passed since the start of the current test
+    bool success_;
   };
 }
@@ -0,0 +1,24 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Definitions/DevilSmashStandardMessageTest.hpp"
+
+/*
+ * This runs the DevilSmashStandardMessageTest and compares the byte aligned and the bit packed
+ * version of the DevilSmash message.
+ *
+ * Usage: devilSmashStandardMessageTest [<benchmark iterations>]
+ */
+int main(int argc, char* argv[])
+{
+  const unsigned int iterations =
+      argc > 1 ? std::max<unsigned int>(std::stoul(argv[1]), 1) : 10000;
+
+  DevilSmash::DevilSmashStandardMessageTest test;
+  const bool success = test.test();
+  std::cout << (success ? "All checks passed" : "Some checks failed") << "\n";
+  test.benchmark(iterations);
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -13,6 +13,8 @@ ModuleBase::ModuleBase(const ModuleManagerInterface& manager, const std::string&
   , debug_(manager_.debug())
   , configuration_(manager_.configuration())
   , robotInterface_(manager_.robotInterface())
+  , parameterUpdates_(manager_.parameterUpdates())
+  , randomStream_(Random::getSeed(), Random::getStreamId(mount_))
 {
   if (!configuration_.mount(mount_, name + ".json", manager_.getConfigurationType()))
   {
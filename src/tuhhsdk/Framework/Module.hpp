@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
 #include <typeindex>
 #include <unordered_set>
@@ -7,8 +9,10 @@
 #include "Hardware/RobotInterface.hpp"
 #include "Modules/Configuration/Configuration.h"
 #include "Modules/Debug/Debug.h"
+#include "Tools/Math/Random.hpp"
 
 #include "Database.hpp"
+#include "ParameterUpdates.hpp"
 
 #define ModuleName static constexpr const char*
 
@@ -47,6 +51,14 @@ public:
   {
     return productions_;
   }
+  /**
+   * @brief getMount returns the mount point of this module
+   * @return the name of the module manager and the module, separated by a dot
+   */
+  const std::string& getMount() const
+  {
+    return mount_;
+  }
 
 protected:
   /**
@@ -89,10 +101,14 @@ private:
   Configuration& configuration_;
   /// the RobotInterface instance
   RobotInterface& robotInterface_;
+  /// the parameter updates of the ModuleManager
+  ParameterUpdates& parameterUpdates_;
   /// the set of dependencies of this module
   std::unordered_set<std::type_index> dependencies_;
   /// the set of productions of this module
   std::unordered_set<std::type_index> productions_;
+  /// the random number stream that is used while this module is cycled
+  Random::Stream randomStream_;
   template <typename T, typename T2>
   friend class Module;
   template <typename T>
@@ -190,6 +206,9 @@ public:
     {
       database_.reset(pro);
     }
+    // every module draws from its own stream so that its random numbers are reproducible for a
+    // fixed seed, independent of other modules and threads
+    Random::ScopedStream randomStream(randomStream_);
     cycle();
     for (auto& pro : productions_)
     {
@@ -346,11 +365,14 @@ private:
 };
 
 template <typename T>
-class Parameter
+class Parameter : public ParameterBase
 {
 public:
   /**
    * @brief Parameter gets the value of the parameter and may register a callback handler
+   *
+   * Changes from other threads are applied (and the callback is called) by the thread of the
+   * module before its next cycle. Changes from the thread of the module are applied immediately.
    * @param module the module that uses this parameter
    * @param key the name of this parameter
    * @param callback is called everytime the value is changed
@@ -359,14 +381,38 @@ public:
             std::function<void()> callback = std::function<void()>())
     : value_()
     , callback_(callback)
+    , updates_(module.parameterUpdates_)
   {
     module.configuration_.get(module.mount_, key) >> value_;
     if (callback_)
     {
-      module.configuration_.registerCallback(module.mount_, key,
-                                             boost::bind(&Parameter<T>::onUpdate, this, _1));
+      updates_.add(*this);
+      connection_ = module.configuration_.registerCallback(
+          module.mount_, key, boost::bind(&Parameter<T>::onUpdate, this, _1));
     }
   }
+  /**
+   * @brief Parameter copies the value of another parameter
+   *
+   * The copy does not receive updates. Objects that are copied at runtime (e.g. hypotheses of a
+   * filter) thus keep the value that the original had at the time of the copy.
+   * @param other the parameter to copy
+   */
+  Parameter(const Parameter& other)
+    : ParameterBase()
+    , value_(other.value_)
+    , callback_(other.callback_)
+    , updates_(other.updates_)
+  {
+  }
+  Parameter& operator=(const Parameter&) = delete;
+  /**
+   * @brief ~Parameter disconnects from the configuration and stops receiving updates
+   */
+  ~Parameter() override
+  {
+    updates_.remove(*this);
+  }
   /**
    * @brief operator() a non-const version because some program modification might be needed
    * @return a reference to the parameter
@@ -383,6 +429,18 @@ public:
   {
     return value_;
   }
+  /**
+   * @brief applyUpdate takes over the latest published value and calls the callback
+   */
+  void applyUpdate() override
+  {
+    const auto value = std::atomic_exchange(&pendingValue_, std::shared_ptr<const Uni::Value>());
+    if (value)
+    {
+      *value >> value_;
+      callback_();
+    }
+  }
 
 protected:
   /// stores the actual value
@@ -396,11 +454,25 @@ private:
    */
   void onUpdate(const Uni::Value& value)
   {
-    value >> value_;
-    callback_();
+    if (updates_.isOwnerThread())
+    {
+      // An older value from another thread must not overwrite this one.
+      std::atomic_store(&pendingValue_, std::shared_ptr<const Uni::Value>());
+      value >> value_;
+      callback_();
+      return;
+    }
+    std::atomic_store(&pendingValue_, std::make_shared<const Uni::Value>(value));
+    updates_.notify();
   }
   /// the callback for value changes
   std::function<void()> callback_;
+  /// the parameter updates of the module manager
+  ParameterUpdates& updates_;
+  /// the latest value that has been published by another thread and not yet applied
+  std::shared_ptr<const Uni::Value> pendingValue_;
+  /// the connection to the configuration that is closed when the parameter is destroyed
+  boost::signals2::scoped_connection connection_;
 };
 
 template <typename T>
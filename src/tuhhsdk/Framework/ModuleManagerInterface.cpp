@@ -38,6 +38,9 @@ void ModuleManagerInterface::runCycle()
   currentDebugMap_ = debugDatabase_.nextUpdateableMap();
   TimePoint startTime(TimePoint::getCurrentTime());
 
+  // Parameters are only changed between two cycles so that modules see a consistent configuration.
+  parameterUpdates_.apply();
+
   try
   {
     cycle();
@@ -60,6 +63,11 @@ Database& ModuleManagerInterface::getDatabase() const
   return const_cast<Database&>(database_);
 }
 
+ParameterUpdates& ModuleManagerInterface::parameterUpdates() const
+{
+  return const_cast<ParameterUpdates&>(parameterUpdates_);
+}
+
 DebugDatabase::DebugMap*& ModuleManagerInterface::debug() const
 {
   // Sorry for the const_cast. | NR
@@ -80,6 +80,11 @@ public:
   {
     return robotInterface_;
   }
+  /**
+   * @brief parameterUpdates provides access to the parameter updates of the modules
+   * @return the ParameterUpdates of this ModuleManager
+   */
+  ParameterUpdates& parameterUpdates() const;
   /**
    * @brief runCycle should be called at the beginning of each cycle
    */
@@ -122,6 +127,8 @@ private:
   Configuration& configuration_;
   /// the RobotInterface instance
   RobotInterface& robotInterface_;
+  /// the parameter changes that are applied at the beginning of each cycle
+  ParameterUpdates parameterUpdates_;
   /// the time the cycle needed to be executed. Averaged over 60 cycles.
   SimpleArrayMovingAverage<double, double, 60> averageCycleTime_;
 };
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+class ParameterBase
+{
+public:
+  /**
+   * @brief ~ParameterBase virtual destructor for polymorphism
+   */
+  virtual ~ParameterBase() = default;
+  /**
+   * @brief applyUpdate takes over the latest value that has been published since the last call
+   */
+  virtual void applyUpdate() = 0;
+};
+
+/**
+ * @brief ParameterUpdates collects the parameter changes of a module manager
+ *
+ * Configuration changes may arrive from any thread (e.g. the network thread). A Parameter only
+ * publishes the new value and marks it as pending. The values are taken over in a batch by the
+ * thread that runs the modules, before the next cycle starts. Thus, reading a Parameter never needs
+ * a lock and its callback is always called in the thread of its module.
+ */
+class ParameterUpdates
+{
+public:
+  /**
+   * @brief add registers a parameter that receives updates
+   * @param parameter the parameter (removes itself with remove when it is destroyed)
+   */
+  void add(ParameterBase& parameter)
+  {
+    parameters_.push_back(&parameter);
+  }
+  /**
+   * @brief remove unregisters a parameter (must be called from the thread that runs the modules)
+   * @param parameter the parameter that is destroyed
+   */
+  void remove(ParameterBase& parameter)
+  {
+    parameters_.erase(std::remove(parameters_.begin(), parameters_.end(), &parameter),
+                      parameters_.end());
+    // A callback that destroys parameters shifts the ones behind them, so the batch that is being
+    // applied may skip one. It is visited again before the next cycle.
+    if (applying_)
+    {
+      pending_.store(true, std::memory_order_relaxed);
+    }
+  }
+  /**
+   * @brief notify marks that a parameter has a pending update (may be called from any thread)
+   */
+  void notify()
+  {
+    pending_.store(true, std::memory_order_release);
+  }
+  /**
+   * @brief isOwnerThread returns whether the calling thread is the one that runs the modules
+   * @return true if updates can be applied immediately
+   */
+  bool isOwnerThread() const
+  {
+    return owner_.load(std::memory_order_relaxed) == std::this_thread::get_id();
+  }
+  /**
+   * @brief apply applies all pending updates (must be called between two cycles)
+   */
+  void apply()
+  {
+    owner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    // A value that is published after its parameter has been visited sets the flag again, so it
+    // is applied before the next cycle.
+    if (!pending_.exchange(false, std::memory_order_acq_rel))
+    {
+      return;
+    }
+    // Callbacks may construct or destroy parameters (e.g. by resetting the hypotheses of a filter),
+    // so the list is indexed instead of iterated.
+    applying_ = true;
+    for (std::size_t i = 0; i < parameters_.size(); i++)
+    {
+      parameters_[i]->applyUpdate();
+    }
+    applying_ = false;
+  }
+
+private:
+  /// all parameters that receive updates
+  std::vector<ParameterBase*> parameters_;
+  /// whether apply is running in the thread that runs the modules
+  bool applying_ = false;
+  /// whether any parameter may have a pending update
+  std::atomic<bool> pending_{false};
+  /// the thread that runs the modules (default constructed until the first cycle)
+  std::atomic<std::thread::id> owner_{std::thread::id()};
+};
@@ -0,0 +1,85 @@
+#include <stdexcept>
+
+#include "BehaviorBenchmarkInterface.hpp"
+
+
+void BehaviorBenchmarkFakeData::waitForFakeData() {}
+
+bool BehaviorBenchmarkFakeData::readFakeRobotPose(Pose&)
+{
+  return false;
+}
+
+bool BehaviorBenchmarkFakeData::readFakeBallPosition(Vector2f&)
+{
+  return false;
+}
+
+bool BehaviorBenchmarkFakeData::readFakeRobotPositions(VecVector2f&)
+{
+  return false;
+}
+
+bool BehaviorBenchmarkFakeData::getFakeDataInternal(const std::type_index&, DataTypeBase&)
+{
+  return false;
+}
+
+void BehaviorBenchmarkInterface::configure(Configuration&, NaoInfo&) {}
+
+void BehaviorBenchmarkInterface::setJointAngles(const std::vector<float>&) {}
+
+void BehaviorBenchmarkInterface::setJointStiffnesses(const std::vector<float>&) {}
+
+void BehaviorBenchmarkInterface::setLEDs(const std::vector<float>&) {}
+
+void BehaviorBenchmarkInterface::setSonar(const float) {}
+
+float BehaviorBenchmarkInterface::waitAndReadSensorData(NaoSensorData&)
+{
+  throw std::runtime_error("The behavior benchmark does not have sensor data.");
+}
+
+std::string BehaviorBenchmarkInterface::getFileRoot()
+{
+  // The benchmark uses the same file system structure as webots
+  return LOCAL_FILE_ROOT;
+}
+
+std::string BehaviorBenchmarkInterface::getDataRoot()
+{
+  return getFileRoot();
+}
+
+void BehaviorBenchmarkInterface::getNaoInfo(Configuration&, NaoInfo& info)
+{
+  info.bodyVersion = NaoVersion::V6;
+  info.headVersion = NaoVersion::V6;
+  info.bodyName = "default";
+  info.headName = "default";
+}
+
+CameraInterface& BehaviorBenchmarkInterface::getCamera(const Camera)
+{
+  throw std::runtime_error("The behavior benchmark does not have cameras.");
+}
+
+FakeDataInterface& BehaviorBenchmarkInterface::getFakeData()
+{
+  return fakeData_;
+}
+
+AudioInterface& BehaviorBenchmarkInterface::getAudio()
+{
+  throw std::runtime_error("The behavior benchmark does not have audio.");
+}
+
+CameraInterface& BehaviorBenchmarkInterface::getNextCamera()
+{
+  throw std::runtime_error("The behavior benchmark does not have cameras.");
+}
+
+Camera BehaviorBenchmarkInterface::getCurrentCameraType()
+{
+  return Camera::TOP;
+}
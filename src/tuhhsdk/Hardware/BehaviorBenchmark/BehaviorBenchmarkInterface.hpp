@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Hardware/FakeDataInterface.hpp"
+#include "Hardware/RobotInterface.hpp"
+#include "Modules/Configuration/Configuration.h"
+
+/**
+ * @brief BehaviorBenchmarkFakeData is a fake data interface that never provides fake data
+ */
+class BehaviorBenchmarkFakeData final : public FakeDataInterface
+{
+public:
+  void waitForFakeData() override;
+  bool readFakeRobotPose(Pose& fakeData) override;
+  bool readFakeBallPosition(Vector2f& fakeData) override;
+  bool readFakeRobotPositions(VecVector2f& fakeData) override;
+
+private:
+  bool getFakeDataInternal(const std::type_index& id, DataTypeBase& data) override;
+};
+
+/**
+ * @brief BehaviorBenchmarkInterface is the robot interface of the offline behavior benchmark.
+ *
+ * It only provides what is needed to construct modules and load their configuration. There are no
+ * sensors, cameras or microphones, so the benchmark has to provide the world state by itself.
+ */
+class BehaviorBenchmarkInterface : public RobotInterface
+{
+public:
+  void configure(Configuration& config, NaoInfo& naoInfo) override;
+  void setJointAngles(const std::vector<float>& angles) override;
+  void setJointStiffnesses(const std::vector<float>& stiffnesses) override;
+  void setLEDs(const std::vector<float>& leds) override;
+  void setSonar(const float sonar) override;
+  float waitAndReadSensorData(NaoSensorData& data) override;
+  std::string getFileRoot() override;
+  std::string getDataRoot() override;
+  void getNaoInfo(Configuration& config, NaoInfo& info) override;
+  CameraInterface& getCamera(const Camera camera) override;
+  FakeDataInterface& getFakeData() override;
+  AudioInterface& getAudio() override;
+  CameraInterface& getNextCamera() override;
+  Camera getCurrentCameraType() override;
+
+private:
+  /// the fake data interface (that does not provide any fake data)
+  BehaviorBenchmarkFakeData fakeData_;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "Tools/Storage/Image422.hpp"
 #include "Tools/Time.hpp"
 
@@ -9,6 +11,26 @@ enum class Camera
   BOTTOM, ///< value for bottom camera
 };
 
+/**
+ * @brief CameraFrame is a view on an image buffer that is owned by the camera driver.
+ *
+ * Frames are handed out as reference counted handles. The camera does not reuse the buffer of a
+ * frame as long as a handle to it exists, so consumers can keep an image beyond one cycle without
+ * copying it.
+ */
+struct CameraFrame
+{
+  /// the pixel data of the frame (memory of the camera driver)
+  YCbCr422* data = nullptr;
+  /// the 444 size of the frame
+  Vector2i size = Vector2i::Zero();
+  /// the time point at which the first pixel of the frame was recorded
+  TimePoint timestamp;
+};
+
+/// a reference counted handle on a CameraFrame, the buffer is given back when the last one dies
+using CameraFrameHandle = std::shared_ptr<const CameraFrame>;
+
 class CameraInterface
 {
 public:
@@ -27,6 +49,15 @@ public:
    * @return the time point at which the first pixel of the image was recorded
    */
   virtual TimePoint readImage(Image422& image) = 0;
+  /**
+   * @brief acquireFrame returns a handle on the buffer of the current image (the one that
+   * readImage would return). Make sure to call waitForImage before acquireFrame.
+   * @return a handle that keeps the buffer alive or nullptr if the camera does not own its buffers
+   */
+  virtual CameraFrameHandle acquireFrame()
+  {
+    return nullptr;
+  }
   /**
    * @brief releaseImage is used to possible release the image of a camera
    */
@@ -0,0 +1,193 @@
+#include <fstream>
+#include <utility>
+#include <stdexcept>
+
+#include "Tools/Storage/UniValue/UniValue2Json.hpp"
+
+#include "MotionBenchmarkInterface.hpp"
+
+
+void MotionBenchmarkFakeData::waitForFakeData() {}
+
+bool MotionBenchmarkFakeData::readFakeRobotPose(Pose&)
+{
+  return false;
+}
+
+bool MotionBenchmarkFakeData::readFakeBallPosition(Vector2f&)
+{
+  return false;
+}
+
+bool MotionBenchmarkFakeData::readFakeRobotPositions(VecVector2f&)
+{
+  return false;
+}
+
+bool MotionBenchmarkFakeData::getFakeDataInternal(const std::type_index&, DataTypeBase&)
+{
+  return false;
+}
+
+MotionBenchmarkInterface::MotionBenchmarkInterface(std::vector<ReplayFrame> frames,
+                                                   const unsigned int period)
+  : frames_(std::move(frames))
+  , frameIndex_(0)
+  , period_(period)
+  , time_(TimePoint::getCurrentTime())
+  , imuOverridden_(false)
+{
+  commandedAngles_.fill(0.f);
+  imuOverride_.fill(0.f);
+}
+
+std::vector<ReplayFrame> MotionBenchmarkInterface::loadFrames(const std::string& path)
+{
+  std::ifstream stream(path);
+  Json::Reader reader;
+  Json::Value root;
+  if (!stream.is_open() || !reader.parse(stream, root))
+  {
+    throw std::runtime_error("Could not read the replay file " + path);
+  }
+  const Uni::Value replay = Uni::Converter::toUniValue(root);
+  if (replay.type() != Uni::ValueType::OBJECT || !replay.contains("frames"))
+  {
+    throw std::runtime_error("The replay file does not contain an array of frames.");
+  }
+  const Uni::Value& frames = replay["frames"];
+  std::vector<ReplayFrame> result;
+  result.reserve(frames.size());
+  for (auto it = frames.vectorBegin(); it != frames.vectorEnd(); it++)
+  {
+    result.emplace_back();
+    *it >> result.back();
+  }
+  if (result.empty())
+  {
+    throw std::runtime_error("The replay file has an empty frames array.");
+  }
+  return result;
+}
+
+void MotionBenchmarkInterface::overrideIMU(const std::array<float, keys::sensor::IMU_MAX>& imu)
+{
+  imuOverridden_ = true;
+  imuOverride_ = imu;
+}
+
+void MotionBenchmarkInterface::clearIMUOverride()
+{
+  imuOverridden_ = false;
+}
+
+void MotionBenchmarkInterface::configure(Configuration&, NaoInfo&) {}
+
+void MotionBenchmarkInterface::setJointAngles(const std::vector<float>& angles)
+{
+  // Only the first JOINTS_MAX angles are joint angles.
+  for (std::size_t i = 0; i < commandedAngles_.size() && i < angles.size(); i++)
+  {
+    commandedAngles_[i] = angles[i];
+  }
+}
+
+void MotionBenchmarkInterface::setJointStiffnesses(const std::vector<float>&) {}
+
+void MotionBenchmarkInterface::setLEDs(const std::vector<float>&) {}
+
+void MotionBenchmarkInterface::setSonar(const float) {}
+
+float MotionBenchmarkInterface::waitAndReadSensorData(NaoSensorData& data)
+{
+  data.jointCurrent.fill(0.f);
+  data.jointTemperature.fill(0.f);
+  data.jointStatus.fill(0.f);
+  data.sonar.fill(0.f);
+  data.battery.fill(0.f);
+  data.battery[keys::sensor::BATTERY_CHARGE] = 1.f;
+  data.buttonCallbackList.clear();
+  if (!frames_.empty())
+  {
+    const ReplayFrame& frame = frames_[frameIndex_];
+    data.jointSensor = frame.jointAngles;
+    data.switches = frame.switches;
+    data.imu = frame.imu;
+    data.fsrLeft = frame.fsrLeft;
+    data.fsrRight = frame.fsrRight;
+    data.sonar[keys::sensor::SONAR_LEFT_SENSOR_0] = frame.sonarDist[0];
+    data.sonar[keys::sensor::SONAR_RIGHT_SENSOR_0] = frame.sonarDist[1];
+    frameIndex_ = (frameIndex_ + 1) % frames_.size();
+  }
+  else
+  {
+    // a robot that stands upright with the weight equally distributed on both feet and whose
+    // joints follow the commands without delay
+    data.jointSensor = commandedAngles_;
+    data.switches.fill(0.f);
+    data.imu.fill(0.f);
+    data.imu[keys::sensor::IMU_ACC_Z] = -9.81f;
+    const float weightPerSensor = 0.65f;
+    for (auto fsr : {&data.fsrLeft, &data.fsrRight})
+    {
+      fsr->fill(0.f);
+      (*fsr)[keys::sensor::FSR_FRONT_LEFT] = weightPerSensor;
+      (*fsr)[keys::sensor::FSR_FRONT_RIGHT] = weightPerSensor;
+      (*fsr)[keys::sensor::FSR_REAR_LEFT] = weightPerSensor;
+      (*fsr)[keys::sensor::FSR_REAR_RIGHT] = weightPerSensor;
+      (*fsr)[keys::sensor::FSR_TOTAL_WEIGHT] = 4.f * weightPerSensor;
+    }
+  }
+  if (imuOverridden_)
+  {
+    data.imu = imuOverride_;
+  }
+  // The benchmark does not wait for the hardware, so the time only advances in simulation.
+  data.time = time_;
+  time_ += period_;
+  return static_cast<float>(period_) / 1000.f;
+}
+
+std::string MotionBenchmarkInterface::getFileRoot()
+{
+  // The benchmark uses the same file system structure as webots
+  return LOCAL_FILE_ROOT;
+}
+
+std::string MotionBenchmarkInterface::getDataRoot()
+{
+  return getFileRoot();
+}
+
+void MotionBenchmarkInterface::getNaoInfo(Configuration&, NaoInfo& info)
+{
+  info.bodyVersion = NaoVersion::V6;
+  info.headVersion = NaoVersion::V6;
+  info.bodyName = "default";
+  info.headName = "default";
+}
+
+CameraInterface& MotionBenchmarkInterface::getCamera(const Camera)
+{
+  throw std::runtime_error("The motion benchmark does not have cameras.");
+}
+
+FakeDataInterface& MotionBenchmarkInterface::getFakeData()
+{
+  return fakeData_;
+}
+
+AudioInterface& MotionBenchmarkInterface::getAudio()
+{
+  throw std::runtime_error("The motion benchmark does not have audio.");
+}
+
+CameraInterface& MotionBenchmarkInterface::getNextCamera()
+{
+  throw std::runtime_error("The motion benchmark does not have cameras.");
+}
+
+Camera MotionBenchmarkInterface::getCurrentCameraType()
+{
+  return Camera::TOP;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "Data/ReplayData.hpp"
+#include "Definitions/keys.h"
+#include "Hardware/FakeDataInterface.hpp"
+#include "Hardware/RobotInterface.hpp"
+#include "Modules/Configuration/Configuration.h"
+
+/**
+ * @brief MotionBenchmarkFakeData is a fake data interface that never provides fake data
+ */
+class MotionBenchmarkFakeData final : public FakeDataInterface
+{
+public:
+  void waitForFakeData() override;
+  bool readFakeRobotPose(Pose& fakeData) override;
+  bool readFakeBallPosition(Vector2f& fakeData) override;
+  bool readFakeRobotPositions(VecVector2f& fakeData) override;
+
+private:
+  bool getFakeDataInternal(const std::type_index& id, DataTypeBase& data) override;
+};
+
+/**
+ * @brief MotionBenchmarkInterface is the robot interface of the headless motion benchmark.
+ *
+ * It returns sensor data immediately instead of waiting for the next hardware cycle. The sensor
+ * data is either taken from recorded replay frames (looped) or synthesized for a robot standing
+ * upright whose joints reach the commanded angles instantly. The IMU values can be overridden,
+ * e.g. to let the robot lie on the ground.
+ */
+class MotionBenchmarkInterface : public RobotInterface
+{
+public:
+  /**
+   * @brief MotionBenchmarkInterface initializes members
+   * @param frames recorded frames whose sensor values are replayed (empty for synthetic data)
+   * @param period the simulated time between two sensor readings in ms
+   */
+  MotionBenchmarkInterface(std::vector<ReplayFrame> frames, const unsigned int period);
+  /**
+   * @brief loadFrames loads the frames of a replay file
+   * @param path the path to the replay file
+   * @return the recorded frames
+   */
+  static std::vector<ReplayFrame> loadFrames(const std::string& path);
+  /**
+   * @brief overrideIMU replaces the IMU values of all following sensor readings
+   * @param imu the IMU values that are reported
+   */
+  void overrideIMU(const std::array<float, keys::sensor::IMU_MAX>& imu);
+  /**
+   * @brief clearIMUOverride reports the recorded (or synthetic) IMU values again
+   */
+  void clearIMUOverride();
+
+  void configure(Configuration& config, NaoInfo& naoInfo) override;
+  void setJointAngles(const std::vector<float>& angles) override;
+  void setJointStiffnesses(const std::vector<float>& stiffnesses) override;
+  void setLEDs(const std::vector<float>& leds) override;
+  void setSonar(const float sonar) override;
+  float waitAndReadSensorData(NaoSensorData& data) override;
+  std::string getFileRoot() override;
+  std::string getDataRoot() override;
+  void getNaoInfo(Configuration& config, NaoInfo& info) override;
+  CameraInterface& getCamera(const Camera camera) override;
+  FakeDataInterface& getFakeData() override;
+  AudioInterface& getAudio() override;
+  CameraInterface& getNextCamera() override;
+  Camera getCurrentCameraType() override;
+
+private:
+  /// the recorded frames (empty for synthetic data)
+  const std::vector<ReplayFrame> frames_;
+  /// the index of the frame that is read next
+  std::size_t frameIndex_;
+  /// the simulated time between two sensor readings in ms
+  const unsigned int period_;
+  /// the simulated time of the next sensor reading
+  TimePoint time_;
+  /// the last commanded joint angles
+  std::array<float, keys::joints::JOINTS_MAX> commandedAngles_;
+  /// whether the IMU values are overridden
+  bool imuOverridden_;
+  /// the IMU values that are reported if they are overridden
+  std::array<float, keys::sensor::IMU_MAX> imuOverride_;
+  /// the fake data interface (that does not provide any fake data)
+  MotionBenchmarkFakeData fakeData_;
+};
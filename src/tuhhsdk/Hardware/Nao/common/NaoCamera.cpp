@@ -23,6 +23,7 @@ NaoCamera::NaoCamera(const Camera camera)
   , fd_(-1)
   , fps_(0)
   , bufferCount_(0)
+  , maxQueuedFrames_(1)
   , buffersInitialized_(false)
   , resolution_(0, 0)
   , autoExposure_("autoExposure", V4L2_CID_EXPOSURE_AUTO)
@@ -35,10 +36,6 @@ NaoCamera::NaoCamera(const Camera camera)
   , sharpness_("sharpness", V4L2_CID_SHARPNESS)
   , whiteBalanceTemperature_("whiteBalanceTemperature", V4L2_CID_WHITE_BALANCE_TEMPERATURE, 0, true)
 {
-  std::memset(&currentBuffer_, 0, sizeof(currentBuffer_));
-  currentBuffer_.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-  currentBuffer_.memory = V4L2_MEMORY_MMAP;
-
   cameraControlSettings_.push_back(&autoExposure_);
   cameraControlSettings_.push_back(&autoWhiteBalance_);
   cameraControlSettings_.push_back(&brightness_);
@@ -48,9 +45,6 @@ NaoCamera::NaoCamera(const Camera camera)
   cameraControlSettings_.push_back(&saturation_);
   cameraControlSettings_.push_back(&sharpness_);
   cameraControlSettings_.push_back(&whiteBalanceTemperature_);
-
-  imageValid = false;
-  timestamp = 0;
 }
 
 NaoCamera::~NaoCamera()
@@ -71,7 +65,7 @@ bool NaoCamera::waitForCameras(std::array<NaoCamera*, 2> cameras, int timeout)
   for (std::size_t i = 0; i < cameras.size(); ++i)
   {
     // Only poll cameras without valid image
-    int fd = cameras[i]->imageValid ? -1 : cameras[i]->fd_;
+    int fd = cameras[i]->isImageValid() ? -1 : cameras[i]->fd_;
     pollfds[i] = {fd, POLLIN | POLLPRI, 0};
   }
 
@@ -92,25 +86,35 @@ bool NaoCamera::waitForCameras(std::array<NaoCamera*, 2> cameras, int timeout)
   {
     if (pollfds[i].revents & POLLIN)
     {
-      v4l2_buffer lastBuffer;
-      bool isFirstImage = true;
-
-      while (ioctl(cameras[i]->fd_, VIDIOC_DQBUF, &cameras[i]->currentBuffer_) == 0)
+      v4l2_buffer buffer;
+      std::memset(&buffer, 0, sizeof(buffer));
+      buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+      buffer.memory = V4L2_MEMORY_MMAP;
+
+      // Take all waiting buffers out of the driver queue. The newest ones are kept in the frame
+      // queue, older ones are dropped as soon as the queue is full.
+      while (ioctl(cameras[i]->fd_, VIDIOC_DQBUF, &buffer) == 0)
       {
-        if (isFirstImage)
-        {
-          isFirstImage = false;
-        }
-        else
+        // V4L2 gives the time at which the first pixel of the image was recorded as timeval
+        // "+ i * 1000": This is a hack! When top and bottom camera do have the same timestamp
+        //               one of them will be skipped in our current debug protocol impl.
+        const __u64 timestamp = static_cast<__u64>(buffer.timestamp.tv_sec) * 1000000ll +
+                                buffer.timestamp.tv_usec + i * 1000;
+        // This fix is needed as the first image that we get on the v6 hardware has a timestamp
+        // that does not make any sense (to @rkost, @nagua).
+        if (timestamp < TimePoint::getBaseTime())
         {
-          // Drop image if there is a newer one
-          if (ioctl(cameras[i]->fd_, VIDIOC_QBUF, &lastBuffer) < 0)
+          Log(LogLevel::WARNING) << "Camera timestamp smaller than base time (normal during the "
+                                    "first second(s)). Skipping image";
+          // The buffer is not wrapped into a frame, thus it has to be queued again here. Otherwise
+          // the camera would not be able to capture images anymore.
+          if (ioctl(cameras[i]->fd_, VIDIOC_QBUF, &buffer) < 0)
           {
-            throw std::runtime_error("Unable to requeue the buffer");
+            throw std::runtime_error("Unable to queue buffer.");
           }
-          Log(LogLevel::WARNING) << "Dropped a frame";
+          continue;
         }
-        lastBuffer = cameras[i]->currentBuffer_;
+        cameras[i]->enqueueFrame(buffer, timestamp);
       }
 
       // errno is EAGAIN if the nonblocking VIDIOC_DQBUF returned without an image availabe.
@@ -121,30 +125,6 @@ bool NaoCamera::waitForCameras(std::array<NaoCamera*, 2> cameras, int timeout)
         Log(LogLevel::ERROR) << "VIDEOC_DQBUF is != EAGAIN. No image available";
         return false;
       }
-      else
-      {
-        // V4L2 gives the time at which the first pixel of the image was recorded as timeval
-        // "+ i * 1000": This is a hack! When top and bottom camera do have the same timestamp
-        //               one of them will be skipped in our current debug protocol impl.
-        cameras[i]->timestamp =
-            static_cast<__u64>(cameras[i]->currentBuffer_.timestamp.tv_sec) * 1000000ll +
-            cameras[i]->currentBuffer_.timestamp.tv_usec + i * 1000;
-        // This fix is needed as the first image that we get on the v6 hardware has a timestamp
-        // that does not make any sense (to @rkost, @nagua).
-        cameras[i]->imageValid = cameras[i]->timestamp >= TimePoint::getBaseTime();
-        if (!cameras[i]->imageValid)
-        {
-          Log(LogLevel::WARNING) << "Camera timestamp smaller than base time (normal during the "
-                                    "first second(s)). Skipping image";
-          // We need to queue the current buffer again as we marked the image as invalid. This would
-          // cause releaseImage() to not queue the buffer again, thus the camera is not able to
-          // capture images anymore.
-          if (ioctl(cameras[i]->fd_, VIDIOC_QBUF, &cameras[i]->currentBuffer_) < 0)
-          {
-            throw std::runtime_error("Unable to queue buffer.");
-          }
-        }
-      }
     }
     else if (pollfds[i].revents)
     {
@@ -158,24 +138,98 @@ bool NaoCamera::waitForCameras(std::array<NaoCamera*, 2> cameras, int timeout)
 
 TimePoint NaoCamera::readImage(Image422& image)
 {
-  image.setData(reinterpret_cast<YCbCr422*>(bufferMem_[currentBuffer_.index]), resolution_);
+  assert(isImageValid());
+  const CameraFrame& frame = *frames_.front().handle;
+  image.setData(frame.data, frame.size);
+  return frame.timestamp;
+}
 
-  const unsigned int millisecondsSince1970 = timestamp / 1000;
-  return TimePoint(millisecondsSince1970 - TimePoint::getBaseTime());
+CameraFrameHandle NaoCamera::acquireFrame()
+{
+  return isImageValid() ? frames_.front().handle : nullptr;
 }
 
 void NaoCamera::releaseImage()
 {
-  if (imageValid)
+  if (isImageValid())
+  {
+    // The buffer is requeued as soon as no other handle on this frame exists anymore.
+    frames_.pop_front();
+  }
+}
+
+void NaoCamera::enqueueFrame(const v4l2_buffer& buffer, const __u64 timestamp)
+{
+  const unsigned int index = buffer.index;
+  assert(index < bufferCount_);
+  mapping_->descriptors[index] = buffer;
+
+  CameraFrame& frame = mapping_->frames[index];
+  frame.data = reinterpret_cast<YCbCr422*>(mapping_->memory[index]);
+  frame.size = resolution_;
+  const unsigned int millisecondsSince1970 = timestamp / 1000;
+  frame.timestamp = TimePoint(millisecondsSince1970 - TimePoint::getBaseTime());
+
+  // The frame itself is owned by the mapping, the handle keeps the mapping alive and gives the
+  // buffer back on deletion. It must not refer to the camera because it may be destroyed on any
+  // thread at any time.
+  std::shared_ptr<BufferMapping> mapping = mapping_;
+  frames_.push_back(
+      {CameraFrameHandle(&frame, [mapping, index](const CameraFrame*) { mapping->requeue(index); }),
+       timestamp});
+
+  while (frames_.size() > maxQueuedFrames_)
+  {
+    // Drop image if there is a newer one
+    frames_.pop_front();
+    Log(LogLevel::WARNING) << "Dropped a frame";
+  }
+}
+
+NaoCamera::BufferMapping::BufferMapping(int fd, unsigned int count)
+  : fd(fd)
+  , memory(count, nullptr)
+  , length(count, 0)
+  , descriptors(count)
+  , frames(count)
+  , active(true)
+{
+}
+
+NaoCamera::BufferMapping::~BufferMapping()
+{
+  for (unsigned int i = 0; i < memory.size(); i++)
   {
-    if (ioctl(fd_, VIDIOC_QBUF, &currentBuffer_) < 0)
+    if (memory[i])
     {
-      throw std::runtime_error("Unable to queue buffer");
+      munmap(memory[i], length[i]);
     }
-    imageValid = false;
   }
 }
 
+void NaoCamera::BufferMapping::requeue(unsigned int index)
+{
+  // Only the descriptor of this index is accessed which is not touched by the capture thread until
+  // the buffer is dequeued again.
+  std::lock_guard<std::mutex> lg(mutex);
+  if (!active)
+  {
+    return;
+  }
+  if (ioctl(fd, VIDIOC_QBUF, &descriptors[index]) < 0)
+  {
+    // Throwing is not possible here as this is called from a shared_ptr deleter.
+    Log(LogLevel::ERROR) << "Unable to requeue buffer " << index;
+    assert(false);
+  }
+}
+
+void NaoCamera::BufferMapping::deactivate()
+{
+  std::lock_guard<std::mutex> lg(mutex);
+  active = false;
+}
+
 void NaoCamera::startCapture()
 {
   Log(LogLevel::INFO) << "Starting capture for camera " << static_cast<int>(camera_);
@@ -255,8 +309,14 @@ void NaoCamera::createBuffers()
   v4l2_buffer buf;
   v4l2_requestbuffers reqbufs;
 
-  bufferMem_.resize(bufferCount_);
-  bufferLength_.resize(bufferCount_);
+  if (bufferCount_ < maxQueuedFrames_ + 2)
+  {
+    // One buffer must stay with the driver and one may be held by the Brain
+    throw std::runtime_error("bufferCount must be at least maxQueuedFrames + 2 in NaoCamera!");
+  }
+
+  // Mapped buffers are unmapped by the destructor of the mapping if anything fails below.
+  auto mapping = std::make_shared<BufferMapping>(fd_, bufferCount_);
 
   memset(&reqbufs, 0, sizeof(reqbufs));
   reqbufs.count = bufferCount_;
@@ -273,32 +333,21 @@ void NaoCamera::createBuffers()
     buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     if (ioctl(fd_, VIDIOC_QUERYBUF, &buf) < 0)
     {
-      for (--i; i >= 0; i--)
-      {
-        munmap(bufferMem_[i], bufferLength_[i]);
-      }
       throw std::runtime_error("Could not get buffer in NaoCamera!");
     }
-    bufferLength_[i] = buf.length;
-    bufferMem_[i] = (unsigned char*)mmap(0, bufferLength_[i], PROT_READ | PROT_WRITE, MAP_SHARED,
-                                         fd_, buf.m.offset);
-    if (bufferMem_[i] == MAP_FAILED)
+    void* memory = mmap(0, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, buf.m.offset);
+    if (memory == MAP_FAILED)
     {
-      for (--i; i >= 0; i--)
-      {
-        munmap(bufferMem_[i], bufferLength_[i]);
-      }
       throw std::runtime_error("Could not map buffer in NaoCamera!");
     }
+    mapping->length[i] = buf.length;
+    mapping->memory[i] = static_cast<unsigned char*>(memory);
     if (ioctl(fd_, VIDIOC_QBUF, &buf) < 0)
     {
-      for (; i >= 0; i--)
-      {
-        munmap(bufferMem_[i], bufferLength_[i]);
-      }
       throw std::runtime_error("Could not enqueue buffer in NaoCamera!");
     }
   }
+  mapping_ = std::move(mapping);
   buffersInitialized_ = true;
 }
 
@@ -308,19 +357,12 @@ void NaoCamera::clearBuffers()
   {
     return;
   }
-  // unmap buffers
-  for (unsigned int i = 0; i < bufferCount_; i++)
-  {
-    if (bufferMem_[i])
-    {
-      munmap(bufferMem_[i], bufferLength_[i]);
-      bufferMem_[i] = nullptr;
-    }
-  }
-  bufferMem_.clear();
-  bufferLength_.clear();
-
   buffersInitialized_ = false;
+  // Outstanding handles must not requeue buffers after the driver buffers are gone. Their memory
+  // stays mapped until the last of them has been destroyed.
+  mapping_->deactivate();
+  frames_.clear();
+  mapping_.reset();
 }
 
 void NaoCamera::onWhiteBalanceTemperatureChange()
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <deque>
 #include <linux/videodev2.h>
+#include <memory>
+#include <mutex>
 
 #include "Hardware/CameraInterface.hpp"
 #include "Hardware/RobotInterface.hpp"
@@ -46,8 +50,20 @@ public:
    * @return the time point at which the first pixel of the image was recorded
    */
   TimePoint readImage(Image422& image);
+  /**
+   * @brief acquireFrame returns a handle on the mmapped buffer of the current image
+   *
+   * The buffer is only queued to the driver again after releaseImage has been called and all
+   * handles have been destroyed. Handles may outlive the buffers of the camera (e.g. when they are
+   * recreated), the memory stays mapped until the last handle has been destroyed.
+   *
+   * @return a handle on the current frame or nullptr if there is no valid image
+   */
+  CameraFrameHandle acquireFrame();
   /**
    * @brief releaseImage is used to release the current image of the camera if available
+   *
+   * If newer frames have already been captured, the next one becomes the current image.
    */
   void releaseImage();
   /**
@@ -69,7 +85,7 @@ public:
    */
   bool isImageValid()
   {
-    return imageValid;
+    return !frames_.empty();
   }
   /**
    * @brief getTimeStamp returns when the image was taken only valid if the image is valid
@@ -77,7 +93,7 @@ public:
    */
   __u64 getTimeStamp()
   {
-    return timestamp;
+    return frames_.front().timestamp;
   }
 
 protected:
@@ -248,6 +264,60 @@ protected:
    * @brief clearBuffers clears the image buffers.
    */
   void clearBuffers();
+  /**
+   * @brief enqueueFrame wraps a freshly dequeued buffer into a frame handle and appends it to the
+   * frame queue, dropping the oldest frames if the queue is full
+   * @param buffer the buffer that has been dequeued from the driver
+   * @param timestamp the timestamp of the buffer in microseconds
+   */
+  void enqueueFrame(const v4l2_buffer& buffer, const __u64 timestamp);
+
+  /**
+   * @brief BufferMapping owns the mmapped buffers of one createBuffers call
+   *
+   * Every frame handle shares the ownership of the mapping it points into, so the memory is only
+   * unmapped after clearBuffers has been called and the last handle has been destroyed.
+   */
+  struct BufferMapping
+  {
+    /**
+     * @brief BufferMapping allocates the bookkeeping for a number of buffers (nothing is mapped)
+     * @param fd the file descriptor of the camera
+     * @param count the number of buffers
+     */
+    BufferMapping(int fd, unsigned int count);
+    /**
+     * @brief ~BufferMapping unmaps all buffers that have been mapped
+     */
+    ~BufferMapping();
+    /**
+     * @brief requeue gives a buffer back to the driver if the mapping is still active
+     *
+     * This may be called from any thread that held the last handle on the frame of the buffer.
+     *
+     * @param index the index of the buffer
+     */
+    void requeue(unsigned int index);
+    /**
+     * @brief deactivate stops requeueing buffers (must be called before the driver buffers are
+     * freed or the file descriptor is closed)
+     */
+    void deactivate();
+    /// the file descriptor of the camera handle
+    const int fd;
+    /// the start addresses of the mapped buffers (nullptr if not mapped)
+    std::vector<unsigned char*> memory;
+    /// the lengths of the mapped buffers
+    std::vector<unsigned int> length;
+    /// the v4l2 buffer descriptors indexed by buffer index (needed to requeue them)
+    std::vector<v4l2_buffer> descriptors;
+    /// the frame views on the mapped buffers indexed by buffer index
+    std::vector<CameraFrame> frames;
+    /// serializes requeueing against deactivation so that no ioctl happens on a stale descriptor
+    std::mutex mutex;
+    /// whether buffers are still given back to the driver (guarded by mutex)
+    bool active;
+  };
 
   /**
    * @brief onOrientationChange
@@ -275,16 +345,18 @@ protected:
   const std::string mount_;
   /// the file descriptor of the camera handle
   int fd_;
-  /// a vector of pointers to the buffers
-  std::vector<unsigned char*> bufferMem_;
-  /// a vector of the lengths of the buffers
-  std::vector<unsigned int> bufferLength_;
-  /// the currently used buffer
-  v4l2_buffer currentBuffer_;
-  /// is current buffer valid
-  bool imageValid;
-  /// the timestamp of the current buffer
-  __u64 timestamp;
+  /// the mapping of the current buffers (shared with all frame handles)
+  std::shared_ptr<BufferMapping> mapping_;
+  /// a buffer that has been dequeued from the driver together with its kernel timestamp
+  struct QueuedFrame
+  {
+    /// the handle keeping the buffer out of the driver queue
+    CameraFrameHandle handle;
+    /// the time at which the first pixel has been recorded in microseconds since 1970
+    __u64 timestamp;
+  };
+  /// the dequeued frames that have not been released yet, oldest first (front is current image)
+  std::deque<QueuedFrame> frames_;
   /// information about the nao version the executable is running on
   NaoInfo naoInfo_;
 
@@ -297,8 +369,10 @@ protected:
   unsigned int fps_;
   /// the number of buffers
   unsigned int bufferCount_;
+  /// the maximum number of captured frames that are kept before the oldest one is dropped
+  unsigned int maxQueuedFrames_;
   /// whether the buffers are actually initialized
-  bool buffersInitialized_;
+  std::atomic<bool> buffersInitialized_;
   /// the desired image resolution
   Vector2i resolution_;
 
@@ -0,0 +1,84 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Hardware/Nao/v6/LoLACodec.hpp"
+
+/*
+ * This benchmarks the LoLA message handling of the NaoInterface without a robot.
+ *
+ * Usage: lolaBenchmark <captured LoLA stream> [<iterations>]
+ *
+ * The capture is the raw byte stream that LoLA sends over its socket, i.e. a sequence of state
+ * messages of LoLADatumSize bytes each. Every message is decoded and an actuator message is
+ * encoded for the given number of iterations.
+ */
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <captured LoLA stream> [<iterations>]\n";
+    return EXIT_FAILURE;
+  }
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file.is_open())
+  {
+    std::cerr << "Could not open " << argv[1] << "\n";
+    return EXIT_FAILURE;
+  }
+  const std::vector<char> capture((std::istreambuf_iterator<char>(file)),
+                                  std::istreambuf_iterator<char>());
+  const std::size_t numberOfMessages = capture.size() / LoLADatumSize;
+  if (numberOfMessages == 0)
+  {
+    std::cerr << "The capture does not contain a complete LoLA message\n";
+    return EXIT_FAILURE;
+  }
+  const std::size_t iterations = argc > 2 ? std::stoul(argv[2]) : 10000;
+
+  // The shared block is too large for the stack.
+  auto block = std::make_unique<SharedBlock>();
+  LoLAStateDecoder decoder;
+  LoLAActuatorEncoder encoder;
+
+  const auto decodeStart = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; i++)
+  {
+    for (std::size_t message = 0; message < numberOfMessages; message++)
+    {
+      decoder.decode(capture.data() + message * LoLADatumSize, LoLADatumSize, *block);
+    }
+  }
+  const auto decodeEnd = std::chrono::steady_clock::now();
+  std::size_t checksum = 0;
+  for (std::size_t i = 0; i < iterations * numberOfMessages; i++)
+  {
+    block->commandAngles[i % block->commandAngles.size()] = static_cast<float>(i);
+    encoder.encode(*block);
+    checksum += static_cast<unsigned char>(encoder.data()[i % encoder.size()]);
+  }
+  const auto encodeEnd = std::chrono::steady_clock::now();
+
+  const double decodings = static_cast<double>(iterations * numberOfMessages);
+  std::cout << "messages:          " << numberOfMessages << "\n";
+  std::cout << "decode [ns/msg]:   "
+            << std::chrono::duration<double, std::nano>(decodeEnd - decodeStart).count() / decodings
+            << "\n";
+  std::cout << "encode [ns/msg]:   "
+            << std::chrono::duration<double, std::nano>(encodeEnd - decodeEnd).count() / decodings
+            << "\n";
+  std::cout << "actuator msg size: " << encoder.size() << " (checksum " << checksum << ")\n";
+  std::cout << "last joint angles:";
+  for (const auto angle : block->jointSensor)
+  {
+    std::cout << " " << angle;
+  }
+  std::cout << "\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,492 @@
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+#include "LoLACodec.hpp"
+
+namespace
+{
+  using namespace keys::joints;
+  using namespace keys::led;
+  using namespace keys::sensor;
+
+  // The order of the values in the arrays of LoLA.
+  // Don't forget R_HIP_YAW_PITCH
+  constexpr std::array<enumJoints, 25> jointsRemapping = {
+      {HEAD_YAW,     HEAD_PITCH,    L_SHOULDER_PITCH, L_SHOULDER_ROLL,  L_ELBOW_YAW,
+       L_ELBOW_ROLL, L_WRIST_YAW,   L_HIP_YAW_PITCH,  L_HIP_ROLL,       L_HIP_PITCH,
+       L_KNEE_PITCH, L_ANKLE_PITCH, L_ANKLE_ROLL,     R_HIP_ROLL,       R_HIP_PITCH,
+       R_KNEE_PITCH, R_ANKLE_PITCH, R_ANKLE_ROLL,     R_SHOULDER_PITCH, R_SHOULDER_ROLL,
+       R_ELBOW_YAW,  R_ELBOW_ROLL,  R_WRIST_YAW,      L_HAND,           R_HAND}};
+  constexpr std::array<battery, 4> batteryRemapping = {
+      {BATTERY_CHARGE, BATTERY_STATUS, BATTERY_CURRENT, BATTERY_TEMPERATURE}};
+  constexpr std::array<switches, 14> switchesRemapping = {
+      {SWITCH_CHEST_BUTTON, SWITCH_HEAD_FRONT, SWITCH_HEAD_MIDDLE, SWITCH_HEAD_REAR,
+       SWITCH_L_FOOT_LEFT, SWITCH_L_FOOT_RIGHT, SWITCH_L_HAND_BACK, SWITCH_L_HAND_LEFT,
+       SWITCH_L_HAND_RIGHT, SWITCH_R_FOOT_LEFT, SWITCH_R_FOOT_RIGHT, SWITCH_R_HAND_BACK,
+       SWITCH_R_HAND_LEFT, SWITCH_R_HAND_RIGHT}};
+  constexpr std::array<int, 2> sonarRemapping = {{SONAR_LEFT_SENSOR_0, SONAR_RIGHT_SENSOR_0}};
+  constexpr std::array<int, 4> fsrRemapping = {
+      {FSR_FRONT_LEFT, FSR_FRONT_RIGHT, FSR_REAR_LEFT, FSR_REAR_RIGHT}};
+  constexpr std::array<imu, 3> accelerometerRemapping = {{IMU_ACC_X, IMU_ACC_Y, IMU_ACC_Z}};
+  constexpr std::array<imu, 2> anglesRemapping = {{IMU_ANGLE_X, IMU_ANGLE_Y}};
+  constexpr std::array<imu, 3> gyroscopeRemapping = {{IMU_GYR_X, IMU_GYR_Y, IMU_GYR_Z}};
+
+  constexpr std::array<int, 3> colorRemapping = {{2, 1, 0}};
+  constexpr std::array<int, 10> lEarRemapping = {{EAR_DEG_0, EAR_DEG_36, EAR_DEG_72, EAR_DEG_108,
+                                                   EAR_DEG_144, EAR_DEG_180, EAR_DEG_216,
+                                                   EAR_DEG_252, EAR_DEG_288, EAR_DEG_324}};
+  constexpr std::array<int, 10> rEarRemapping = {{EAR_DEG_324, EAR_DEG_288, EAR_DEG_252,
+                                                   EAR_DEG_216, EAR_DEG_180, EAR_DEG_144,
+                                                   EAR_DEG_108, EAR_DEG_72, EAR_DEG_36, EAR_DEG_0}};
+  constexpr std::array<int, 12> skullRemapping = {
+      {HEAD_REAR_RIGHT_2, HEAD_REAR_RIGHT_1, HEAD_REAR_RIGHT_0, HEAD_REAR_LEFT_2, HEAD_REAR_LEFT_1,
+       HEAD_REAR_LEFT_0, HEAD_MIDDLE_RIGHT_0, HEAD_MIDDLE_LEFT_0, HEAD_FRONT_RIGHT_1,
+       HEAD_FRONT_RIGHT_0, HEAD_FRONT_LEFT_1, HEAD_FRONT_LEFT_0}};
+  constexpr std::array<int, 24> lEyeRemapping = {
+      {EYE_RED_DEG_45,    EYE_RED_DEG_0,     EYE_RED_DEG_315,   EYE_RED_DEG_270,
+       EYE_RED_DEG_225,   EYE_RED_DEG_180,   EYE_RED_DEG_135,   EYE_RED_DEG_90,
+       EYE_GREEN_DEG_45,  EYE_GREEN_DEG_0,   EYE_GREEN_DEG_315, EYE_GREEN_DEG_270,
+       EYE_GREEN_DEG_225, EYE_GREEN_DEG_180, EYE_GREEN_DEG_135, EYE_GREEN_DEG_90,
+       EYE_BLUE_DEG_45,   EYE_BLUE_DEG_0,    EYE_BLUE_DEG_315,  EYE_BLUE_DEG_270,
+       EYE_BLUE_DEG_225,  EYE_BLUE_DEG_180,  EYE_BLUE_DEG_135,  EYE_BLUE_DEG_90}};
+  constexpr std::array<int, 24> rEyeRemapping = {
+      {EYE_RED_DEG_0,     EYE_RED_DEG_45,    EYE_RED_DEG_90,    EYE_RED_DEG_135,
+       EYE_RED_DEG_180,   EYE_RED_DEG_225,   EYE_RED_DEG_270,   EYE_RED_DEG_315,
+       EYE_GREEN_DEG_0,   EYE_GREEN_DEG_45,  EYE_GREEN_DEG_90,  EYE_GREEN_DEG_135,
+       EYE_GREEN_DEG_180, EYE_GREEN_DEG_225, EYE_GREEN_DEG_270, EYE_GREEN_DEG_315,
+       EYE_BLUE_DEG_0,    EYE_BLUE_DEG_45,   EYE_BLUE_DEG_90,   EYE_BLUE_DEG_135,
+       EYE_BLUE_DEG_180,  EYE_BLUE_DEG_225,  EYE_BLUE_DEG_270,  EYE_BLUE_DEG_315}};
+
+  /// the size of a msgpack float32 (format byte and four bytes of data)
+  constexpr std::size_t floatSlotSize = 5;
+
+  /**
+   * @brief StringView references a string inside of a message
+   */
+  struct StringView
+  {
+    /// the first character of the string
+    const char* data;
+    /// the number of characters of the string
+    std::uint32_t length;
+    /**
+     * @brief operator== compares with a null terminated string
+     * @param string the null terminated string
+     * @return true iff both strings are equal
+     */
+    bool operator==(const char* string) const
+    {
+      return std::strncmp(data, string, length) == 0 && string[length] == '\0';
+    }
+  };
+
+  /**
+   * @brief LoLAReader is a cursor over a msgpack message that supports the types used by LoLA
+   */
+  class LoLAReader
+  {
+  public:
+    /**
+     * @brief LoLAReader creates a cursor at the beginning of a message
+     * @param data the message
+     * @param size the number of bytes of the message
+     */
+    LoLAReader(const char* data, const std::size_t size)
+      : data_(reinterpret_cast<const std::uint8_t*>(data))
+      , end_(data_ + size)
+    {
+    }
+    /**
+     * @brief readMapSize reads the header of a map
+     * @return the number of key value pairs in the map
+     */
+    std::uint32_t readMapSize()
+    {
+      const std::uint8_t format = readByte();
+      if ((format & 0xf0) == 0x80)
+      {
+        return format & 0x0f;
+      }
+      else if (format == 0xde)
+      {
+        return readBigEndian<std::uint16_t>();
+      }
+      else if (format == 0xdf)
+      {
+        return readBigEndian<std::uint32_t>();
+      }
+      throw std::runtime_error("Wrong msgpack type from LoLA, expected MAP!");
+    }
+    /**
+     * @brief readArraySize reads the header of an array
+     * @return the number of elements in the array
+     */
+    std::uint32_t readArraySize()
+    {
+      const std::uint8_t format = readByte();
+      if ((format & 0xf0) == 0x90)
+      {
+        return format & 0x0f;
+      }
+      else if (format == 0xdc)
+      {
+        return readBigEndian<std::uint16_t>();
+      }
+      else if (format == 0xdd)
+      {
+        return readBigEndian<std::uint32_t>();
+      }
+      throw std::runtime_error("Wrong msgpack type from LoLA, expected ARRAY!");
+    }
+    /**
+     * @brief readString reads a string without copying it
+     * @return a view of the string in the message
+     */
+    StringView readString()
+    {
+      const std::uint32_t length = readStringLength();
+      require(length);
+      const StringView string{reinterpret_cast<const char*>(data_), length};
+      data_ += length;
+      return string;
+    }
+    /**
+     * @brief readFloat reads a number (float, integer or bool) and converts it to float
+     * @return the number
+     */
+    float readFloat()
+    {
+      const std::uint8_t format = readByte();
+      if (format <= 0x7f || format >= 0xe0)
+      {
+        return static_cast<float>(static_cast<std::int8_t>(format));
+      }
+      switch (format)
+      {
+        case 0xc2:
+          return 0.f;
+        case 0xc3:
+          return 1.f;
+        case 0xca:
+        {
+          const std::uint32_t bits = readBigEndian<std::uint32_t>();
+          float value;
+          std::memcpy(&value, &bits, sizeof(value));
+          return value;
+        }
+        case 0xcb:
+        {
+          const std::uint64_t bits = readBigEndian<std::uint64_t>();
+          double value;
+          std::memcpy(&value, &bits, sizeof(value));
+          return static_cast<float>(value);
+        }
+        case 0xcc:
+          return readBigEndian<std::uint8_t>();
+        case 0xcd:
+          return readBigEndian<std::uint16_t>();
+        case 0xce:
+          return static_cast<float>(readBigEndian<std::uint32_t>());
+        case 0xcf:
+          return static_cast<float>(readBigEndian<std::uint64_t>());
+        case 0xd0:
+          return static_cast<std::int8_t>(readBigEndian<std::uint8_t>());
+        case 0xd1:
+          return static_cast<std::int16_t>(readBigEndian<std::uint16_t>());
+        case 0xd2:
+          return static_cast<float>(static_cast<std::int32_t>(readBigEndian<std::uint32_t>()));
+        case 0xd3:
+          return static_cast<float>(static_cast<std::int64_t>(readBigEndian<std::uint64_t>()));
+        default:
+          throw std::runtime_error("Wrong msgpack type from LoLA, expected a number!");
+      }
+    }
+    /**
+     * @brief readFloats reads an array of numbers into a remapped destination
+     * @param destination the array to which the values are written
+     * @param remapping the index in destination for each element of the msgpack array
+     */
+    template <typename Destination, typename Remapping>
+    void readFloats(Destination& destination, const Remapping& remapping)
+    {
+      if (readArraySize() != remapping.size())
+      {
+        throw std::runtime_error("Unexpected array size in LoLA message!");
+      }
+      for (const auto index : remapping)
+      {
+        destination[index] = readFloat();
+      }
+    }
+    /**
+     * @brief skip skips the next value (including all elements of arrays and maps)
+     */
+    void skip()
+    {
+      require(1);
+      const std::uint8_t format = *data_;
+      if ((format & 0xf0) == 0x80 || format == 0xde || format == 0xdf)
+      {
+        for (std::uint32_t i = readMapSize(); i > 0; i--)
+        {
+          skip();
+          skip();
+        }
+      }
+      else if ((format & 0xf0) == 0x90 || format == 0xdc || format == 0xdd)
+      {
+        for (std::uint32_t i = readArraySize(); i > 0; i--)
+        {
+          skip();
+        }
+      }
+      else if ((format & 0xe0) == 0xa0 || (format >= 0xd9 && format <= 0xdb))
+      {
+        const std::uint32_t length = readStringLength();
+        require(length);
+        data_ += length;
+      }
+      else if (format == 0xc0)
+      {
+        data_++;
+      }
+      else
+      {
+        readFloat();
+      }
+    }
+
+  private:
+    /**
+     * @brief readStringLength reads the header of a string
+     * @return the length of the string in bytes
+     */
+    std::uint32_t readStringLength()
+    {
+      const std::uint8_t format = readByte();
+      if ((format & 0xe0) == 0xa0)
+      {
+        return format & 0x1f;
+      }
+      else if (format == 0xd9)
+      {
+        return readBigEndian<std::uint8_t>();
+      }
+      else if (format == 0xda)
+      {
+        return readBigEndian<std::uint16_t>();
+      }
+      else if (format == 0xdb)
+      {
+        return readBigEndian<std::uint32_t>();
+      }
+      throw std::runtime_error("Wrong msgpack type from LoLA, expected STR!");
+    }
+    /**
+     * @brief readByte reads a single byte
+     * @return the byte
+     */
+    std::uint8_t readByte()
+    {
+      require(1);
+      return *data_++;
+    }
+    /**
+     * @brief readBigEndian reads an unsigned integer in network byte order
+     * @tparam T the unsigned integer type
+     * @return the integer
+     */
+    template <typename T>
+    T readBigEndian()
+    {
+      require(sizeof(T));
+      T value = 0;
+      for (std::size_t i = 0; i < sizeof(T); i++)
+      {
+        value = static_cast<T>((value << 8) | data_[i]);
+      }
+      data_ += sizeof(T);
+      return value;
+    }
+    /**
+     * @brief require ensures that the message contains a number of further bytes
+     * @param size the number of bytes
+     */
+    void require(const std::size_t size) const
+    {
+      if (static_cast<std::size_t>(end_ - data_) < size)
+      {
+        throw std::runtime_error("Unexpected end of LoLA message!");
+      }
+    }
+
+    /// the current position in the message
+    const std::uint8_t* data_;
+    /// the end of the message
+    const std::uint8_t* end_;
+  };
+} // namespace
+
+void LoLAStateDecoder::decode(const char* data, const std::size_t size, SharedBlock& block) const
+{
+  LoLAReader reader(data, size);
+  for (std::uint32_t i = reader.readMapSize(); i > 0; i--)
+  {
+    const StringView key = reader.readString();
+    if (key == "Accelerometer")
+    {
+      reader.readFloats(block.imu, accelerometerRemapping);
+    }
+    else if (key == "Angles")
+    {
+      reader.readFloats(block.imu, anglesRemapping);
+    }
+    else if (key == "Battery")
+    {
+      reader.readFloats(block.battery, batteryRemapping);
+    }
+    else if (key == "Current")
+    {
+      reader.readFloats(block.jointCurrent, jointsRemapping);
+    }
+    else if (key == "FSR")
+    {
+      // The first four values belong to the left foot, the other four to the right foot.
+      if (reader.readArraySize() != 2 * fsrRemapping.size())
+      {
+        throw std::runtime_error("Unexpected array size in LoLA message!");
+      }
+      for (const auto index : fsrRemapping)
+      {
+        block.fsrLeft[index] = reader.readFloat();
+      }
+      for (const auto index : fsrRemapping)
+      {
+        block.fsrRight[index] = reader.readFloat();
+      }
+    }
+    else if (key == "Gyroscope")
+    {
+      reader.readFloats(block.imu, gyroscopeRemapping);
+    }
+    else if (key == "Position")
+    {
+      reader.readFloats(block.jointSensor, jointsRemapping);
+    }
+    else if (key == "Sonar")
+    {
+      reader.readFloats(block.sonar, sonarRemapping);
+    }
+    else if (key == "Temperature")
+    {
+      reader.readFloats(block.jointTemperature, jointsRemapping);
+    }
+    else if (key == "Touch")
+    {
+      reader.readFloats(block.switches, switchesRemapping);
+    }
+    else if (key == "Status")
+    {
+      reader.readFloats(block.jointStatus, jointsRemapping);
+    }
+    else
+    {
+      // RobotConfig and Stiffness are not needed
+      reader.skip();
+    }
+  }
+  // LoLA has only one hip yaw pitch joint.
+  for (auto* joints : {&block.jointCurrent, &block.jointSensor, &block.jointTemperature,
+                       &block.jointStatus})
+  {
+    (*joints)[R_HIP_YAW_PITCH] = (*joints)[L_HIP_YAW_PITCH];
+  }
+}
+
+LoLAActuatorEncoder::LoLAActuatorEncoder()
+  : fieldOffsets_()
+{
+  // This is the same layout that has been created with msgpack::packer before. The floats are
+  // always stored as float32 such that every value has a fixed position.
+  buffer_.reserve(1024);
+  buffer_.push_back(static_cast<char>(0x80 | 11));
+  appendFloatArray(CHEST, "Chest", colorRemapping.size());
+  appendFloatArray(L_EAR, "LEar", lEarRemapping.size());
+  appendFloatArray(L_EYE, "LEye", lEyeRemapping.size());
+  appendFloatArray(L_FOOT, "LFoot", colorRemapping.size());
+  appendFloatArray(POSITION, "Position", jointsRemapping.size());
+  appendFloatArray(R_EAR, "REar", rEarRemapping.size());
+  appendFloatArray(R_EYE, "REye", rEyeRemapping.size());
+  appendFloatArray(R_FOOT, "RFoot", colorRemapping.size());
+  appendFloatArray(SKULL, "Skull", skullRemapping.size());
+  // The sonar is always enabled.
+  appendString("Sonar");
+  buffer_.push_back(static_cast<char>(0x90 | 2));
+  buffer_.push_back(static_cast<char>(0xc3));
+  buffer_.push_back(static_cast<char>(0xc3));
+  appendFloatArray(STIFFNESS, "Stiffness", jointsRemapping.size());
+}
+
+void LoLAActuatorEncoder::encode(const SharedBlock& block)
+{
+  const float* leds = block.commandLEDs.data();
+  patchFloats(CHEST, leds, colorRemapping);
+  patchFloats(L_EAR, leds + CHEST_MAX, lEarRemapping);
+  patchFloats(L_EYE, leds + CHEST_MAX + 2 * EAR_MAX, lEyeRemapping);
+  patchFloats(L_FOOT, leds + CHEST_MAX + 2 * EAR_MAX + 2 * EYE_MAX + HEAD_MAX, colorRemapping);
+  patchFloats(POSITION, block.commandAngles.data(), jointsRemapping);
+  patchFloats(R_EAR, leds + CHEST_MAX + EAR_MAX, rEarRemapping);
+  patchFloats(R_EYE, leds + CHEST_MAX + 2 * EAR_MAX + EYE_MAX, rEyeRemapping);
+  patchFloats(R_FOOT, leds + CHEST_MAX + 2 * EAR_MAX + 2 * EYE_MAX + HEAD_MAX + FOOT_MAX,
+              colorRemapping);
+  patchFloats(SKULL, leds + CHEST_MAX + 2 * EAR_MAX + 2 * EYE_MAX, skullRemapping);
+  patchFloats(STIFFNESS, block.commandStiffnesses.data(), jointsRemapping);
+}
+
+template <typename Remapping>
+void LoLAActuatorEncoder::patchFloats(const Field field, const float* source,
+                                      const Remapping& remapping)
+{
+  // skip the format byte of the first float
+  char* slot = buffer_.data() + fieldOffsets_[field] + 1;
+  for (const auto index : remapping)
+  {
+    std::uint32_t bits;
+    std::memcpy(&bits, source + index, sizeof(bits));
+    slot[0] = static_cast<char>(bits >> 24);
+    slot[1] = static_cast<char>(bits >> 16);
+    slot[2] = static_cast<char>(bits >> 8);
+    slot[3] = static_cast<char>(bits);
+    slot += floatSlotSize;
+  }
+}
+
+void LoLAActuatorEncoder::appendFloatArray(const Field field, const char* key,
+                                           const std::size_t size)
+{
+  assert(size <= 0xffff);
+  appendString(key);
+  if (size < 16)
+  {
+    buffer_.push_back(static_cast<char>(0x90 | size));
+  }
+  else
+  {
+    buffer_.insert(buffer_.end(), {static_cast<char>(0xdc), static_cast<char>(size >> 8),
+                                   static_cast<char>(size & 0xff)});
+  }
+  fieldOffsets_[field] = buffer_.size();
+  for (std::size_t i = 0; i < size; i++)
+  {
+    buffer_.insert(buffer_.end(), {static_cast<char>(0xca), 0, 0, 0, 0});
+  }
+}
+
+void LoLAActuatorEncoder::appendString(const char* string)
+{
+  const std::size_t length = std::strlen(string);
+  assert(length < 32);
+  buffer_.push_back(static_cast<char>(0xa0 | length));
+  buffer_.insert(buffer_.end(), string, string + length);
+}
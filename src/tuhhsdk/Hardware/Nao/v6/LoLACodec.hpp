@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Hardware/Nao/common/SMO.h"
+
+/// the size of a single state message from LoLA
+constexpr const std::size_t LoLADatumSize = 896;
+
+/**
+ * @brief LoLAStateDecoder decodes the msgpack state messages of LoLA
+ *
+ * The decoder walks the message in place and writes the sensor values directly into the arrays of
+ * a SharedBlock. It neither builds a msgpack object tree nor allocates memory. The entries of the
+ * map are identified by their keys, the order of the entries is not relevant.
+ */
+class LoLAStateDecoder
+{
+public:
+  /**
+   * @brief decode decodes a LoLA state message
+   *
+   * The RobotConfig and Stiffness entries are skipped. Throws a std::runtime_error if the message
+   * does not have the expected structure.
+   * @param data the message
+   * @param size the number of bytes of the message (may include trailing bytes)
+   * @param block the block in which the sensor values are stored
+   */
+  void decode(const char* data, std::size_t size, SharedBlock& block) const;
+};
+
+/**
+ * @brief LoLAActuatorEncoder encodes the actuator messages for LoLA
+ *
+ * The structure of the actuator message never changes. Therefore, the message is serialized once
+ * with placeholders and only the float values are patched in each cycle.
+ */
+class LoLAActuatorEncoder
+{
+public:
+  /**
+   * @brief LoLAActuatorEncoder serializes the message layout
+   */
+  LoLAActuatorEncoder();
+  /**
+   * @brief encode writes the commands of a block into the message
+   * @param block the block that contains the command angles, stiffnesses and LEDs
+   */
+  void encode(const SharedBlock& block);
+  /**
+   * @brief data returns the serialized message
+   * @return a pointer to the first byte of the message
+   */
+  const char* data() const
+  {
+    return buffer_.data();
+  }
+  /**
+   * @brief size returns the size of the serialized message
+   * @return the number of bytes of the message
+   */
+  std::size_t size() const
+  {
+    return buffer_.size();
+  }
+
+private:
+  /// the fields of the actuator message that contain floats
+  enum Field
+  {
+    CHEST,
+    L_EAR,
+    L_EYE,
+    L_FOOT,
+    POSITION,
+    R_EAR,
+    R_EYE,
+    R_FOOT,
+    SKULL,
+    STIFFNESS,
+    FIELD_MAX
+  };
+  /**
+   * @brief patchFloats writes remapped values into the float slots of a field
+   * @tparam Remapping an indexable container of indices into the source
+   * @param field the field that is patched
+   * @param source the values
+   * @param remapping the index in source for each float slot of the field
+   */
+  template <typename Remapping>
+  void patchFloats(Field field, const float* source, const Remapping& remapping);
+  /**
+   * @brief appendFloatArray appends a key and an array of float placeholders to the layout
+   * @param field the field that is appended
+   * @param key the key of the field
+   * @param size the number of floats in the array
+   */
+  void appendFloatArray(Field field, const char* key, std::size_t size);
+  /**
+   * @brief appendString appends a msgpack string to the layout
+   * @param string a null terminated string with less than 32 characters
+   */
+  void appendString(const char* string);
+
+  /// the serialized message
+  std::vector<char> buffer_;
+  /// the offset of the first float slot of each field in the buffer
+  std::array<std::size_t, FIELD_MAX> fieldOffsets_;
+};
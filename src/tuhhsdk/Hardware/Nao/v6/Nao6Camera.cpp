@@ -53,6 +53,7 @@ void Nao6Camera::configure(Configuration& config, NaoInfo& naoInfo)
   config.mount(mount_, mount_ + mountSuffix + ".json", ConfigurationType::HEAD);
 
   config.get(mount_, "bufferCount") >> bufferCount_;
+  config.get(mount_, "maxQueuedFrames") >> maxQueuedFrames_;
   config.get(mount_, "fps") >> fps_;
   config.get(mount_, "resolution") >> resolution_;
 
@@ -41,48 +41,6 @@ NaoInterface::NaoInterface()
   socket_.connect(lolaEndpoint_);
 
 
-  // Manage the remapping of the joint data
-  {
-    using namespace keys::joints;
-    using namespace keys::sensor;
-    using namespace keys::led;
-    // Don't forget R_HIP_YAW_PITCH
-    jointsRemapping_ = {
-        HEAD_YAW,     HEAD_PITCH,    L_SHOULDER_PITCH, L_SHOULDER_ROLL,  L_ELBOW_YAW,
-        L_ELBOW_ROLL, L_WRIST_YAW,   L_HIP_YAW_PITCH,  L_HIP_ROLL,       L_HIP_PITCH,
-        L_KNEE_PITCH, L_ANKLE_PITCH, L_ANKLE_ROLL,     R_HIP_ROLL,       R_HIP_PITCH,
-        R_KNEE_PITCH, R_ANKLE_PITCH, R_ANKLE_ROLL,     R_SHOULDER_PITCH, R_SHOULDER_ROLL,
-        R_ELBOW_YAW,  R_ELBOW_ROLL,  R_WRIST_YAW,      L_HAND,           R_HAND};
-    batteryRemapping_ = {BATTERY_CHARGE, BATTERY_STATUS, BATTERY_CURRENT, BATTERY_TEMPERATURE};
-    switchesRemapping_ = {SWITCH_CHEST_BUTTON, SWITCH_HEAD_FRONT,   SWITCH_HEAD_MIDDLE,
-                          SWITCH_HEAD_REAR,    SWITCH_L_FOOT_LEFT,  SWITCH_L_FOOT_RIGHT,
-                          SWITCH_L_HAND_BACK,  SWITCH_L_HAND_LEFT,  SWITCH_L_HAND_RIGHT,
-                          SWITCH_R_FOOT_LEFT,  SWITCH_R_FOOT_RIGHT, SWITCH_R_HAND_BACK,
-                          SWITCH_R_HAND_LEFT,  SWITCH_R_HAND_RIGHT};
-
-    colorRemapping_ = {2, 1, 0};
-    lEarRemapping_ = {EAR_DEG_0,   EAR_DEG_36,  EAR_DEG_72,  EAR_DEG_108, EAR_DEG_144,
-                      EAR_DEG_180, EAR_DEG_216, EAR_DEG_252, EAR_DEG_288, EAR_DEG_324};
-    rEarRemapping_ = {EAR_DEG_324, EAR_DEG_288, EAR_DEG_252, EAR_DEG_216, EAR_DEG_180,
-                      EAR_DEG_144, EAR_DEG_108, EAR_DEG_72,  EAR_DEG_36,  EAR_DEG_0};
-    skullRemapping_ = {HEAD_REAR_RIGHT_2,   HEAD_REAR_RIGHT_1,  HEAD_REAR_RIGHT_0,
-                       HEAD_REAR_LEFT_2,    HEAD_REAR_LEFT_1,   HEAD_REAR_LEFT_0,
-                       HEAD_MIDDLE_RIGHT_0, HEAD_MIDDLE_LEFT_0, HEAD_FRONT_RIGHT_1,
-                       HEAD_FRONT_RIGHT_0,  HEAD_FRONT_LEFT_1,  HEAD_FRONT_LEFT_0};
-    lEyeRemapping_ = {EYE_RED_DEG_45,    EYE_RED_DEG_0,     EYE_RED_DEG_315,   EYE_RED_DEG_270,
-                      EYE_RED_DEG_225,   EYE_RED_DEG_180,   EYE_RED_DEG_135,   EYE_RED_DEG_90,
-                      EYE_GREEN_DEG_45,  EYE_GREEN_DEG_0,   EYE_GREEN_DEG_315, EYE_GREEN_DEG_270,
-                      EYE_GREEN_DEG_225, EYE_GREEN_DEG_180, EYE_GREEN_DEG_135, EYE_GREEN_DEG_90,
-                      EYE_BLUE_DEG_45,   EYE_BLUE_DEG_0,    EYE_BLUE_DEG_315,  EYE_BLUE_DEG_270,
-                      EYE_BLUE_DEG_225,  EYE_BLUE_DEG_180,  EYE_BLUE_DEG_135,  EYE_BLUE_DEG_90};
-    rEyeRemapping_ = {EYE_RED_DEG_0,     EYE_RED_DEG_45,    EYE_RED_DEG_90,    EYE_RED_DEG_135,
-                      EYE_RED_DEG_180,   EYE_RED_DEG_225,   EYE_RED_DEG_270,   EYE_RED_DEG_315,
-                      EYE_GREEN_DEG_0,   EYE_GREEN_DEG_45,  EYE_GREEN_DEG_90,  EYE_GREEN_DEG_135,
-                      EYE_GREEN_DEG_180, EYE_GREEN_DEG_225, EYE_GREEN_DEG_270, EYE_GREEN_DEG_315,
-                      EYE_BLUE_DEG_0,    EYE_BLUE_DEG_45,   EYE_BLUE_DEG_90,   EYE_BLUE_DEG_135,
-                      EYE_BLUE_DEG_180,  EYE_BLUE_DEG_225,  EYE_BLUE_DEG_270,  EYE_BLUE_DEG_315};
-  }
-
   auto extractNaoInfoMapValue = [&](msgpack::object& value, keys::naoinfos::naoinfo dst) {
     if (value.type != msgpack::type::STR)
     {
@@ -249,41 +207,9 @@ float NaoInterface::waitAndReadSensorData(NaoSensorData& data)
         dataBlock_.commandLEDs.data() + CHEST_MAX + 2 * EAR_MAX + 2 * EYE_MAX);
   }
 
-  // assemble all data to send to LoLA
-  {
-    using namespace keys::led;
-    sbuf_.clear();
-    msgpack::packer<msgpack::sbuffer> packer(sbuf_);
-    packer.pack_map(11); // 11
-    packFloatArray(packer, dataBlock_.commandLEDs.data(), colorRemapping_, "Chest");
-    packFloatArray(packer, dataBlock_.commandLEDs.data() + CHEST_MAX, lEarRemapping_, "LEar");
-    packFloatArray(packer, dataBlock_.commandLEDs.data() + CHEST_MAX + 2 * EAR_MAX, lEyeRemapping_,
-                   "LEye");
-    packFloatArray(packer,
-                   dataBlock_.commandLEDs.data() + CHEST_MAX + 2 * EAR_MAX + 2 * EYE_MAX + HEAD_MAX,
-                   colorRemapping_, "LFoot");
-    packJoints(packer, dataBlock_.commandAngles, "Position");
-    packFloatArray(packer, dataBlock_.commandLEDs.data() + CHEST_MAX + EAR_MAX, rEarRemapping_,
-                   "REar");
-    packFloatArray(packer, dataBlock_.commandLEDs.data() + CHEST_MAX + 2 * EAR_MAX + EYE_MAX,
-                   rEyeRemapping_, "REye");
-    packFloatArray(packer,
-                   dataBlock_.commandLEDs.data() + CHEST_MAX + 2 * EAR_MAX + 2 * EYE_MAX +
-                       HEAD_MAX + FOOT_MAX,
-                   colorRemapping_, "RFoot");
-    packFloatArray(packer, dataBlock_.commandLEDs.data() + CHEST_MAX + 2 * EAR_MAX + 2 * EYE_MAX,
-                   skullRemapping_, "Skull");
-
-    packer.pack("Sonar");
-    packer.pack_array(2);
-    packer.pack_true();
-    packer.pack_true();
-
-    packJoints(packer, dataBlock_.commandStiffnesses, "Stiffness");
-  }
-
-  // actually send the assembled data to LoLA
-  socket_.send(boost::asio::buffer(sbuf_.data(), sbuf_.size()));
+  // patch the commands into the actuator message and send it to LoLA
+  actuatorEncoder_.encode(dataBlock_);
+  socket_.send(boost::asio::buffer(actuatorEncoder_.data(), actuatorEncoder_.size()));
 
   // Wait for an answer from LoLA (via background thread)
   {
@@ -315,30 +241,7 @@ float NaoInterface::waitAndReadSensorData(NaoSensorData& data)
 
   // parse the incoming LoLA message
   {
-    msgpack::object_handle ob = msgpack::unpack(lastLolaReceivedDatum_.data(), LoLADatumSize);
-    msgpack::object obj = ob.get();
-
-    if (obj.type != msgpack::type::MAP)
-    {
-      Log(LogLevel::ERROR) << "Unable to parse LoLA msg: Unexpected type. Object dump:";
-      Log(LogLevel::ERROR) << obj;
-      throw std::runtime_error("Wrong msgpack type from LoLA, expected MAP!");
-    }
-
-    // extract RobotConfig
-    extractVector3(obj.via.map.ptr[1].val, dataBlock_.imu.data() + keys::sensor::IMU_ACC_X);
-    extractVector2(obj.via.map.ptr[2].val, dataBlock_.imu.data() + keys::sensor::IMU_ANGLE_X);
-    extractBattery(obj.via.map.ptr[3].val, dataBlock_.battery);
-    extractJoints(obj.via.map.ptr[4].val, dataBlock_.jointCurrent);
-    extractFSRs(obj.via.map.ptr[5].val, dataBlock_.fsrLeft, dataBlock_.fsrRight);
-    extractVector3(obj.via.map.ptr[6].val, dataBlock_.imu.data() + keys::sensor::IMU_GYR_X);
-    extractJoints(obj.via.map.ptr[7].val, dataBlock_.jointSensor);
-    extractSonar(obj.via.map.ptr[8].val, dataBlock_.sonar);
-    // extract Stiffness(9) here if needed
-    extractJoints(obj.via.map.ptr[10].val, dataBlock_.jointTemperature);
-    extractSwitches(obj.via.map.ptr[11].val, dataBlock_.switches);
-    extractJoints(obj.via.map.ptr[12].val, dataBlock_.jointStatus);
-
+    stateDecoder_.decode(lastLolaReceivedDatum_.data(), LoLADatumSize, dataBlock_);
 
     const float currentFrontHeadState = dataBlock_.switches[keys::sensor::SWITCH_HEAD_FRONT];
     const float currentRearHeadState = dataBlock_.switches[keys::sensor::SWITCH_HEAD_REAR];
@@ -662,91 +565,3 @@ void NaoInterface::initNaoInfo(Configuration& config)
   value << naoInfo_;
   config.set("tuhhSDK.base", "NaoInfo", value);
 }
-
-void NaoInterface::extractJoints(msgpack::object& array,
-                                 std::array<float, keys::joints::JOINTS_MAX>& jointData)
-{
-  for (std::size_t i = 0; i < array.via.array.size; i++)
-  {
-    jointData[jointsRemapping_[i]] = array.via.array.ptr[i].as<float>();
-  }
-  jointData[keys::joints::R_HIP_YAW_PITCH] = jointData[keys::joints::L_HIP_YAW_PITCH];
-}
-
-void NaoInterface::extractVector2(msgpack::object& array, float* dest)
-{
-  for (int i = 0; i < 2; ++i)
-  {
-    dest[i] = array.via.array.ptr[i].as<float>();
-  }
-}
-
-void NaoInterface::extractVector3(msgpack::object& array, float* dest)
-{
-  for (int i = 0; i < 3; ++i)
-  {
-    dest[i] = array.via.array.ptr[i].as<float>();
-  }
-}
-
-void NaoInterface::extractFSRs(msgpack::object& array,
-                               std::array<float, keys::sensor::FSR_MAX>& leftFSR,
-                               std::array<float, keys::sensor::FSR_MAX>& rightFSR)
-{
-  for (int i = 0; i < 4; ++i)
-  {
-    leftFSR[i] = array.via.array.ptr[i].as<float>();
-  }
-  for (int i = 4; i < 8; ++i)
-  {
-    rightFSR[i - 4] = array.via.array.ptr[i].as<float>();
-  }
-}
-
-void NaoInterface::extractBattery(msgpack::object& array,
-                                  std::array<float, keys::sensor::BATTERY_MAX>& battery)
-{
-  for (int i = 0; i < keys::sensor::BATTERY_MAX; ++i)
-  {
-    battery[batteryRemapping_[i]] = array.via.array.ptr[i].as<float>();
-  }
-}
-
-void NaoInterface::extractSwitches(msgpack::object& array,
-                                   std::array<float, keys::sensor::SWITCH_MAX>& switches)
-{
-  for (int i = 0; i < keys::sensor::SWITCH_MAX; ++i)
-  {
-    switches[switchesRemapping_[i]] = array.via.array.ptr[i].as<float>();
-  }
-}
-
-void NaoInterface::extractSonar(msgpack::object& array,
-                                std::array<float, keys::sensor::SONAR_MAX>& sonar)
-{
-  sonar[keys::sensor::SONAR_LEFT_SENSOR_0] = array.via.array.ptr[0].as<float>();
-  sonar[keys::sensor::SONAR_RIGHT_SENSOR_0] = array.via.array.ptr[1].as<float>();
-}
-
-void NaoInterface::packJoints(msgpack::packer<msgpack::sbuffer>& packer,
-                              std::array<float, keys::joints::JOINTS_MAX>& jointData,
-                              std::string name)
-{
-  packer.pack(name);
-  packer.pack_array(jointsRemapping_.size());
-  for (std::size_t i = 0; i < jointsRemapping_.size(); ++i)
-  {
-    packer.pack_float(jointData[jointsRemapping_[i]]);
-  }
-}
-
-void NaoInterface::packFloatArray(msgpack::packer<msgpack::sbuffer>& packer, float* src,
-                                  std::vector<int>& remapping, std::string name)
-{
-  packer.pack(name);
-  packer.pack_array(remapping.size());
-  for (std::size_t i = 0; i < remapping.size(); ++i)
-  {
-    packer.pack_float(src[remapping[i]]);
-  }
-}
@@ -15,13 +15,12 @@
 #include "Hardware/Nao/common/NaoAudio.hpp"
 #include "Hardware/Nao/common/NaoFakeData.hpp"
 #include "Hardware/Nao/common/SMO.h"
+#include "Hardware/Nao/v6/LoLACodec.hpp"
 #include "Hardware/Nao/v6/Nao6Camera.hpp"
 #include "Hardware/RobotInterface.hpp"
 
 #include "Tools/Var/SpscQueue.hpp"
 
-constexpr const size_t LoLADatumSize = 896;
-
 typedef boost::array<char, 8000> LoLADataBuffer;
 typedef boost::array<char, LoLADatumSize> LoLASingleDatumBuffer;
 
@@ -63,72 +62,11 @@ private:
    */
   void initNaoInfo(Configuration& config);
 
-  /**
-   * @brief extractJoints extracts the joint data from a given messagePack object.
-   * @param array the messagePack object to parse the joint data from
-   * @param jointData the array to store the parsed data in.
-   */
-  void extractJoints(msgpack::object& array,
-                     std::array<float, keys::joints::JOINTS_MAX>& jointData);
-  /**
-   * @brief extractVector2 extracts a two dimensional floating point vector from the given
-   * messagePack object.
-   * @param array the messagePack object to parse the vector from
-   * @param dest the float array to put the data in.
-   */
-  void extractVector2(msgpack::object& array, float* dest);
-  /**
-   * @brief extractVector3 extracts a three dimensional floating point vector from the given
-   * messagePack object.
-   * @param array the messagePack object to parse the vector from
-   * @param dest the float array to put the data in
-   */
-  void extractVector3(msgpack::object& array, float* dest);
-  /**
-   * @brief extractFSRs extracts the Force Sensing Resistor data from the given messagePack object.
-   * @param array the messagePack object to parse the vector from
-   * @param leftFSR the array to put the data for the left foot in
-   * @param rightFSR the array to put the data for the right foot in
-   */
-  void extractFSRs(msgpack::object& array, std::array<float, keys::sensor::FSR_MAX>& leftFSR,
-                   std::array<float, keys::sensor::FSR_MAX>& rightFSR);
-  /**
-   * @brief extractBattery extracts the battery info (charge, current, ...) from the given
-   * messagePack object.
-   * @param array the messagePack object to parse the battery data from
-   * @param battery the array to put the battery data in
-   */
-  void extractBattery(msgpack::object& array,
-                      std::array<float, keys::sensor::BATTERY_MAX>& battery);
-  /**
-   * @brief extractSwitches extracts the button data from the given messagePack object.
-   * @param array the messagePack object to parse the button data from
-   * @param switches the array to put the button data in
-   */
-  void extractSwitches(msgpack::object& array,
-                       std::array<float, keys::sensor::SWITCH_MAX>& switches);
-  /**
-   * @brief extractSonar extracts the sonar sensor data from the given messagePack object.
-   * @param array the messagePack object to parse the sonar sensor data from
-   * @param sonar the array to put the sonar sensor data in
-   */
-  void extractSonar(msgpack::object& array, std::array<float, keys::sensor::SONAR_MAX>& sonar);
-
-  void packJoints(msgpack::packer<msgpack::sbuffer>& packer,
-                  std::array<float, keys::joints::JOINTS_MAX>& jointData, std::string name);
-  void packFloatArray(msgpack::packer<msgpack::sbuffer>& packer, float* src,
-                      std::vector<int>& remapping, std::string name);
-
-  std::vector<keys::joints::enumJoints> jointsRemapping_;
-  std::vector<keys::sensor::battery> batteryRemapping_;
-  std::vector<keys::sensor::switches> switchesRemapping_;
-  std::vector<int> colorRemapping_;
-  std::vector<int> lEarRemapping_;
-  std::vector<int> rEarRemapping_;
-  std::vector<int> skullRemapping_;
-  std::vector<int> lEyeRemapping_;
-  std::vector<int> rEyeRemapping_;
 
+  /// the decoder for the state messages from LoLA
+  LoLAStateDecoder stateDecoder_;
+  /// the pre-serialized actuator message for LoLA
+  LoLAActuatorEncoder actuatorEncoder_;
   BatteryDisplay batteryDisplay_;
   SharedBlock dataBlock_;
   /// Whether the background thread is out of sync with LoLA
@@ -158,8 +96,6 @@ private:
   /// whether new network data came in
   bool newNetworkData_;
   TimePoint timeNetworkDataReceived_;
-  /// simple msgpack buffer for data that will be sent to LoLA
-  msgpack::sbuffer sbuf_;
 
   /// Chest button state in the last cycle
   float previousChestButtonState_;
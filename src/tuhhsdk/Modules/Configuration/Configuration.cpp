@@ -1,6 +1,8 @@
 #include "Configuration.h"
 #include <fstream>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 #include "Tools/Storage/UniValue/UniValue2Json.hpp"
 #include "Tools/Time.hpp"
@@ -15,6 +17,12 @@ Configuration::Configuration(const std::string& fileRoot)
 {
 }
 
+std::unique_ptr<Configuration> Configuration::createStandalone(const std::string& fileRoot)
+{
+  // std::make_unique can not access the private constructor
+  return std::unique_ptr<Configuration>(new Configuration(fileRoot));
+}
+
 Configuration::~Configuration()
 {
   for (auto& callback : map_)
@@ -256,17 +264,26 @@ void Configuration::save()
   try
   {
     Json::StyledWriter writer;
-
-    std::lock_guard<std::recursive_mutex> lg(mountMutex_);
-    for (auto it = mountPts_.begin(); it != mountPts_.end(); ++it)
+    // The files are written without holding the lock so that module threads that access the
+    // configuration are not blocked by the file system.
+    std::vector<std::pair<std::string, std::string>> files;
     {
-      if (it->second.changed)
+      std::lock_guard<std::recursive_mutex> lg(mountMutex_);
+      for (auto it = mountPts_.begin(); it != mountPts_.end(); ++it)
       {
-        std::ofstream file(it->second.filename);
-        file << writer.write(Uni::Converter::toJson(it->second.root));
-        file.close();
+        if (it->second.changed)
+        {
+          files.emplace_back(it->second.filename,
+                             writer.write(Uni::Converter::toJson(it->second.root)));
+        }
       }
     }
+    for (auto& file : files)
+    {
+      std::ofstream stream(file.first);
+      stream << file.second;
+      stream.close();
+    }
   }
   catch (std::exception& e)
   {
@@ -87,6 +87,14 @@ private:
   bool mountFile(const std::string& mount, const std::string& filename);
 
 public:
+  /**
+   * @brief createStandalone creates a configuration for offline tools that run without TUHH
+   * (e.g. benchmarks). The robot code must use the configuration of TUHH instead.
+   * @param fileRoot the directory which contains the configuration directory
+   * @return the new configuration
+   */
+  static std::unique_ptr<Configuration> createStandalone(const std::string& fileRoot);
+
   /**
    * @brief ~Configuration frees configuration signals
    */
@@ -12,6 +12,7 @@
 #include "Tools/Storage/UniValue/UniValue2JsonString.h"
 
 #include "PngConverter.h"
+#include "StreamCompression.h"
 #include "print.h"
 
 #include "FileTransport.h"
@@ -30,6 +31,17 @@ public:
 
   void transport();
   void updateGameControllerState();
+  /**
+   * @brief write appends data to the replay file (or to the compression stream)
+   * @param data the data to write
+   */
+  void write(const std::string& data);
+  /**
+   * @brief writeFrame appends a complete frame to the replay file (or to the compression stream)
+   * @param frame the frame to write
+   * @return false if the compression stream had to drop the frame
+   */
+  bool writeFrame(const std::string& frame);
 
   PngConverter img_conv_;
   Debug& debug_;
@@ -43,6 +55,10 @@ public:
 
   /// the filestream for the replay.json file
   std::ofstream frameStream_;
+  /// the gzip compression for the frames (replaces frameStream_ if compressFrames is set)
+  std::unique_ptr<StreamCompression> frameCompression_;
+  /// the number of dropped frames that have already been reported
+  std::uint64_t reportedDroppedFrames_;
 
   PngConverter pngConverter_;
   CVData compressedImage_;
@@ -57,6 +73,7 @@ FileTransport::Impl::Impl(Debug& debug, Configuration& cfg, const std::string& f
   : debug_(debug)
   , config_(cfg)
   , cycles_(0uL)
+  , reportedDroppedFrames_(0)
   , initDone_(false)
   , firstFrame_(true)
   , onlyRecordWhilePlaying_(true)
@@ -87,13 +104,52 @@ FileTransport::Impl::Impl(Debug& debug, Configuration& cfg, const std::string& f
   ss << "/";
   current_log_dir_ = ss.str();
   boost::filesystem::create_directory(current_log_dir_);
-  frameStream_.open(current_log_dir_ + "/replay.json", std::ios_base::out | std::ios_base::trunc);
+  if (cfg.hasProperty(mount, "compressFrames") && cfg.get(mount, "compressFrames").asBool())
+  {
+    // The frames are compressed by worker threads so that the debug thread is never throttled.
+    frameCompression_ = std::make_unique<StreamCompression>(0);
+    frameCompression_->setFolder(current_log_dir_ + "/replay");
+    frameCompression_->openStream();
+  }
+  else
+  {
+    frameStream_.open(current_log_dir_ + "/replay.json", std::ios_base::out | std::ios_base::trunc);
+  }
 }
 
 FileTransport::Impl::~Impl()
 {
-  frameStream_ << "]}" << std::endl;
-  frameStream_.close();
+  write("]}\n");
+  if (frameCompression_)
+  {
+    frameCompression_->endStream();
+  }
+  else
+  {
+    frameStream_.close();
+  }
+}
+
+void FileTransport::Impl::write(const std::string& data)
+{
+  if (frameCompression_)
+  {
+    frameCompression_->writeData(data);
+  }
+  else
+  {
+    frameStream_ << data;
+  }
+}
+
+bool FileTransport::Impl::writeFrame(const std::string& frame)
+{
+  if (frameCompression_)
+  {
+    return frameCompression_->writeFrame(frame);
+  }
+  frameStream_ << frame;
+  return true;
 }
 
 void FileTransport::Impl::init()
@@ -117,8 +173,8 @@ void FileTransport::Impl::init()
   Uni::Value exportConfig;
   exportConfig << configs;
   const std::string configString = Uni::Converter::toJsonString(exportConfig, false);
-  frameStream_ << "{ \"config\":" << configString << "," << std::endl;
-  frameStream_ << "\"frames\": [" << std::endl;
+  write("{ \"config\":" + configString + ",\n");
+  write("\"frames\": [\n");
   initDone_ = true;
 }
 
@@ -135,15 +191,8 @@ void FileTransport::Impl::transport()
     return;
   }
 
-  if (firstFrame_)
-  {
-    frameStream_ << "[";
-    firstFrame_ = false;
-  }
-  else
-  {
-    frameStream_ << ",[";
-  }
+  // The frame is written at once so that the compression can only drop it as a whole.
+  std::string frame = firstFrame_ ? "[" : ",[";
 
   const auto& debugSources = debug_.getDebugSources();
   bool isFirst = true;
@@ -210,14 +259,25 @@ void FileTransport::Impl::transport()
     const std::string json = Uni::Converter::toJsonString(debugDataToWrite, false);
     if (!isFirst)
     {
-      frameStream_ << ",";
+      frame += ",";
     }
     isFirst = false;
-    frameStream_ << json;
+    frame += json;
   }
 
   cycles_++;
-  frameStream_ << "]";
+  frame += "]";
+  if (writeFrame(frame))
+  {
+    firstFrame_ = false;
+  }
+
+  if (frameCompression_ && frameCompression_->getDroppedFrames() > reportedDroppedFrames_)
+  {
+    reportedDroppedFrames_ = frameCompression_->getDroppedFrames();
+    Log(LogLevel::WARNING) << "FileTransport: " << reportedDroppedFrames_
+                           << " frames have been dropped because the compression is too slow";
+  }
 }
 
 void FileTransport::Impl::updateGameControllerState()
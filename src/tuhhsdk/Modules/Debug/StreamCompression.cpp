@@ -1,47 +1,125 @@
 #include "StreamCompression.h"
 
-#include <iostream>
-
-#include "zlib.h"
-#include <chrono>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <map>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
-#include "Tools/Time.hpp"
+#include "zlib.h"
 
-using namespace std;
+#include "Tools/Time.hpp"
+#include "print.h"
 
 class StreamCompression::Impl
 {
 public:
-  Impl(size_t size);
+  Impl(std::size_t size, std::size_t blockSize, std::size_t maxQueuedBlocks, unsigned int workers);
+  Impl(const Impl&) = delete;
+  Impl& operator=(const Impl&) = delete;
+  ~Impl();
 
-  void setFolder(string filename)
+  void setFolder(const std::string& filename)
   {
     filename_ = filename;
   }
 
   void openStream();
-  void writeData(string str);
+  void writeData(const std::string& str);
+  bool writeFrame(const std::string& frame);
   void endStream();
-  uint32_t getAvailableSpace();
+  std::uint64_t getDroppedFrames() const
+  {
+    return droppedFrames_;
+  }
 
 private:
-  string filename_;
-  string nextFilename_;
+  /// a block of uncompressed data
+  struct Block
+  {
+    /// the position of the block in the stream
+    std::uint64_t sequence;
+    /// the uncompressed data
+    std::string data;
+  };
 
-  ofstream fo_;
-  z_stream strm_;
+  /**
+   * @brief submitBlock hands the current block over to the workers
+   * @param wait whether to wait for space in the queue
+   * @return false if the queue is full and the block has been kept (only if wait is false)
+   */
+  bool submitBlock(bool wait);
+  /**
+   * @brief run is the main function of the worker threads
+   */
+  void run();
+  /**
+   * @brief compress compresses a block into a gzip member
+   * @param input the uncompressed data
+   * @param member the gzip member (empty if the compression failed)
+   */
+  void compress(const std::string& input, std::vector<unsigned char>& member) const;
+  /**
+   * @brief writeMembers writes all compressed members that are next in the stream
+   *
+   * outputMutex_ must be held by the caller.
+   */
+  void writeMembers();
 
-  size_t size_;
-  unsigned int sizeData_;
-  unsigned char* outBuf_;
-  bool hasData_;
+  /// the size after which a new file is started (0 for no limit)
+  const std::size_t size_;
+  /// the number of uncompressed bytes per block
+  const std::size_t blockSize_;
+  /// the maximum number of blocks that wait for compression
+  const std::size_t maxQueuedBlocks_;
+  /// the prefix of the file names
+  std::string filename_;
+
+  /// the block that is filled by writeData and writeFrame
+  std::string currentBlock_;
+  /// the number of frames that have been dropped
+  std::uint64_t droppedFrames_ = 0;
+
+  /// protects queue_, freeBuffers_, nextSequence_ and shutdown_
+  std::mutex queueMutex_;
+  /// notifies the workers about new blocks and writers about free space in the queue
+  std::condition_variable queueCondition_;
+  /// the blocks that wait for compression
+  std::deque<Block> queue_;
+  /// buffers of compressed blocks that can be reused for new blocks
+  std::vector<std::string> freeBuffers_;
+  /// the sequence number of the next block that is submitted
+  std::uint64_t nextSequence_ = 0;
+  /// whether the workers should stop
+  bool shutdown_ = false;
+
+  /// protects everything that is related to the output file
+  std::mutex outputMutex_;
+  /// notified whenever members have been written
+  std::condition_variable outputCondition_;
+  /// compressed members that wait for their predecessors
+  std::map<std::uint64_t, std::vector<unsigned char>> finishedMembers_;
+  /// the sequence number of the next member that is written to the file
+  std::uint64_t nextMemberToWrite_ = 0;
+  /// the current output file
+  std::ofstream file_;
+  /// the number of bytes in the current output file
+  std::size_t fileSize_ = 0;
+  /// whether the file has to be (re)opened before the next member is written
+  bool startNewFile_ = true;
+
+  /// the compression threads
+  std::vector<std::thread> workers_;
 };
 
 
-StreamCompression::StreamCompression(size_t size)
-  : pImpl_(new Impl(size))
+StreamCompression::StreamCompression(std::size_t size, std::size_t blockSize,
+                                     std::size_t maxQueuedBlocks, unsigned int workers)
+  : pImpl_(std::make_shared<Impl>(size, blockSize, maxQueuedBlocks, workers))
   , isOpen_(false)
 {
 }
@@ -51,7 +129,7 @@ StreamCompression::~StreamCompression()
   endStream();
 }
 
-void StreamCompression::setFolder(string filename)
+void StreamCompression::setFolder(std::string filename)
 {
   pImpl_->setFolder(filename);
 }
@@ -62,10 +140,22 @@ void StreamCompression::openStream()
   pImpl_->openStream();
 }
 
-void StreamCompression::writeData(string str)
+void StreamCompression::writeData(const std::string& str)
 {
   if (isOpen_)
+  {
     pImpl_->writeData(str);
+  }
+}
+
+bool StreamCompression::writeFrame(const std::string& frame)
+{
+  return isOpen_ && pImpl_->writeFrame(frame);
+}
+
+std::uint64_t StreamCompression::getDroppedFrames() const
+{
+  return pImpl_->getDroppedFrames();
 }
 
 void StreamCompression::endStream()
@@ -77,71 +167,209 @@ void StreamCompression::endStream()
   }
 }
 
-uint32_t StreamCompression::getAvailableSpace()
-{
-  return pImpl_->getAvailableSpace();
-}
 
-
-StreamCompression::Impl::Impl(size_t size)
+StreamCompression::Impl::Impl(std::size_t size, std::size_t blockSize,
+                              std::size_t maxQueuedBlocks, unsigned int workers)
   : size_(size)
-  , outBuf_(new unsigned char[size])
+  , blockSize_(std::max<std::size_t>(blockSize, 1))
+  , maxQueuedBlocks_(std::max<std::size_t>(maxQueuedBlocks, 1))
 {
-  hasData_ = false;
+  currentBlock_.reserve(blockSize_);
+  for (unsigned int i = 0; i < std::max(workers, 1u); i++)
+  {
+    workers_.emplace_back([this] { run(); });
+  }
 }
 
-void StreamCompression::Impl::openStream()
+StreamCompression::Impl::~Impl()
 {
-  if (!hasData_)
   {
-    stringstream ss;
-    ss << filename_ << "_" << TimePoint::getCurrentTime().getSystemTime() << ".z";
-    nextFilename_ = ss.str();
+    std::lock_guard<std::mutex> lg(queueMutex_);
+    shutdown_ = true;
+  }
+  queueCondition_.notify_all();
+  for (auto& worker : workers_)
+  {
+    worker.join();
+  }
+}
 
-    strm_.zalloc = Z_NULL;
-    strm_.zfree = Z_NULL;
-    strm_.opaque = Z_NULL;
-    strm_.avail_out = size_;
-    strm_.next_out = outBuf_;
+void StreamCompression::Impl::openStream()
+{
+  std::lock_guard<std::mutex> lg(outputMutex_);
+  startNewFile_ = true;
+}
 
-    deflateInit2(&strm_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, (15 + 16), 8, Z_DEFAULT_STRATEGY);
+void StreamCompression::Impl::writeData(const std::string& str)
+{
+  if (!currentBlock_.empty() && currentBlock_.size() + str.size() > blockSize_)
+  {
+    submitBlock(true);
   }
+  currentBlock_.append(str);
 }
 
-void StreamCompression::Impl::writeData(string str)
+bool StreamCompression::Impl::writeFrame(const std::string& frame)
 {
-  hasData_ = true;
-  strm_.avail_in = str.length() * sizeof(string::value_type);
-  strm_.next_in = (unsigned char*)str.data();
+  // The frame is only appended as a whole. Dropping a part of it (or of the current block) would
+  // leave a stream that cannot be parsed anymore. A single frame may exceed the block size.
+  if (!currentBlock_.empty() && currentBlock_.size() + frame.size() > blockSize_ &&
+      !submitBlock(false))
+  {
+    // The workers are too slow. Dropping the frame is better than stalling the caller.
+    droppedFrames_++;
+    return false;
+  }
+  currentBlock_.append(frame);
+  return true;
+}
 
-  deflate(&strm_, Z_NO_FLUSH);
-  sizeData_ = size_ - strm_.avail_out;
+void StreamCompression::Impl::endStream()
+{
+  if (!currentBlock_.empty())
+  {
+    submitBlock(true);
+  }
+  std::uint64_t lastSequence;
+  {
+    std::lock_guard<std::mutex> lg(queueMutex_);
+    lastSequence = nextSequence_;
+  }
+  std::unique_lock<std::mutex> ul(outputMutex_);
+  outputCondition_.wait(ul, [this, lastSequence] { return nextMemberToWrite_ >= lastSequence; });
+  if (file_.is_open())
+  {
+    file_.close();
+  }
+  startNewFile_ = true;
+  if (droppedFrames_ > 0)
+  {
+    Log(LogLevel::WARNING) << "StreamCompression dropped " << droppedFrames_
+                           << " frames because the compression could not keep up";
+  }
+}
 
-  if (strm_.avail_out < size_ / 10)
+bool StreamCompression::Impl::submitBlock(const bool wait)
+{
   {
-    endStream();
-    openStream();
+    std::unique_lock<std::mutex> ul(queueMutex_);
+    if (wait)
+    {
+      queueCondition_.wait(ul, [this] { return queue_.size() < maxQueuedBlocks_; });
+    }
+    else if (queue_.size() >= maxQueuedBlocks_)
+    {
+      return false;
+    }
+    queue_.push_back({nextSequence_++, std::move(currentBlock_)});
+    if (freeBuffers_.empty())
+    {
+      currentBlock_ = std::string();
+    }
+    else
+    {
+      currentBlock_ = std::move(freeBuffers_.back());
+      freeBuffers_.pop_back();
+    }
   }
+  queueCondition_.notify_all();
+  currentBlock_.clear();
+  currentBlock_.reserve(blockSize_);
+  return true;
 }
 
-void StreamCompression::Impl::endStream()
+void StreamCompression::Impl::run()
 {
-  if (hasData_)
+  std::vector<unsigned char> member;
+  while (true)
   {
-    strm_.avail_in = 0;
-    deflate(&strm_, Z_FINISH);
-    sizeData_ = size_ - strm_.avail_out;
+    Block block;
+    {
+      std::unique_lock<std::mutex> ul(queueMutex_);
+      queueCondition_.wait(ul, [this] { return shutdown_ || !queue_.empty(); });
+      if (queue_.empty())
+      {
+        return;
+      }
+      block = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    // A writer might wait for space in the queue.
+    queueCondition_.notify_all();
 
-    fo_.open(nextFilename_);
-    fo_.write((char*)outBuf_, sizeData_);
-    fo_.close();
+    // A block that cannot be compressed is skipped (compress logs an error).
+    compress(block.data, member);
+    {
+      std::lock_guard<std::mutex> lg(queueMutex_);
+      freeBuffers_.push_back(std::move(block.data));
+    }
+    {
+      std::lock_guard<std::mutex> lg(outputMutex_);
+      finishedMembers_.emplace(block.sequence, std::move(member));
+      writeMembers();
+    }
+    outputCondition_.notify_all();
+  }
+}
 
-    hasData_ = false;
-    deflateEnd(&strm_);
+void StreamCompression::Impl::compress(const std::string& input,
+                                       std::vector<unsigned char>& member) const
+{
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  // windowBits 15 + 16 writes a gzip header and trailer
+  if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, (15 + 16), 8, Z_DEFAULT_STRATEGY) !=
+      Z_OK)
+  {
+    Log(LogLevel::ERROR) << "StreamCompression could not initialize zlib";
+    member.clear();
+    return;
+  }
+  member.resize(deflateBound(&strm, input.size()));
+  strm.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(input.data()));
+  strm.avail_in = static_cast<unsigned int>(input.size());
+  strm.next_out = member.data();
+  strm.avail_out = static_cast<unsigned int>(member.size());
+  if (deflate(&strm, Z_FINISH) == Z_STREAM_END)
+  {
+    member.resize(strm.total_out);
   }
+  else
+  {
+    Log(LogLevel::ERROR) << "StreamCompression could not compress a block";
+    member.clear();
+  }
+  deflateEnd(&strm);
 }
 
-uint32_t StreamCompression::Impl::getAvailableSpace()
+void StreamCompression::Impl::writeMembers()
 {
-  return strm_.avail_out;
+  for (auto it = finishedMembers_.begin();
+       it != finishedMembers_.end() && it->first == nextMemberToWrite_;
+       it = finishedMembers_.erase(it), nextMemberToWrite_++)
+  {
+    const std::vector<unsigned char>& member = it->second;
+    if (member.empty())
+    {
+      continue;
+    }
+    if (startNewFile_ || (size_ > 0 && fileSize_ > 0 && fileSize_ + member.size() > size_))
+    {
+      // Every file starts with a complete member, so each of them can be decompressed on its own.
+      if (file_.is_open())
+      {
+        file_.close();
+      }
+      std::stringstream ss;
+      ss << filename_ << "_" << TimePoint::getCurrentTime().getSystemTime() << ".gz";
+      file_.open(ss.str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      fileSize_ = 0;
+      startNewFile_ = false;
+    }
+    file_.write(reinterpret_cast<const char*>(member.data()),
+                static_cast<std::streamsize>(member.size()));
+    fileSize_ += member.size();
+  }
 }
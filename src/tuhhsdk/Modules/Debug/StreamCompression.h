@@ -1,19 +1,65 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 
+/**
+ * @brief StreamCompression writes a stream of data gzip compressed to files
+ *
+ * The data is collected in blocks that are compressed by worker threads. Each block becomes a
+ * separate gzip member and the members are written in order, so every file is a standard gzip file
+ * (concatenated members). Blocks only contain complete pieces of data, i.e. a piece is never split
+ * between two blocks. writeFrame never waits for the compression. If the workers cannot keep up and
+ * too many blocks are queued, the frame is dropped as a whole and counted instead.
+ * writeData, writeFrame, openStream and endStream must be called from the same thread.
+ */
 class StreamCompression
 {
 public:
-  StreamCompression(size_t size);
+  /**
+   * @brief StreamCompression starts the worker threads
+   * @param size the size after which a new file is started (0 for a single file per stream)
+   * @param blockSize the number of uncompressed bytes that form one gzip member
+   * @param maxQueuedBlocks the number of blocks that may wait for compression
+   * @param workers the number of compression threads
+   */
+  StreamCompression(std::size_t size, std::size_t blockSize = 1 << 20,
+                    std::size_t maxQueuedBlocks = 8, unsigned int workers = 2);
   ~StreamCompression();
 
+  /**
+   * @brief setFolder sets the prefix of the file names
+   * @param filename the path prefix to which a timestamp and .gz are appended
+   */
   void setFolder(std::string filename);
 
+  /**
+   * @brief openStream starts a new stream (the file is created when the first block is written)
+   */
   void openStream();
-  void writeData(std::string str);
-  uint32_t getAvailableSpace();
+  /**
+   * @brief writeData appends data to the stream that must not be dropped
+   *
+   * This waits for the compression if too many blocks are queued.
+   * @param str the data
+   */
+  void writeData(const std::string& str);
+  /**
+   * @brief writeFrame appends a frame to the stream without waiting for the compression
+   * @param frame the frame
+   * @return false if the frame has been dropped because too many blocks are queued
+   */
+  bool writeFrame(const std::string& frame);
+  /**
+   * @brief getDroppedFrames returns the number of frames that have been dropped
+   * @return the number of frames that have been dropped since the construction
+   */
+  std::uint64_t getDroppedFrames() const;
+  /**
+   * @brief endStream compresses the remaining data and waits until everything has been written
+   */
   void endStream();
 
 private:
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Modules/Network/SPLMessageDecoder.hpp"
+#include "Tools/Var/SpscQueue.hpp"
+
+/*
+ * This benchmarks the SPL message ingestion of the SPLNetworkService without a network.
+ *
+ * Usage: splMessageBenchmark <captured UDP payloads> [<iterations>]
+ *
+ * The capture is a sequence of records, each consisting of the payload size as 16 bit little
+ * endian integer followed by the payload of one UDP packet. Every payload is decoded for the given
+ * number of iterations. Afterwards, a producer thread decodes and pushes the payloads into the same
+ * ring that is used between the network thread and the brain while the main thread pops them.
+ */
+
+namespace
+{
+  /// the ring as it is used in the SPLNetworkService
+  using Ring = SpscRing<SPLNetworkData::IncomingMessage, 32>;
+
+  /**
+   * @brief readCapture splits a capture into payloads
+   * @param capture the content of the capture file
+   * @param payloads the payloads that are found in the capture
+   * @return false if the capture ends with an incomplete record
+   */
+  bool readCapture(const std::vector<char>& capture, std::vector<std::string>& payloads)
+  {
+    std::size_t offset = 0;
+    while (offset + 2 <= capture.size())
+    {
+      const auto low = static_cast<unsigned char>(capture[offset]);
+      const auto high = static_cast<unsigned char>(capture[offset + 1]);
+      const std::size_t size = low | (static_cast<std::size_t>(high) << 8);
+      offset += 2;
+      if (offset + size > capture.size())
+      {
+        return false;
+      }
+      payloads.emplace_back(capture.data() + offset, size);
+      offset += size;
+    }
+    return offset == capture.size();
+  }
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <captured UDP payloads> [<iterations>]\n";
+    return EXIT_FAILURE;
+  }
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file.is_open())
+  {
+    std::cerr << "Could not open " << argv[1] << "\n";
+    return EXIT_FAILURE;
+  }
+  const std::vector<char> capture((std::istreambuf_iterator<char>(file)),
+                                  std::istreambuf_iterator<char>());
+  std::vector<std::string> payloads;
+  if (!readCapture(capture, payloads))
+  {
+    std::cerr << "The capture ends with an incomplete record\n";
+  }
+  if (payloads.empty())
+  {
+    std::cerr << "The capture does not contain a payload\n";
+    return EXIT_FAILURE;
+  }
+  const std::size_t iterations = argc > 2 ? std::max<std::size_t>(std::stoul(argv[2]), 1) : 10000;
+
+  SPLMessageDecoder decoder;
+  SPLNetworkData::IncomingMessage message;
+  std::size_t validMessages = 0;
+  std::size_t validDSMessages = 0;
+  const auto decodeStart = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; i++)
+  {
+    for (const auto& payload : payloads)
+    {
+      if (decoder.decode(payload.data(), payload.size(), message) ==
+          SPLMessageDecoder::Result::VALID)
+      {
+        validMessages++;
+        validDSMessages +=
+            message.dsMsgStatus == SPLNetworkData::IncomingMessage::DSMessageStatus::VALID;
+      }
+    }
+  }
+  const auto decodeEnd = std::chrono::steady_clock::now();
+
+  // The ring is too large for the stack.
+  auto ring = std::make_unique<Ring>();
+  std::atomic<bool> producerDone(false);
+  std::size_t droppedMessages = 0;
+  double maximumPushTime = 0;
+  const auto transferStart = std::chrono::steady_clock::now();
+  std::thread producer([&] {
+    SPLNetworkData::IncomingMessage decodedMessage;
+    for (std::size_t i = 0; i < iterations; i++)
+    {
+      for (const auto& payload : payloads)
+      {
+        const auto pushStart = std::chrono::steady_clock::now();
+        if (decoder.decode(payload.data(), payload.size(), decodedMessage) ==
+                SPLMessageDecoder::Result::VALID &&
+            !ring->push(decodedMessage))
+        {
+          droppedMessages++;
+        }
+        maximumPushTime = std::max(
+            maximumPushTime,
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - pushStart)
+                .count());
+      }
+    }
+    producerDone = true;
+  });
+  std::size_t receivedMessages = 0;
+  SPLNetworkData::IncomingMessage receivedMessage;
+  while (true)
+  {
+    // The flag has to be read before the ring is emptied for the last time.
+    const bool done = producerDone;
+    while (ring->pop(receivedMessage))
+    {
+      receivedMessages++;
+    }
+    if (done)
+    {
+      break;
+    }
+  }
+  producer.join();
+  const auto transferEnd = std::chrono::steady_clock::now();
+
+  const double decodings = static_cast<double>(iterations * payloads.size());
+  std::cout << "payloads:              " << payloads.size() << " (" << validMessages / iterations
+            << " valid, " << validDSMessages / iterations << " with DevilSmash message)\n";
+  std::cout << "decode [ns/msg]:       "
+            << std::chrono::duration<double, std::nano>(decodeEnd - decodeStart).count() / decodings
+            << "\n";
+  std::cout << "transfer [ns/msg]:     "
+            << std::chrono::duration<double, std::nano>(transferEnd - transferStart).count() /
+                   decodings
+            << "\n";
+  std::cout << "max decode+push [ns]:  " << maximumPushTime << "\n";
+  std::cout << "received / dropped:    " << receivedMessages << " / " << droppedMessages << "\n";
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <cstring>
+
+#include "SPLMessageDecoder.hpp"
+
+
+SPLMessageDecoder::Result SPLMessageDecoder::decode(const void* data, const std::size_t size,
+                                                    SPLNetworkData::IncomingMessage& message) const
+{
+  if (size < headerSize_)
+  {
+    return Result::TOO_SMALL;
+  }
+  SPLStandardMessage& msg = message.stdMsg;
+  std::memcpy(&msg, data, std::min(size, sizeof(msg)));
+  if (std::memcmp(msg.header, SPL_STANDARD_MESSAGE_STRUCT_HEADER, sizeof(msg.header)) != 0)
+  {
+    return Result::HEADER_MISMATCH;
+  }
+  if (msg.version != SPL_STANDARD_MESSAGE_STRUCT_VERSION)
+  {
+    return Result::VERSION_MISMATCH;
+  }
+  if (msg.numOfDataBytes > SPL_STANDARD_MESSAGE_DATA_SIZE ||
+      headerSize_ + msg.numOfDataBytes > size)
+  {
+    return Result::DATA_SIZE_MISMATCH;
+  }
+
+  // The DevilSmash message may be byte aligned or bit packed. Its reader never reads beyond the
+  // data bytes and rejects messages that do not fit into them.
+  if (msg.numOfDataBytes == 0)
+  {
+    message.dsMsgStatus = SPLNetworkData::IncomingMessage::DSMessageStatus::MISSING;
+  }
+  else if (msg.numOfDataBytes <
+           static_cast<unsigned int>(DevilSmash::StandardMessage::sizeOfHeader()))
+  {
+    message.dsMsgStatus = SPLNetworkData::IncomingMessage::DSMessageStatus::TRUNCATED;
+  }
+  else if (!message.dsMsg.read(msg.data, msg.numOfDataBytes))
+  {
+    message.dsMsgStatus = SPLNetworkData::IncomingMessage::DSMessageStatus::MALFORMED;
+  }
+  else
+  {
+    message.dsMsgStatus = SPLNetworkData::IncomingMessage::DSMessageStatus::VALID;
+  }
+  return Result::VALID;
+}
+
+const char* SPLMessageDecoder::describe(const Result result)
+{
+  switch (result)
+  {
+    case Result::VALID:
+      return "SPLStandardMessage is valid";
+    case Result::TOO_SMALL:
+      return "Message size is too small";
+    case Result::HEADER_MISMATCH:
+      return "SPLStandardMessage header does not match";
+    case Result::VERSION_MISMATCH:
+      return "SPLStandardMessage does not match the implemented version";
+    case Result::DATA_SIZE_MISMATCH:
+      return "SPLStandardMessage numOfDataBytes does not match the message size";
+  }
+  return "Unknown SPLStandardMessage error";
+}
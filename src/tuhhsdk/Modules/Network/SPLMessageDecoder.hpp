@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Data/SPLNetworkData.hpp"
+
+/**
+ * @brief SPLMessageDecoder checks and decodes received SPL standard messages
+ *
+ * The decoder runs in the network thread so that the Brain only receives messages that are
+ * complete and whose DevilSmash message has already been decoded. It does not log anything, the
+ * caller decides how to report invalid messages.
+ */
+class SPLMessageDecoder
+{
+public:
+  /// the result of decoding a UDP payload
+  enum class Result
+  {
+    /// the payload is a valid SPL standard message
+    VALID,
+    /// the payload is smaller than the SPL standard message header
+    TOO_SMALL,
+    /// the payload does not start with the SPL standard message header
+    HEADER_MISMATCH,
+    /// the SPL standard message has a different version
+    VERSION_MISMATCH,
+    /// numOfDataBytes does not fit the payload
+    DATA_SIZE_MISMATCH
+  };
+
+  /**
+   * @brief decode checks a UDP payload and decodes the DevilSmash message in its data field
+   *
+   * The fields of the message that are not contained in the payload (time and address) are not
+   * touched. message.dsMsgStatus tells whether the DevilSmash message could be decoded.
+   * @param data the payload
+   * @param size the number of bytes of the payload
+   * @param message the message that is filled (may be reused to avoid allocations)
+   * @return whether the payload is a valid SPL standard message
+   */
+  Result decode(const void* data, std::size_t size, SPLNetworkData::IncomingMessage& message) const;
+  /**
+   * @brief describe returns a human readable description of a result
+   * @param result the result of decode
+   * @return the description
+   */
+  static const char* describe(Result result);
+
+private:
+  /// the number of bytes of an SPL standard message without the data field
+  static constexpr std::size_t headerSize_ =
+      sizeof(SPLStandardMessage) - SPL_STANDARD_MESSAGE_DATA_SIZE;
+};
@@ -22,6 +22,11 @@ const std::vector<float>& Poses::getPose(const EnumPose index)
   return poses[index];
 }
 
+bool Poses::initStandalone(const std::string& fileRoot)
+{
+  return init(fileRoot);
+}
+
 bool Poses::init(const std::string& fileRoot)
 {
   static bool initialized = false;
@@ -30,6 +30,13 @@ public:
    * @return a vector of joint angles
    */
   static const std::vector<float>& getPose(const EnumPose index);
+  /**
+   * @brief initStandalone loads all pose files for offline tools that run without TUHH (e.g.
+   * benchmarks)
+   * @param fileRoot the directory which contains the poses directory
+   * @return whether initialization was successful
+   */
+  static bool initStandalone(const std::string& fileRoot);
 
 private:
   /**
@@ -1,58 +1,63 @@
-#include "Correlation.hpp"
-#include "print.h"
 #include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "Correlation.hpp"
 
-Correlation::Correlation(unsigned int size) :
-  size_(size),
-  fft_(size)
+Correlation::Correlation(unsigned int size)
+  : size_(size)
+  , fft_(size)
+  , spectrum_(fft_.spectrumSize())
+  , correlation_(size)
 {
 }
 
-RealVector Correlation::correlate(RealVector x1, RealVector x2)
+const std::vector<float>& Correlation::correlate(const float* x1, std::size_t x1Size,
+                                                 const float* x2, std::size_t x2Size)
 {
-  if (x1.size() > size_) {
+  if (x1Size > size_)
+  {
     throw std::invalid_argument("x1 must be of size smaller or equal to Correlation::size_");
   }
 
-  if (x2.size() > size_) {
+  if (x2Size > size_)
+  {
     throw std::invalid_argument("x2 must be of size smaller or equal to Correlation::size_");
   }
 
-  // zero padding;
-  while (x1.size() < size_) {
-    x1.push_back(0);
+  float* signal = fft_.realBuffer();
+  std::complex<float>* spectrum = fft_.complexBuffer();
+  const unsigned int spectrumSize = fft_.spectrumSize();
+
+  // zero padded x1
+  std::copy(x1, x1 + x1Size, signal);
+  std::fill(signal + x1Size, signal + size_, 0.f);
+  fft_.fft();
+  std::copy(spectrum, spectrum + spectrumSize, spectrum_.begin());
+
+  // zero padded and reversed x2
+  std::fill(signal, signal + size_ - x2Size, 0.f);
+  std::reverse_copy(x2, x2 + x2Size, signal + size_ - x2Size);
+  fft_.fft();
+
+  // Use the analytic signal by applying the hilbert transform. Only the non-redundant half of the
+  // spectrum enters the real inverse transform, so the weights are -1 below the nyquist bin and 0
+  // at it. The sign is irrelevant because only the absolute value is returned.
+  for (unsigned int k = 0; k < size_ / 2; ++k)
+  {
+    spectrum[k] *= spectrum_[k];
   }
-
-  while (x2.size() < size_) {
-    x2.push_back(0);
+  for (unsigned int k = size_ / 2; k < spectrumSize; ++k)
+  {
+    spectrum[k] = 0.f;
   }
+  fft_.ifft();
 
-  std::reverse(x2.begin(), x2.end());
-
-  ComplexVector X1 = fft_.fft(x1);
-  ComplexVector X2 = fft_.fft(x2);
-
-  ComplexVector correlation(size_);
-  for (unsigned int k = 0; k < size_; ++k) {
-    // use the analytic signal by applying hilbert transform:
-    double h = 0;
-    if (k < size_ / 2) {
-      h = -1;
-    } else if (k > size_ / 2) {
-      h = 1;
-    }
-//    double h = 1;
-    correlation[k] = (X1[k] * X2[k]) * h;
+  const float normalization = 1.f / static_cast<float>(size_);
+  for (unsigned int k = 0; k < size_; ++k)
+  {
+    correlation_[k] = std::abs(signal[k] * normalization);
   }
 
-  std::stringstream ss;
-  RealVector corr = fft_.ifft(correlation);
-  for (unsigned int k = 0; k < corr.size(); ++k) {
-    corr[k] = fabs(corr[k] / size_);
-  }
-
-  return corr;
+  return correlation_;
 }
-
-
-
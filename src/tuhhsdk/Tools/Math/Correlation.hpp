@@ -1,16 +1,44 @@
 #pragma once
 
-#include <Hardware/AudioInterface.hpp>
+#include <cstddef>
+#include <vector>
+
 #include "FFT.hpp"
 
-class Correlation {
+/**
+ * @brief Correlation computes the cross correlation of two signals via FFT
+ *
+ * All buffers and the FFT plans are allocated on construction, so correlate does not allocate and
+ * can be called continuously on audio windows.
+ */
+class Correlation
+{
 public:
-  Correlation(unsigned int size);
-  RealVector correlate(RealVector x1, RealVector x2);
-private:
+  /**
+   * @brief Correlation allocates the buffers for signals of up to size samples
+   * @param size the length of the (zero padded) signals
+   */
+  explicit Correlation(unsigned int size);
+  /**
+   * @brief correlate computes the absolute analytic cross correlation of two signals
+   *
+   * Throws a std::invalid_argument if one of the signals is longer than size.
+   * @param x1 the first signal
+   * @param x1Size the number of samples of the first signal
+   * @param x2 the second signal
+   * @param x2Size the number of samples of the second signal
+   * @return the correlation (size samples), valid until the next call
+   */
+  const std::vector<float>& correlate(const float* x1, std::size_t x1Size, const float* x2,
+                                      std::size_t x2Size);
 
-  unsigned int size_;
+private:
+  /// the length of the (zero padded) signals
+  const unsigned int size_;
+  /// the FFT that transforms the signals
   FFT fft_;
+  /// the spectrum of the first signal
+  std::vector<std::complex<float>> spectrum_;
+  /// the result of the last correlation
+  std::vector<float> correlation_;
 };
-
-
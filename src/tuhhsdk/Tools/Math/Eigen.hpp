@@ -27,6 +27,17 @@ using Matrix4f = Eigen::Matrix4f;
 using Matrix4d = Eigen::Matrix4d;
 using MatrixXd = Eigen::MatrixXd;
 using MatrixXf = Eigen::MatrixXf;
+using Matrix34f = Eigen::Matrix<float, 3, 4>;
+
+// Matrices of column vectors (e.g. batches of points)
+
+using Matrix2Xf = Eigen::Matrix2Xf;
+using Matrix3Xf = Eigen::Matrix3Xf;
+
+// Array types
+
+using ArrayXf = Eigen::ArrayXf;
+using ArrayXb = Eigen::Array<bool, Eigen::Dynamic, 1>;
 
 // Different types for rotation
 
@@ -1,45 +1,39 @@
+#include <algorithm>
+#include <stdexcept>
+
 #include "FFT.hpp"
-#include <print.h>
+#include "print.h"
 
-FFT::FFT(unsigned int nfft) :
-  realBuffer_(),
-  complexBuffer_()
+FFT::FFT(unsigned int nfft)
+  : nfft_(nfft)
+  , buffer_(fftwf_alloc_real(2 * (nfft / 2 + 1)))
 {
-  realBuffer_.resize(nfft);
-  complexBuffer_.resize(nfft);
-
-  //fft
-  fftPlan_ = fftw_plan_dft_r2c_1d(nfft, realBuffer_.data(), reinterpret_cast<fftw_complex*>(complexBuffer_.data()), FFTW_ESTIMATE);
-  //ifft
-  ifftPlan_ = fftw_plan_dft_c2r_1d(nfft, reinterpret_cast<fftw_complex*>(complexBuffer_.data()), realBuffer_.data(), FFTW_ESTIMATE);
+  if (buffer_ == nullptr)
+  {
+    Log(LogLevel::ERROR) << "Could not allocate the FFT buffer for nfft = " << nfft;
+    throw std::runtime_error("FFT: Could not allocate buffer.");
+  }
+  std::fill(buffer_, buffer_ + 2 * (nfft / 2 + 1), 0.f);
+  fftwf_complex* complexBuffer = reinterpret_cast<fftwf_complex*>(buffer_);
+  // fft
+  fftPlan_ = fftwf_plan_dft_r2c_1d(nfft, buffer_, complexBuffer, FFTW_ESTIMATE);
+  // ifft
+  ifftPlan_ = fftwf_plan_dft_c2r_1d(nfft, complexBuffer, buffer_, FFTW_ESTIMATE);
 }
 
 FFT::~FFT()
 {
-  fftw_destroy_plan(fftPlan_);
-  fftw_destroy_plan(ifftPlan_);
+  fftwf_destroy_plan(fftPlan_);
+  fftwf_destroy_plan(ifftPlan_);
+  fftwf_free(buffer_);
 }
 
-const ComplexVector& FFT::fft(const RealVector& input)
+void FFT::fft()
 {
-  if (input.size() != realBuffer_.size()) {
-    Log(LogLevel::ERROR) << "input.size = " << (int)input.size() << ", realBuffer.size() = " << (int)realBuffer_.size();
-    throw std::runtime_error("FFT: Input size does not match allocated buffer size.");
-  }
-
-  std::copy(input.begin(), input.end(), realBuffer_.begin());
-  fftw_execute(fftPlan_);
-  return complexBuffer_;
+  fftwf_execute(fftPlan_);
 }
 
-const RealVector& FFT::ifft(const ComplexVector& input)
+void FFT::ifft()
 {
-  if (input.size() != complexBuffer_.size()) {
-    Log(LogLevel::ERROR) << "input.size = " << (int)input.size() << ", complexBuffer.size() = " << (int)realBuffer_.size();
-    throw std::runtime_error("IFFT: Input size does not match allocated buffer size.");
-  }
-
-  std::copy(input.begin(), input.end(), complexBuffer_.begin());
-  fftw_execute(ifftPlan_);
-  return realBuffer_;
+  fftwf_execute(ifftPlan_);
 }
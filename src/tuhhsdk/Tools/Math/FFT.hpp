@@ -1,24 +1,82 @@
 #pragma once
-//include complex before fftw, so fftw can use it as its complex type.
+// include complex before fftw, so fftw can use it as its complex type.
 #include <complex>
 #include <fftw3.h>
 
-#include <vector>
-
-typedef std::vector<std::complex<double>> ComplexVector;
-typedef std::vector<double> RealVector;
-
-class FFT {
+/**
+ * @brief FFT computes real-to-complex and complex-to-real transforms of a fixed size
+ *
+ * The plans are created once for single precision and operate in place on a persistent, aligned
+ * buffer. The caller writes the signal into realBuffer(), calls fft() and reads the spectrum from
+ * complexBuffer() (and vice versa for ifft()). No memory is allocated after construction.
+ */
+class FFT
+{
 public:
-  FFT(unsigned int nfft);
+  /**
+   * @brief FFT allocates the buffer and creates the plans
+   * @param nfft the number of real samples of a transform
+   */
+  explicit FFT(unsigned int nfft);
+  /**
+   * @brief ~FFT destroys the plans and frees the buffer
+   */
   ~FFT();
+  FFT(const FFT&) = delete;
+  FFT& operator=(const FFT&) = delete;
 
-  const ComplexVector& fft(const RealVector& input);
-  const RealVector& ifft(const ComplexVector& input);
-private:
-  RealVector realBuffer_;
-  ComplexVector complexBuffer_;
+  /**
+   * @brief fft transforms the real buffer into the complex buffer
+   *
+   * The real buffer is overwritten because the transform is computed in place.
+   */
+  void fft();
+  /**
+   * @brief ifft transforms the complex buffer into the real buffer (unnormalized)
+   *
+   * The complex buffer is overwritten because the transform is computed in place.
+   */
+  void ifft();
+  /**
+   * @brief realBuffer returns the real signal (nfft samples)
+   * @return a pointer to the first sample
+   */
+  float* realBuffer()
+  {
+    return buffer_;
+  }
+  /**
+   * @brief complexBuffer returns the non-redundant half of the spectrum (nfft / 2 + 1 bins)
+   * @return a pointer to the first bin
+   */
+  std::complex<float>* complexBuffer()
+  {
+    return reinterpret_cast<std::complex<float>*>(buffer_);
+  }
+  /**
+   * @brief size returns the number of real samples of a transform
+   * @return nfft
+   */
+  unsigned int size() const
+  {
+    return nfft_;
+  }
+  /**
+   * @brief spectrumSize returns the number of bins of the complex buffer
+   * @return nfft / 2 + 1
+   */
+  unsigned int spectrumSize() const
+  {
+    return nfft_ / 2 + 1;
+  }
 
-  fftw_plan fftPlan_;
-  fftw_plan ifftPlan_;
+private:
+  /// the number of real samples of a transform
+  const unsigned int nfft_;
+  /// the in-place buffer of 2 * (nfft / 2 + 1) floats
+  float* buffer_;
+  /// the plan of the forward transform
+  fftwf_plan fftPlan_;
+  /// the plan of the inverse transform
+  fftwf_plan ifftPlan_;
 };
@@ -1,256 +1,189 @@
 #include "HungarianMethod.hpp"
 
-#include <limits>
 #include <algorithm>
+#include <cassert>
+#include <limits>
 
+HungarianMethod::HungarianMethod()
+  : rows_(0)
+  , cols_(0)
+  , minimize_(false)
+  , hasSolution_(false)
+  , numberOfSearches_(0)
+{
+}
 
-Eigen::Array2Xi HungarianMethod::findMaximumMatching(Eigen::MatrixXi& cost, bool minimize)
+const HungarianMethod::Matching& HungarianMethod::findMaximumMatching(const CostMatrix& cost,
+                                                                     bool minimize)
 {
-  using Eigen::VectorXi;
   // Some preconditions
-  assert(cost.rows() == cost.cols());
-  assert(cost.cols() > 1);
+  assert(cost.rows() > 0);
+  assert(cost.rows() <= cost.cols());
 
-  // Initialization
-  Eigen::Array2Xi ret;
-  cost_ = cost;
-  maxMatch_ = 0;
-  n_ = static_cast<int>(cost.cols());
-  xyMatching_ = VectorXi::Constant(n_, -1);
-  yxMatching_ = VectorXi::Constant(n_, -1);
-  searchedSources_.resize(n_);
-  searchedTargets_.resize(n_);
-  q_.reserve(n_);
-  q_.clear();
+  // The previous solution can only be reused for a problem of the same kind.
+  const bool reuse = hasSolution_ && cost.rows() == rows_ && cost.cols() == cols_ &&
+                     minimize == minimize_;
+  rows_ = static_cast<int>(cost.rows());
+  cols_ = static_cast<int>(cost.cols());
+  minimize_ = minimize;
 
-  // Hungarian method maximizes by default.
+  // The search minimizes, so a maximization is turned into a minimization.
   if (minimize)
   {
-    cost_ = cost_.array().maxCoeff() - cost_.array();
+    cost_ = cost;
+  }
+  else
+  {
+    cost_ = (cost.maxCoeff() - cost.array()).matrix();
   }
 
   // Step 0
-  initLabels();
-  // Step 1 to 3
-  augment();
-
-  ret.resize(2, n_);
-  for (int c = 0; c < ret.cols(); c++)
+  if (reuse)
   {
-    ret(0, c) = c;
-    ret(1, c) = xyMatching_[c];
+    reuseLabels();
+  }
+  else
+  {
+    initLabels();
   }
 
-  return ret;
-}
-
-void HungarianMethod::initLabels()
-{
-  using Eigen::VectorXi;
-  xLabels_ = VectorXi::Zero(n_);
-  yLabels_ = VectorXi::Zero(n_);
+  // Step 1: add all remaining sources
+  numberOfSearches_ = 0;
+  for (int x = 0; x < rows_; x++)
+  {
+    if (xyMatching_[x] == -1)
+    {
+      augment(x);
+      numberOfSearches_++;
+    }
+  }
+  hasSolution_ = true;
 
-  for (int x = 0; x < n_; x++)
+  matching_.resize(2, rows_);
+  for (int c = 0; c < rows_; c++)
   {
-    xLabels_[x] = cost_.row(x).maxCoeff();
+    matching_(0, c) = c;
+    matching_(1, c) = xyMatching_[c];
   }
 
-  slack_ = VectorXi::Constant(n_, -1);
-  slackX_ = VectorXi::Constant(n_, -1);
+  return matching_;
 }
 
-void HungarianMethod::addToTree(int x, int prevX)
+void HungarianMethod::reset()
 {
-  searchedSources_[x] = true;
-  prev_[x] = prevX;
+  hasSolution_ = false;
+}
 
-  assert(x != prevX);
+void HungarianMethod::initLabels()
+{
+  std::fill(yLabels_.begin(), yLabels_.begin() + cols_, 0);
+  std::fill(xyMatching_.begin(), xyMatching_.begin() + rows_, -1);
+  std::fill(yxMatching_.begin(), yxMatching_.begin() + cols_, -1);
+  updateXLabels();
+}
 
-  // update slacks, because the vertex x was added to S
-  for (int y = 0; y < n_; y++)
+void HungarianMethod::reuseLabels()
+{
+  // The y labels of the previous problem are kept. Together with the largest feasible x labels
+  // they form a feasible labeling of the current problem. A matched pair can only be kept if it is
+  // still tight. A target that becomes unmatched must have the label 0 (like every unmatched
+  // target during the search), otherwise the result would not be optimal if there are more
+  // targets than sources. Raising its label may make other pairs loose, so this is repeated until
+  // nothing changes (at most once per row).
+  bool labelsChanged = true;
+  while (labelsChanged)
   {
-    if (xLabels_[x] + yLabels_[y] - cost_(x, y) < slack_[y])
+    updateXLabels();
+    labelsChanged = false;
+    for (int x = 0; x < rows_; x++)
     {
-      slack_[y] = xLabels_[x] + yLabels_[y] - cost_(x, y);
-      slackX_[y] = x;
+      const int y = xyMatching_[x];
+      if (y != -1 && cost_(x, y) - xLabels_[x] - yLabels_[y] != 0)
+      {
+        xyMatching_[x] = -1;
+        yxMatching_[y] = -1;
+        if (yLabels_[y] != 0)
+        {
+          yLabels_[y] = 0;
+          labelsChanged = true;
+        }
+      }
     }
   }
 }
 
-void HungarianMethod::updateLabels()
+void HungarianMethod::updateXLabels()
 {
-  int delta = std::numeric_limits<int>::max();
-
-  // calculate delta with slack_
-  for (int y = 0; y < n_; y++)
+  for (int x = 0; x < rows_; x++)
   {
-    if (!searchedTargets_[y])
+    Potential label = std::numeric_limits<Potential>::max();
+    for (int y = 0; y < cols_; y++)
     {
-      delta = std::min(delta, slack_[y]);
-    }
-  }
-  // update the x labels
-  for (int x = 0; x < n_; x++)
-  {
-    if (searchedSources_[x])
-    {
-      xLabels_[x] -= delta;
-    }
-  }
-
-  for (int y = 0; y < n_; y++)
-  {
-    // update y labels
-    if (searchedTargets_[y])
-    {
-      yLabels_[y] += delta;
-    }
-    // update slack_ vector
-    if (!searchedTargets_[y])
-    {
-      slack_[y] -= delta;
+      label = std::min(label, cost_(x, y) - yLabels_[y]);
     }
+    xLabels_[x] = label;
   }
 }
 
-void HungarianMethod::augment()
+void HungarianMethod::augment(int x)
 {
+  // The virtual target root is matched with x. The search grows a tree of shortest alternating
+  // paths from it until an unmatched target is reached.
+  const int root = cols_;
+  yxMatching_[root] = x;
+  yLabels_[root] = 0;
+  std::fill(slack_.begin(), slack_.begin() + cols_, std::numeric_limits<Potential>::max());
+  std::fill(searchedTargets_.begin(), searchedTargets_.begin() + cols_ + 1, false);
+
+  int y = root;
   do
   {
-    // storage of found exposedY and x to augment
-    int exposedY = -1, lastX = -1;
-
-    searchedSources_ = Eigen::Matrix<bool, Eigen::Dynamic, 1>::Constant(n_, false);
-    searchedTargets_ = Eigen::Matrix<bool, Eigen::Dynamic, 1>::Constant(n_, false);
-
-    // init set prev - for the alternating tree
-    prev_ = Eigen::VectorXi::Constant(n_, -1);
-
-    // Step 1: finding root of the tree
-    q_.clear();
-    for (int x = 0; x < n_; x++)
+    searchedTargets_[y] = true;
+    const int currentX = yxMatching_[y];
+    Potential delta = std::numeric_limits<Potential>::max();
+    int nextY = -1;
+    // update the slacks, because currentX was added to the tree
+    for (int ty = 0; ty < cols_; ty++)
     {
-      if (xyMatching_[x] == -1)
+      if (searchedTargets_[ty])
       {
-        lastX = x;
-        q_.push(x);
-        // To find the root vertex while backtracking the tree
-        prev_[x] = -2;
-        // Include root in set S
-        searchedSources_[x] = true;
-        break;
+        continue;
       }
-    }
-
-    // initializing slack array (x is root)
-    for (int y = 0; y < n_; y++)
-    {
-      slack_[y] = xLabels_[lastX] + yLabels_[y] - cost_(lastX, y);
-      slackX_[y] = lastX;
-    }
-
-
-    // second part of augment() function
-    bool augmentedPathFound = false;
-    do
-    {
-      // This is more or less step 3 of the algorithm
-      augmentedPathFound = breadthFirstAlternatingTreeSearch(q_, exposedY, lastX);
-      if (augmentedPathFound)
+      const Potential reducedCost = cost_(currentX, ty) - xLabels_[currentX] - yLabels_[ty];
+      if (reducedCost < slack_[ty])
       {
-        break;
+        slack_[ty] = reducedCost;
+        prev_[ty] = y;
       }
-
-      // Here follows step 2 of the algorithm
-      // augmenting path not found, so improve labeling
-      updateLabels();
-      q_.clear();
-
-      augmentedPathFound = searchForExposedX(q_, exposedY, lastX);
-    } while (!augmentedPathFound);
-
-    assert(exposedY >= 0);
-
-    // increment matching
-    maxMatch_++;
-    // in this cycle we inverse edges along augmenting path
-    for (int cx = lastX, cy = exposedY; cx != -2; cx = prev_[cx])
-    {
-      int ty = xyMatching_[cx];
-      yxMatching_[cy] = cx;
-      xyMatching_[cx] = cy;
-      cy = ty;
-    }
-  } while (maxMatch_ != n_);
-  // check whether matching is already perfect
-}
-
-bool HungarianMethod::breadthFirstAlternatingTreeSearch(HungarianMethod::SimpleQueue<int>& q, int& exposedY, int& lastX)
-{
-  // building tree with bfs cycle
-  bool augmentedPathFound = false;
-  while (!q.empty() && !augmentedPathFound)
-  {
-    // current vertex from X part
-    int x = q.pop();
-    // iterate through all edges in equality graph
-    for (int y = 0; y < n_; y++)
-    {
-      if (cost_(x, y) == xLabels_[x] + yLabels_[y] && !searchedTargets_[y])
+      if (slack_[ty] < delta)
       {
-        // exposed vertex in Y found - augmenting path exists!
-        if (yxMatching_[y] == -1)
-        {
-          lastX = x;
-          exposedY = y;
-          augmentedPathFound = true;
-          break;
-        }
-
-        // else just add y to T,
-        searchedTargets_[y] = true;
-        // add vertex yxMatching[y], which is matched with y, to the SimpleQueue
-        q.push(yxMatching_[y]);
-        // add edges (x,y) and (y,yxMatching[y]) to the tree
-        addToTree(yxMatching_[y], x);
+        delta = slack_[ty];
+        nextY = ty;
       }
     }
-  }
-  return augmentedPathFound;
-}
-
-bool HungarianMethod::searchForExposedX(HungarianMethod::SimpleQueue<int>& q, int& exposedY, int& lastX)
-{
-  bool augmentedPathFound = false;
-  for (int y = 0; y < n_; y++)
-  {
-    // in this cycle we add edges that were added to the equality graph as a
-    // result of improving the labeling, we add edge (slackX[y], y) to the
-    // tree if and only if !Targets[y] && slack[y] == 0, also with this edge
-    // we add another one (y, yxMatching[y]) or augment the matching, if y was exposed
-    if (!searchedTargets_[y] && slack_[y] == 0)
+    assert(nextY != -1);
+    // update the labels so that the edge to nextY becomes tight
+    for (int ty = 0; ty <= cols_; ty++)
     {
-      // exposed vertex in Y found - augmenting path exists!
-      if (yxMatching_[y] == -1)
+      if (searchedTargets_[ty])
       {
-        lastX = slackX_[y];
-        exposedY = y;
-        augmentedPathFound = true;
-        break;
+        xLabels_[yxMatching_[ty]] += delta;
+        yLabels_[ty] -= delta;
       }
       else
       {
-        // else just add y to targets,
-        searchedTargets_[y] = true;
-        if (!searchedSources_[yxMatching_[y]])
-        {
-          // add vertex yxMatching[y], which is matched with y, to the SimpleQueue
-          q.push(yxMatching_[y]);
-          // and add edges (x,y) and (y, yxMatching[y]) to the tree
-          addToTree(yxMatching_[y], slackX_[y]);
-        }
+        slack_[ty] -= delta;
       }
     }
+    y = nextY;
+  } while (yxMatching_[y] != -1);
+
+  // in this cycle we inverse edges along augmenting path
+  while (y != root)
+  {
+    const int prevY = prev_[y];
+    yxMatching_[y] = yxMatching_[prevY];
+    xyMatching_[yxMatching_[y]] = y;
+    y = prevY;
   }
-  return augmentedPathFound;
 }
@@ -1,123 +1,110 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include <Eigen/Dense>
-#include <vector>
 
 /**
  * @brief Hungarian Method for assignment problem(s)
  * "The Hungarian method is a combinatorial optimization algorithm that solves the assignment problem in polynomial time"
  *
- * Based on https://www.topcoder.com/community/data-science/data-science-tutorials/assignment-problem-and-hungarian-algorithm/
+ * This is the shortest augmenting path variant with row and column potentials (dual variables).
+ * Each row is added to the matching by one Dijkstra-like search in O(rows * cols), so a solution
+ * never costs more than O(rows^2 * cols). All storage has a fixed capacity, i.e. solving does not
+ * allocate memory.
+ *
+ * The potentials and the matching of the previous problem are kept. If the next problem has the
+ * same size, the previous matching is reused as far as it is still optimal for the new costs and
+ * only the remaining rows are searched. Problems that change slightly between two calls (e.g.
+ * because the robots moved a bit) are usually solved with very few searches.
  */
 class HungarianMethod
 {
 public:
+  /// the maximum number of rows (sources) of a problem
+  static constexpr int maxRows = 8;
+  /// the maximum number of columns (targets) of a problem
+  static constexpr int maxCols = 64;
+  /// the cost matrix of a problem, entry (x, y) is the cost of assigning y to x
+  using CostMatrix =
+      Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor, maxRows, maxCols>;
+  /// the matching of a problem, column c assigns the target (1, c) to the source (0, c)
+  using Matching = Eigen::Array<int, 2, Eigen::Dynamic, Eigen::ColMajor, 2, maxRows>;
+
+  HungarianMethod();
+
   /**
-   * @brief
-   * @pre Input has to be nxn and n > 1
+   * @brief findMaximumMatching assigns a distinct target to every source
+   * @pre 0 < cost.rows() <= cost.cols()
    * @param cost Cost matrix of the problem
    * @param minimize If the algorithm should find the minimum matching.
-   * @return maximum matching
+   * @return the maximum (or minimum) matching, valid until the next call
    */
-  Eigen::Array2Xi findMaximumMatching(Eigen::MatrixXi& cost, bool minimize = false);
-
-  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-private:
-  template<typename T>
-  class SimpleQueue {
-  public:
-    void push(T& a)
-    {
-      data_.emplace_back(a);
-    }
-
-    T pop()
-    {
-      return data_[pRead++];
-    }
-
-    void clear()
-    {
-      data_.clear();
-      pRead = 0;
-    }
+  const Matching& findMaximumMatching(const CostMatrix& cost, bool minimize = false);
 
-    void reserve(int count)
-    {
-      data_.reserve(count);
-    }
-
-    std::size_t size()
-    {
-      return data_.size() - pRead;
-    }
-
-    bool empty()
-    {
-      return size() == 0;
-    }
+  /**
+   * @brief reset forgets the previous problem, i.e. the next problem is solved from scratch
+   */
+  void reset();
 
-  private:
-    std::vector<T> data_;
-    std::size_t pRead = 0;
-  };
+  /**
+   * @brief getNumberOfSearches returns how many rows had to be searched in the last call
+   * @return the number of searches (cost.rows() if nothing could be reused)
+   */
+  int getNumberOfSearches() const
+  {
+    return numberOfSearches_;
+  }
 
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 private:
-  /// The cost matrix of the current problem
-  Eigen::MatrixXi cost_;
-  /// Number of sources
-  int n_;
-  /// Current number of matched sources
-  int maxMatch_;
-  /// Labels of x and labels of y
-  Eigen::VectorXi xLabels_, yLabels_;
-  /// Matching x to y and y to x
-  Eigen::VectorXi xyMatching_, yxMatching_;
-  /// Temporary sets searchedSources and searchedTargets for saving current used vertices
-  Eigen::Matrix<bool, Eigen::Dynamic, 1> searchedSources_, searchedTargets_;
-  /// Lowest cost from x element X to slack_[y]
-  Eigen::VectorXi slack_;
-  /// slackx_[y] is the index of vertex x from X such that slack_[y] == l(x) + l(y) - w(x,y)
-  Eigen::VectorXi slackX_;
-  /// Saves the current alternating path
-  Eigen::VectorXi prev_;
-  /// queue for bfs (breadth-first search)
-  SimpleQueue<int> q_;
+  /// potentials are 64 bit so that sums of large costs do not overflow
+  using Potential = std::int64_t;
+
+  /// The cost matrix of the current problem (always minimized)
+  CostMatrix cost_;
+  /// Number of sources and targets
+  int rows_, cols_;
+  /// whether the current problem is minimized
+  bool minimize_;
+  /// whether the members describe the solution of a previous problem
+  bool hasSolution_;
+  /// the number of rows that had to be searched in the last call
+  int numberOfSearches_;
+  /// Labels of x and labels of y (the last entry of yLabels_ belongs to the virtual root target)
+  std::array<Potential, maxRows> xLabels_;
+  std::array<Potential, maxCols + 1> yLabels_;
+  /// Matching x to y and y to x (-1 for unmatched vertices)
+  std::array<int, maxRows> xyMatching_;
+  std::array<int, maxCols + 1> yxMatching_;
+  /// Smallest reduced cost from the searched sources to y
+  std::array<Potential, maxCols + 1> slack_;
+  /// The previous target on the shortest alternating path to y
+  std::array<int, maxCols + 1> prev_;
+  /// Targets that are already part of the search tree
+  std::array<bool, maxCols + 1> searchedTargets_;
+  /// the result of the last call
+  Matching matching_;
 
   /**
-   * @brief Initialize the corresponding labels to new cost matrix
+   * @brief Initialize the labels of a new problem (empty matching)
    */
   void initLabels();
   /**
-   * @brief adds the given x to the tree.
-   * @param x The vertex to add
-   * @param prevX The vertex that is the previous vertex on the alternating path.
-   */
-  void addToTree(int x, int prevX);
-  /**
-   * @brief updates xLabels_ yLabels_ and slack.
-   * Normally called if augmenting path was not found.
-   */
-  void updateLabels();
-  /**
-   * @brief Returns true iff an augmentedPath was found.
-   * @param q The queue to use for BFS
-   * @param exposedY The exposed vertex on the sink (Y) side. Will be set by this function.
-   * @param lastX The vertex x that is farthest away from the root vertex.
-   * @return True if an augmentable path was found.
+   * @brief Adapts the labels and the matching of the previous problem to the current costs
+   *
+   * Afterwards, the labels are feasible and all remaining matched pairs are tight, so they are
+   * part of an optimal matching of the current problem.
    */
-  bool breadthFirstAlternatingTreeSearch(SimpleQueue<int>& q, int& exposedY, int& lastX);
+  void reuseLabels();
   /**
-   *
-   * @param q The queue to use for BFS
-   * @param exposedY The exposed vertex on the sink (Y) side. Will be set by this function.
-   * @param lastX The vertex x that is farthest away from the root vertex.
-   * @return True if an augmentable path was found.
+   * @brief updateXLabels sets every x label to the largest feasible value for the current y labels
    */
-  bool searchForExposedX(SimpleQueue<int>& q, int& exposedY, int& lastX);
+  void updateXLabels();
   /**
-   * @brief Calculates a maximum matching.
+   * @brief Adds an unmatched source to the matching along a shortest augmenting path
+   * @param x The source to add
    */
-  void augment();
+  void augment(int x);
 };
-
@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Tools/Math/HungarianMethod.hpp"
+
+/*
+ * This benchmarks the HungarianMethod on problems like the ones of the ball search.
+ *
+ * Usage: hungarianMethodBenchmark [<cycles>]
+ *
+ * Robots walk over a 9m x 6m field and the costs are the times in ms that they need to reach the
+ * positions to explore. Between two cycles the robots move a few centimeters, so the costs change
+ * slightly. Every problem is solved by a solver that keeps its previous solution and by a solver
+ * that is reset before every call. Both results are compared with each other and small problems
+ * are additionally compared with the optimum that is found by trying all permutations.
+ */
+
+namespace
+{
+  using CostMatrix = HungarianMethod::CostMatrix;
+
+  /**
+   * @brief matchingCost sums up the costs of a matching
+   * @param cost the cost matrix
+   * @param matching the matching
+   * @return the sum of the costs of all matched pairs
+   */
+  long long matchingCost(const CostMatrix& cost, const HungarianMethod::Matching& matching)
+  {
+    long long sum = 0;
+    for (int c = 0; c < matching.cols(); c++)
+    {
+      sum += cost(matching(0, c), matching(1, c));
+    }
+    return sum;
+  }
+
+  /**
+   * @brief bruteForceMinimum tries all assignments of a square problem
+   * @param cost the cost matrix
+   * @return the minimum sum of costs
+   */
+  long long bruteForceMinimum(const CostMatrix& cost)
+  {
+    std::vector<int> permutation(cost.cols());
+    std::iota(permutation.begin(), permutation.end(), 0);
+    long long minimum = std::numeric_limits<long long>::max();
+    do
+    {
+      long long sum = 0;
+      for (int x = 0; x < cost.rows(); x++)
+      {
+        sum += cost(x, permutation[x]);
+      }
+      minimum = std::min(minimum, sum);
+    } while (std::next_permutation(permutation.begin(), permutation.end()));
+    return minimum;
+  }
+
+  struct Position
+  {
+    float x, y;
+  };
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  const unsigned int cycles = argc > 1 ? std::max<unsigned int>(std::stoul(argv[1]), 1) : 10000;
+
+  std::default_random_engine engine(42);
+  std::uniform_real_distribution<float> fieldX(-4.5f, 4.5f);
+  std::uniform_real_distribution<float> fieldY(-3.f, 3.f);
+  std::uniform_real_distribution<float> step(-0.03f, 0.03f);
+
+  bool success = true;
+  for (const int robots : {5, 6, 7})
+  {
+    for (const int positions : {robots, 16, 48})
+    {
+      std::vector<Position> robotPositions(robots);
+      std::vector<Position> targets(positions);
+      for (auto& robot : robotPositions)
+      {
+        robot = {fieldX(engine), fieldY(engine)};
+      }
+      for (auto& target : targets)
+      {
+        target = {fieldX(engine), fieldY(engine)};
+      }
+
+      HungarianMethod warmSolver;
+      HungarianMethod coldSolver;
+      CostMatrix cost(robots, positions);
+      double warmTime = 0, coldTime = 0, maximumWarmTime = 0;
+      long long searches = 0;
+      unsigned int mismatches = 0;
+      for (unsigned int cycle = 0; cycle < cycles; cycle++)
+      {
+        for (int x = 0; x < robots; x++)
+        {
+          auto& robot = robotPositions[x];
+          robot.x = std::min(std::max(robot.x + step(engine), -4.5f), 4.5f);
+          robot.y = std::min(std::max(robot.y + step(engine), -3.f), 3.f);
+          for (int y = 0; y < positions; y++)
+          {
+            // walking with 0.2 m/s
+            cost(x, y) = static_cast<int>(
+                std::hypot(targets[y].x - robot.x, targets[y].y - robot.y) / 0.2f * 1000.f);
+          }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        const long long warmCost = matchingCost(cost, warmSolver.findMaximumMatching(cost, true));
+        const double time =
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+                .count();
+        warmTime += time;
+        maximumWarmTime = std::max(maximumWarmTime, time);
+        searches += warmSolver.getNumberOfSearches();
+
+        start = std::chrono::steady_clock::now();
+        coldSolver.reset();
+        const long long coldCost = matchingCost(cost, coldSolver.findMaximumMatching(cost, true));
+        coldTime +=
+            std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+                .count();
+
+        if (warmCost != coldCost ||
+            (robots == positions && cycle % 100 == 0 && coldCost != bruteForceMinimum(cost)))
+        {
+          mismatches++;
+        }
+      }
+      success &= mismatches == 0;
+
+      std::cout << robots << " x " << positions << ": cold " << coldTime / cycles
+                << " ns, warm " << warmTime / cycles << " ns (max " << maximumWarmTime
+                << " ns, " << static_cast<double>(searches) / cycles
+                << " searches), mismatches " << mismatches << "\n";
+    }
+  }
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,31 +1,197 @@
+#include <atomic>
+#include <cmath>
+#include <random>
+
 #include "Random.hpp"
 
-Random::Random() :
-  rd_(),
-  engine_(rd_())
+namespace
+{
+  /**
+   * @brief mix is the finalizer of SplitMix64, it maps a 64 bit number to a well distributed one
+   * @param x the number that is mixed
+   * @return the mixed number
+   */
+  inline std::uint64_t mix(std::uint64_t x)
+  {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+  }
+
+  /**
+   * @brief toUnitFloat converts random bits to a float in [0, 1)
+   * @param bits 64 uniformly distributed bits of which the upper 24 are used
+   * @return a number in [0, 1)
+   */
+  inline float toUnitFloat(std::uint64_t bits)
+  {
+    return static_cast<float>(bits >> 40) * (1.f / 16777216.f);
+  }
+
+  /// the seed of new streams, drawn from a random device unless it is set explicitly
+  std::atomic<std::uint64_t> globalSeed(
+      (static_cast<std::uint64_t>(std::random_device()()) << 32) ^ std::random_device()());
+  /// the number of threads that already got a thread stream
+  std::atomic<std::uint64_t> threadCount(0);
+}
+
+thread_local Random::Stream* Random::currentStream_ = nullptr;
+
+Random::Stream::Stream(std::uint64_t seed, std::uint64_t id)
+{
+  this->seed(seed, id);
+}
+
+void Random::Stream::seed(std::uint64_t seed, std::uint64_t id)
+{
+  key_ = mix(seed ^ mix(id + 0x9E3779B97F4A7C15ull));
+  counter_ = 0;
+  hasSpareGaussian_ = false;
+  spareGaussian_ = 0.f;
+}
+
+std::uint64_t Random::Stream::next()
+{
+  return mix(key_ + (++counter_) * 0x9E3779B97F4A7C15ull);
+}
+
+float Random::Stream::uniformFloat(float min, float max)
+{
+  return min + (max - min) * toUnitFloat(next());
+}
+
+float Random::Stream::gaussianFloat(float mean, float stddev)
+{
+  if (hasSpareGaussian_)
+  {
+    hasSpareGaussian_ = false;
+    return mean + stddev * spareGaussian_;
+  }
+  float first, second;
+  standardGaussianPair(first, second);
+  spareGaussian_ = second;
+  hasSpareGaussian_ = true;
+  return mean + stddev * first;
+}
+
+int Random::Stream::uniformInt(int min, int max)
+{
+  // Multiply and shift maps 32 random bits to the range. The bias of this is negligible for the
+  // small ranges that are used (e.g. indices of points).
+  const std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min) + 1;
+  return static_cast<int>(min + static_cast<std::int64_t>(((next() >> 32) * range) >> 32));
+}
+
+void Random::Stream::uniformFloats(float* values, std::size_t count, float min, float max)
+{
+  const float scale = (max - min) * (1.f / 16777216.f);
+  std::size_t i = 0;
+  // every 64 bit block provides the bits for two floats
+  for (; i + 1 < count; i += 2)
+  {
+    const std::uint64_t bits = next();
+    values[i] = min + scale * static_cast<float>((bits >> 40) & 0xFFFFFF);
+    values[i + 1] = min + scale * static_cast<float>((bits >> 8) & 0xFFFFFF);
+  }
+  if (i < count)
+  {
+    values[i] = uniformFloat(min, max);
+  }
+}
+
+void Random::Stream::gaussianFloats(float* values, std::size_t count, float mean, float stddev)
+{
+  std::size_t i = 0;
+  for (; i + 1 < count; i += 2)
+  {
+    standardGaussianPair(values[i], values[i + 1]);
+    values[i] = mean + stddev * values[i];
+    values[i + 1] = mean + stddev * values[i + 1];
+  }
+  if (i < count)
+  {
+    values[i] = gaussianFloat(mean, stddev);
+  }
+}
+
+void Random::Stream::standardGaussianPair(float& first, float& second)
+{
+  // Box-Muller transform, the first uniform number must not be 0 because of the logarithm
+  const std::uint64_t bits = next();
+  const float u1 = (static_cast<float>((bits >> 40) & 0xFFFFFF) + 1.f) * (1.f / 16777216.f);
+  const float u2 = static_cast<float>((bits >> 8) & 0xFFFFFF) * (1.f / 16777216.f);
+  const float radius = std::sqrt(-2.f * std::log(u1));
+  const float angle = 2.f * static_cast<float>(M_PI) * u2;
+  first = radius * std::cos(angle);
+  second = radius * std::sin(angle);
+}
+
+Random::ScopedStream::ScopedStream(Stream& stream)
+  : previous_(currentStream_)
+{
+  currentStream_ = &stream;
+}
+
+Random::ScopedStream::~ScopedStream()
+{
+  currentStream_ = previous_;
+}
+
+void Random::setSeed(std::uint64_t seed)
+{
+  globalSeed = seed;
+}
+
+std::uint64_t Random::getSeed()
+{
+  return globalSeed;
+}
+
+std::uint64_t Random::getStreamId(const std::string& name)
 {
+  // FNV-1a because std::hash is not guaranteed to be the same in every run
+  std::uint64_t hash = 0xCBF29CE484222325ull;
+  for (const char c : name)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
 }
 
-Random& Random::getInstance()
+Random::Stream& Random::getStream()
 {
-  static Random instance;
-  return instance;
+  if (currentStream_ != nullptr)
+  {
+    return *currentStream_;
+  }
+  // Threads without a scoped stream get their own stream so that they do not share state. Its id
+  // depends on the order in which the threads first use Random.
+  thread_local Stream threadStream(globalSeed, ++threadCount);
+  return threadStream;
 }
 
 float Random::uniformFloat(float min, float max)
 {
-  std::uniform_real_distribution<float> uniform(min, max);
-  return uniform(getInstance().engine_);
+  return getStream().uniformFloat(min, max);
 }
 
 float Random::gaussianFloat(float mean, float stddev)
 {
-  std::normal_distribution<float> normal(mean, stddev);
-  return normal(getInstance().engine_);
+  return getStream().gaussianFloat(mean, stddev);
 }
 
 int Random::uniformInt(int min, int max)
 {
-  std::uniform_int_distribution<int> uniform(min, max);
-  return uniform(getInstance().engine_);
+  return getStream().uniformInt(min, max);
+}
+
+void Random::uniformFloats(float* values, std::size_t count, float min, float max)
+{
+  getStream().uniformFloats(values, count, min, max);
+}
+
+void Random::gaussianFloats(float* values, std::size_t count, float mean, float stddev)
+{
+  getStream().gaussianFloats(values, count, mean, stddev);
 }
@@ -1,9 +1,132 @@
 #pragma once
 
-#include <random>
+#include <cstddef>
+#include <cstdint>
+#include <string>
 
 class Random {
 public:
+  /**
+   * @brief Stream is a counter based pseudorandom number generator
+   *
+   * The n-th number of a stream only depends on the seed, the stream id and n. Streams with the
+   * same seed and id therefore always produce the same sequence, independent of what other streams
+   * (e.g. in other threads) do. A stream must not be used by multiple threads at the same time.
+   */
+  class Stream {
+  public:
+    /**
+     * @brief Stream initializes the stream
+     * @param seed the seed of the stream
+     * @param id an identifier that distinguishes streams with the same seed
+     */
+    Stream(std::uint64_t seed, std::uint64_t id);
+    /**
+     * @brief seed restarts the stream with a new seed and id
+     * @param seed the seed of the stream
+     * @param id an identifier that distinguishes streams with the same seed
+     */
+    void seed(std::uint64_t seed, std::uint64_t id);
+    /**
+     * @brief next gets the next 64 random bits of the stream
+     * @return 64 uniformly distributed bits
+     */
+    std::uint64_t next();
+    /**
+     * @brief uniformFloat gets a pseudorandom number in the range [min, max)
+     * @param min the (inclusive) lowest number that this function may return
+     * @param max the (exlusive) highest number that this function may return
+     * @return a pseudorandom number in the range [min, max)
+     */
+    float uniformFloat(float min = 0, float max = 1);
+    /**
+     * @brief gaussianFloat gets a number according to a univariate normal distribution
+     * @param mean the mean of the distribution
+     * @param stddev the standard deviation of the distribution
+     * @return a pseudorandom number from a normal distribution
+     */
+    float gaussianFloat(float mean, float stddev);
+    /**
+     * @brief uniformInt gets a pseudorandom number in the range [min, max]
+     * @param min the (inclusive) lowest number that this function may return
+     * @param max the (inclusive) highest number that this function may return
+     * @return a pseudorandom number in the range [min, max]
+     */
+    int uniformInt(int min, int max);
+    /**
+     * @brief uniformFloats fills an array with pseudorandom numbers in the range [min, max)
+     * @param values the array that is filled
+     * @param count the number of elements in the array
+     * @param min the (inclusive) lowest number that may be generated
+     * @param max the (exlusive) highest number that may be generated
+     */
+    void uniformFloats(float* values, std::size_t count, float min = 0, float max = 1);
+    /**
+     * @brief gaussianFloats fills an array with numbers from a univariate normal distribution
+     * @param values the array that is filled
+     * @param count the number of elements in the array
+     * @param mean the mean of the distribution
+     * @param stddev the standard deviation of the distribution
+     */
+    void gaussianFloats(float* values, std::size_t count, float mean, float stddev);
+
+  private:
+    /**
+     * @brief standardGaussianPair generates two independent standard normal numbers
+     * @param first the first number
+     * @param second the second number
+     */
+    void standardGaussianPair(float& first, float& second);
+    /// the key that is derived from seed and id
+    std::uint64_t key_;
+    /// the number of 64 bit blocks that have been generated so far
+    std::uint64_t counter_;
+    /// whether spareGaussian_ holds an unused standard normal number
+    bool hasSpareGaussian_;
+    /// the second number of the last Box-Muller transform
+    float spareGaussian_;
+  };
+
+  /**
+   * @brief ScopedStream makes a stream the current stream of the calling thread while it exists
+   */
+  class ScopedStream {
+  public:
+    /**
+     * @brief ScopedStream makes a stream the current stream of this thread
+     * @param stream the stream that the static functions of Random should use
+     */
+    ScopedStream(Stream& stream);
+    /**
+     * @brief ~ScopedStream restores the previous stream of this thread
+     */
+    ~ScopedStream();
+    ScopedStream(const ScopedStream&) = delete;
+    ScopedStream& operator=(const ScopedStream&) = delete;
+  private:
+    /// the stream that was current before
+    Stream* previous_;
+  };
+
+  /**
+   * @brief setSeed sets the seed that new streams are started with
+   *
+   * Streams that have been created before are not affected. If this is never called, the seed is
+   * taken from a random device at startup.
+   * @param seed the new global seed
+   */
+  static void setSeed(std::uint64_t seed);
+  /**
+   * @brief getSeed gets the seed that new streams are started with
+   * @return the global seed
+   */
+  static std::uint64_t getSeed();
+  /**
+   * @brief getStreamId calculates a stream id from a name (e.g. a module mount)
+   * @param name the name of the stream
+   * @return an id that is the same for the same name in every run
+   */
+  static std::uint64_t getStreamId(const std::string& name);
   /**
    * @brief uniformFloat gets a pseudorandom number in the range [min, max)
    * @param min the (inclusive) lowest number that this function may return
@@ -25,18 +148,31 @@ public:
    * @return a pseudorandom number in the range [min, max]
    */
   static int uniformInt(int min, int max);
-private:
   /**
-   * @brief Random initializes members
+   * @brief uniformFloats fills an array with pseudorandom numbers in the range [min, max)
+   * @param values the array that is filled
+   * @param count the number of elements in the array
+   * @param min the (inclusive) lowest number that may be generated
+   * @param max the (exlusive) highest number that may be generated
    */
-  Random();
+  static void uniformFloats(float* values, std::size_t count, float min = 0, float max = 1);
+  /**
+   * @brief gaussianFloats fills an array with numbers from a univariate normal distribution
+   * @param values the array that is filled
+   * @param count the number of elements in the array
+   * @param mean the mean of the distribution
+   * @param stddev the standard deviation of the distribution
+   */
+  static void gaussianFloats(float* values, std::size_t count, float mean, float stddev);
+private:
   /**
-   * @brief getInstance gets an instance of the Random class
-   * @param a reference to an instance of the Random class
+   * @brief getStream gets the current stream of the calling thread
+   *
+   * This is the stream of a ScopedStream if there is one (e.g. the stream of the module that is
+   * running) and a stream that belongs to the thread otherwise.
+   * @return the current stream of the calling thread
    */
-  static Random& getInstance();
-  /// random device, only needed at initialization
-  std::random_device rd_;
-  /// (pseduo-)random number engine
-  std::mt19937 engine_;
+  static Stream& getStream();
+  /// the stream that has been made current by a ScopedStream, nullptr if there is none
+  static thread_local Stream* currentStream_;
 };
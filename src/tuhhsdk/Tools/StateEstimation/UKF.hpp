@@ -45,25 +45,27 @@ public:
   virtual void generateSigmaPoints();
   /**
    * @brief predict the UC-predict mapping the old state onto a new state.
-   * @param args some external input (e.g. to account non-linearity)
-   * @return the transformed state distribution
+   * @tparam PredictFunction a callable VectorN(const VectorN& sigmaPoint), it is taken as template
+   * parameter so that the process model can be inlined for every sigma point
+   * @param stateSpacePredictFunction the (nonlinear) process model
+   * @param processNoise the covariance of the additive process noise
    */
-  void predictWithAWGN(std::function<VectorN(const VectorN& sigmaPoint)> stateSpacePredictFunction,
-                       const MatrixN& processNoise);
+  template <typename PredictFunction>
+  void predictWithAWGN(PredictFunction&& stateSpacePredictFunction, const MatrixN& processNoise);
   /**
    * @brief update the UC-update correcting the state with some external knowledge. Use this for
    * nonlinear observation functions. Note: For linear observation functions, this is overkill. Use
    * classical kalman update instead.
    * @param observation the nZ dimensional observation
    * @param observationNoise the covariance of the of the observation
+   * @tparam ObservationFunction a callable Eigen::Matrix<float, nZ, 1>(const VectorN& sigmaPoint)
    * @param predictObservationFromStateSpace a mapping from the state space to the space of
    * observation (which observation would a given state make)
    */
-  template <int nZ>
+  template <int nZ, typename ObservationFunction>
   void updateWithAWGN(const Eigen::Matrix<float, nZ, 1>& observation,
                       const Eigen::Matrix<float, nZ, nZ>& observationNoise,
-                      std::function<Eigen::Matrix<float, nZ, 1>(const VectorN& sigmaPoint)>
-                          predictObservationFromStateSpace);
+                      ObservationFunction&& predictObservationFromStateSpace);
 
 protected:
   /// the n-dimensional mean of the state random variable
@@ -48,15 +48,17 @@ void UKF<n>::generateSigmaPoints()
 }
 
 template <int n>
-void UKF<n>::predictWithAWGN(
-    std::function<VectorN(const VectorN& sigmaPoint)> stateSpacePredictFunction,
-    const MatrixN& processNoise)
+template <typename PredictFunction>
+void UKF<n>::predictWithAWGN(PredictFunction&& stateSpacePredictFunction,
+                             const MatrixN& processNoise)
 {
   // generate the sigma points for the unscented transformation
   generateSigmaPoints();
   // Propagate each sigma point through the nonlinear predict function
-  std::transform(sigmaPoints_.begin(), sigmaPoints_.end(), sigmaPoints_.begin(),
-                 stateSpacePredictFunction);
+  for (auto& sigmaPoint : sigmaPoints_)
+  {
+    sigmaPoint = stateSpacePredictFunction(sigmaPoint);
+  }
 
   std::tie(stateMean_, stateCov_) = computeStatistics(sigmaPoints_);
   stateCov_ += processNoise;
@@ -65,18 +67,19 @@ void UKF<n>::predictWithAWGN(
 
 
 template <int n>
-template <int nZ>
+template <int nZ, typename ObservationFunction>
 void UKF<n>::updateWithAWGN(const Eigen::Matrix<float, nZ, 1>& observation,
                             const Eigen::Matrix<float, nZ, nZ>& observationNoise,
-                            std::function<Eigen::Matrix<float, nZ, 1>(const VectorN& sigmaPoint)>
-                                predictObservationFromStateSpace)
+                            ObservationFunction&& predictObservationFromStateSpace)
 {
   // generate the sigmaPoints_ for the UC predict
   generateSigmaPoints();
   // Propagate each sigma point through the nonlinear observation function
   std::array<Eigen::Matrix<float, nZ, 1>, numOfSigmaPoints> predictedObservations;
-  std::transform(sigmaPoints_.begin(), sigmaPoints_.end(), predictedObservations.begin(),
-                 predictObservationFromStateSpace);
+  for (unsigned int i = 0; i < numOfSigmaPoints; i++)
+  {
+    predictedObservations[i] = predictObservationFromStateSpace(sigmaPoints_[i]);
+  }
   // compute statistics of predicted observation
   Eigen::Matrix<float, nZ, 1> predictedObservationsMean;
   Eigen::Matrix<float, nZ, nZ> predictedObservationsCov;
@@ -2,7 +2,7 @@
 
 
 // Need to initialize static member outside class
-#if defined(NAOV6)
+#if defined(NAOV6) || defined(BEHAVIOR_BENCHMARK) || defined(MOTION_BENCHMARK)
 std::chrono::time_point<std::chrono::steady_clock> TimePoint::baseTime_ =
     std::chrono::steady_clock::now() - std::chrono::milliseconds(2000);
 #elif defined(NAOV5) || defined(REPLAY)
@@ -79,7 +79,7 @@ public:
    */
   static TimePoint getCurrentTime()
   {
-#if defined(NAOV6)
+#if defined(NAOV6) || defined(BEHAVIOR_BENCHMARK) || defined(MOTION_BENCHMARK)
     auto duration = std::chrono::steady_clock::now() - baseTime_;
     return TimePoint(static_cast<uint32_t>(
         std::chrono::duration_cast<std::chrono::milliseconds>(duration).count()));
@@ -255,8 +255,9 @@ private:
   // timestamps when it comes to camera images (timestamps are determined by kernel), we decided to
   // handle the base time like the camera image time on every single system. Therefore v5 is using a
   // chrono system clock timestamp, v6 is using a steady clock time stamp and simrobot uses a
-  // unsigned int (simulation time starts at 0).
-#if defined(NAOV6)
+  // unsigned int (simulation time starts at 0). The offline benchmarks have no camera and use the
+  // steady clock like v6.
+#if defined(NAOV6) || defined(BEHAVIOR_BENCHMARK) || defined(MOTION_BENCHMARK)
   /// The base time used for every TimePoint as a chrono steady clock
   static std::chrono::time_point<std::chrono::steady_clock> baseTime_;
 #elif defined(NAOV5) || defined(REPLAY)
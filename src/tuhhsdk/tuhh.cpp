@@ -15,6 +15,7 @@
 
 #include "tuhh.hpp"
 
+#include "Tools/Math/Random.hpp"
 #include "Tools/Storage/XPMImage.hpp"
 
 TUHH::TUHH(RobotInterface& robotInterface)
@@ -52,6 +53,17 @@ TUHH::TUHH(RobotInterface& robotInterface)
   tuhhprint::print("The current loglevel is " + tuhhprint::preString[(int)ll], LogLevel::INFO);
   tuhhprint::setLogLevel(ll);
 
+  // A seed of 0 keeps the seed from the random device. The seed is printed so that a run can be
+  // reproduced by configuring it.
+  const std::int64_t randomSeed = config_.get("tuhhSDK.base", "randomSeed").asInt64();
+  if (randomSeed != 0)
+  {
+    Random::setSeed(static_cast<std::uint64_t>(randomSeed));
+  }
+  tuhhprint::print("The random seed is " +
+                       std::to_string(static_cast<std::int64_t>(Random::getSeed())),
+                   LogLevel::INFO);
+
   if (config_.get("tuhhSDK.base", "local.enableFileTransport").asBool())
   {
     std::string fileTransportRoot = interface_.getDataRoot();
@@ -117,7 +129,7 @@ TUHH::~TUHH()
   usc_ = nullptr;
 #endif
   tuhhprint::setLogLevel(LogLevel::VERBOSE);
-  fftw_cleanup();
+  fftwf_cleanup();
   // This makes sure that all transports are destroyed before the Debug destructor is invoked.
   // It is necessary because transports have a reference to Debug which will become invalid then.
   debug_.removeAllTransports();
@@ -10,7 +10,7 @@ BoxCandidatesProvider::BoxCandidatesProvider(const ModuleManagerInterface& manag
   , imageData_(*this)
   , integralImageData_(*this)
   , fieldBorder_(*this)
-  , fieldColor_(*this)
+  , colorClassTable_(*this)
   , fieldDimensions_(*this)
   , robotProjection_(*this)
 
@@ -76,16 +76,21 @@ void BoxCandidatesProvider::cycle()
   sendDebug();
 }
 
-void BoxCandidatesProvider::calculateBlockRating(int& blockY, int& blockX,
-                                                 CandidateBox& bestResult) const
+Rectangle<int> BoxCandidatesProvider::getIntegralBlock(int blockY, int blockX) const
 {
-  // integral image coordintates of the current block
   const Vector2i integralTopLeft(blockX * blockSize_() / integralImageData_->image.scale,
                                  blockY * blockSize_() / integralImageData_->image.scale);
   const Vector2i integralBottomRight(
       (blockX * blockSize_() + blockSize_()) / integralImageData_->image.scale,
       (blockY * blockSize_() + blockSize_()) / integralImageData_->image.scale);
-  const Rectangle<int> integralBlock(integralTopLeft, integralBottomRight);
+  return Rectangle<int>(integralTopLeft, integralBottomRight);
+}
+
+void BoxCandidatesProvider::calculateBlockRating(int& blockY, int& blockX, int pixelRadius,
+                                                 CandidateBox& bestResult) const
+{
+  // integral image coordintates of the current block
+  const Rectangle<int> integralBlock = getIntegralBlock(blockY, blockX);
 
   // position of the center in the original 422 image
   const Vector2i pixelCenterPosition =
@@ -99,10 +104,7 @@ void BoxCandidatesProvider::calculateBlockRating(int& blockY, int& blockX,
   {
     return;
   }
-  // estimated ball radius in pixel valid for the entire block to reduce computation
-  int pixelRadius = 0;
-  if (!cameraMatrix_->getPixelRadius(imageData_->image422.size, pixelCenterPosition,
-                                     fieldDimensions_->ballDiameter / 2, pixelRadius))
+  if (pixelRadius < 0)
   {
     Log(LogLevel::ERROR) << "Projection failed!";
     return;
@@ -149,13 +151,31 @@ void BoxCandidatesProvider::findCandidateBoxes(std::vector<CandidateBox>& candid
   // size of the original image in pixel
   const Vector2i pixelImageSize = Image422::get444From422Vector(imageData_->image422.size);
 
+  const int blocksPerRow = pixelImageSize.x() / blockSize_();
+  Matrix2Xf blockCenters(2, blocksPerRow);
+  ArrayXf pixelRadii;
+  ArrayXb pixelRadiiValid;
+
   for (int blockY = static_cast<int>(std::ceil(horizon / static_cast<float>(blockSize_())));
        blockY < pixelImageSize.y() / blockSize_(); blockY++)
   {
-    for (int blockX = 0; blockX < pixelImageSize.x() / blockSize_(); blockX++)
+    // estimate the ball radius in pixel for the centers of all blocks in this row at once
+    for (int blockX = 0; blockX < blocksPerRow; blockX++)
+    {
+      blockCenters.col(blockX) = Image422::get422From444Vector(
+                                     getIntegralBlock(blockY, blockX).center() *
+                                     integralImageData_->image.scale)
+                                     .cast<float>();
+    }
+    cameraMatrix_->getPixelRadius(imageData_->image422.size, blockCenters,
+                                  fieldDimensions_->ballDiameter / 2, pixelRadii, pixelRadiiValid);
+    for (int blockX = 0; blockX < blocksPerRow; blockX++)
     {
       CandidateBox box;
-      calculateBlockRating(blockY, blockX, box);
+      // the radius is valid for the entire block to reduce computation
+      calculateBlockRating(blockY, blockX,
+                           pixelRadiiValid[blockX] ? static_cast<int>(pixelRadii[blockX]) : -1,
+                           box);
       if (box.rating > minBoxRating_())
       {
         candidates.push_back(box);
@@ -270,7 +290,7 @@ bool BoxCandidatesProvider::sampleBoundingBox(const Circle<int>& circle,
       {
         numberBrightPixels++;
       }
-      if (yByte < darkPixelThreshold_() && fieldColor_->isFieldColor(color) == 0.f)
+      if (yByte < darkPixelThreshold_() && colorClassTable_->fieldColor(color) == 0.f)
       {
         numberDarkPixels++;
       }
@@ -282,8 +302,8 @@ bool BoxCandidatesProvider::sampleBoundingBox(const Circle<int>& circle,
     {
       const unsigned int pos = y * sampleSize * 3 + x * 3;
       const bool isFieldColor =
-          fieldColor_->isFieldColor(YCbCr422(colorSampled[pos], colorSampled[pos + 1],
-                                             colorSampled[pos], colorSampled[pos + 2])) > 0.f;
+          colorClassTable_->fieldColor(YCbCr422(colorSampled[pos], colorSampled[pos + 1],
+                                                colorSampled[pos], colorSampled[pos + 2])) > 0.f;
       if (isFieldColor)
       {
         numFieldColor++;
@@ -3,7 +3,7 @@
 #include "Data/BoxCandidates.hpp"
 #include "Data/CameraMatrix.hpp"
 #include "Data/FieldBorder.hpp"
-#include "Data/FieldColor.hpp"
+#include "Data/ColorClassTable.hpp"
 #include "Data/FieldDimensions.hpp"
 #include "Data/ImageData.hpp"
 #include "Data/ImageSegments.hpp"
@@ -67,7 +67,7 @@ private:
   /// all candidates below fieldBorder will be rejected
   const Dependency<FieldBorder> fieldBorder_;
   /// for checking whether a pixel has fieldColor
-  const Dependency<FieldColor> fieldColor_;
+  const Dependency<ColorClassTable> colorClassTable_;
   /// contains the ballSize
   const Dependency<FieldDimensions> fieldDimensions_;
   /// to check whether a candidate is on the own robot
@@ -105,14 +105,23 @@ private:
   /// number of steps calculated a rating for per ball size
   const ConditionalParameter<int> stepsPerBallSize_;
 
+  /**
+   * Calculates the integral image block of the given block coordinates.
+   * @param blockY the start Y coordinate of the block
+   * @param blockX the start X coordinate of the block
+   * @return the block in integral image coordinates
+   */
+  Rectangle<int> getIntegralBlock(int blockY, int blockX) const;
   /**
    * Calculates the rating of all pixels concerning the stepsPerBallSize_ in the given block and
    * saves the best result in parameter output.
    * @param blockY the start Y coordinate of the block
    * @param blockX the start X coordinate of the block
+   * @param pixelRadius the estimated ball radius in pixel at the center of the block (negative if
+   * the projection failed)
    * @param output reference to the CandidateBox where the best result will be saved
    */
-  void calculateBlockRating(int& blockY, int& blockX, CandidateBox& output) const;
+  void calculateBlockRating(int& blockY, int& blockX, int pixelRadius, CandidateBox& output) const;
   /**
    * Calculates the best rating for all boxes and stores boxes with a rating greater than
    * minBoxRating_ in parameter candidates.
@@ -23,7 +23,7 @@ void CameraCalibration::cycle()
    */
 
   /// torso2ground and head2torso are needed to construct the transformation chain.
-  if (!head_matrix_buffer_->buffer.empty())
+  if (!head_matrix_buffer_->empty())
   {
     const HeadMatrixWithTimestamp& bufferEntry =
         head_matrix_buffer_->getBestMatch(image_data_->timestamp
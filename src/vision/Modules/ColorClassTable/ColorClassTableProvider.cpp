@@ -0,0 +1,76 @@
+#include <algorithm>
+
+#include "Tools/Chronometer.hpp"
+#include "Tools/Storage/Image.hpp"
+
+#include "ColorClassTableProvider.hpp"
+
+ColorClassTableProvider::ColorClassTableProvider(const ModuleManagerInterface& manager)
+  : Module(manager)
+  , maxEntriesPerCycle_(*this, "maxEntriesPerCycle", [] {})
+  , imageData_(*this)
+  , fieldColor_(*this)
+  , colorClassTable_(*this)
+{
+}
+
+void ColorClassTableProvider::buildEntries(std::vector<std::uint8_t>& table,
+                                           const std::size_t begin, const std::size_t end) const
+{
+  for (std::size_t i = begin; i < end; i++)
+  {
+    const YCbCr422 color = ColorClassTable::representative(i);
+    const float fieldColorCertainty = fieldColor_->isFieldColor(color);
+    std::uint8_t entry = 0;
+    if (fieldColorCertainty == 1.f)
+    {
+      entry |= ColorClassTable::FIELD_CERTAIN;
+    }
+    if (fieldColorCertainty >= 0.5f)
+    {
+      entry |= ColorClassTable::FIELD_LIKELY;
+    }
+    if (color.RGB().isSaturated())
+    {
+      entry |= ColorClassTable::SATURATED;
+    }
+    table[i] = entry;
+  }
+}
+
+void ColorClassTableProvider::cycle()
+{
+  Chronometer time(debug(), mount_ + ".cycleTime");
+  CameraTables& tables = cameraTables_[static_cast<std::size_t>(imageData_->camera)];
+  if (tables.active.empty())
+  {
+    // The consumers rely on a table in every cycle, so the first one is built at once.
+    tables.active.resize(ColorClassTable::size);
+    buildEntries(tables.active, 0, ColorClassTable::size);
+    tables.activeRevision = fieldColor_->revision;
+  }
+  else if (tables.pendingEntries > 0 || tables.activeRevision != fieldColor_->revision)
+  {
+    if (tables.pendingEntries == 0)
+    {
+      tables.pending.resize(ColorClassTable::size);
+      tables.pendingRevision = fieldColor_->revision;
+    }
+    // The build uses the current classification even if the revision changed in the meantime.
+    // This only delays the next update.
+    const std::size_t end = std::min<std::size_t>(
+        tables.pendingEntries + std::max(maxEntriesPerCycle_(), 1u), ColorClassTable::size);
+    buildEntries(tables.pending, tables.pendingEntries, end);
+    tables.pendingEntries = end;
+    if (tables.pendingEntries == ColorClassTable::size)
+    {
+      tables.active.swap(tables.pending);
+      tables.activeRevision = tables.pendingRevision;
+      tables.pendingEntries = 0;
+    }
+  }
+  colorClassTable_->entries = tables.active.data();
+  colorClassTable_->valid = true;
+  debug().update(mount_ + "." + imageData_->identification + "_updating",
+                 tables.pendingEntries > 0);
+}
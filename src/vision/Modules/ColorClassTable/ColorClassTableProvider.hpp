@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Framework/Module.hpp"
+
+#include "Data/ColorClassTable.hpp"
+#include "Data/FieldColor.hpp"
+#include "Data/ImageData.hpp"
+
+class Brain;
+
+/**
+ * @brief ColorClassTableProvider provides a lookup table that classifies YCbCr colors
+ *
+ * There is a table for each camera. It is built from the field color classification and the
+ * saturation of the colors and only updated when the revision of the FieldColor changes. The first
+ * table of a camera is built at once so that the table is valid from the first image on. Every
+ * later build is spread over several cycles: the new table is filled in a second buffer while the
+ * old table is still used and the buffers are swapped when the new table is complete.
+ */
+class ColorClassTableProvider : public Module<ColorClassTableProvider, Brain>
+{
+public:
+  /// the name of this module
+  ModuleName name = "ColorClassTableProvider";
+  explicit ColorClassTableProvider(const ModuleManagerInterface& manager);
+  void cycle() override;
+
+private:
+  /// the tables of one camera
+  struct CameraTables
+  {
+    /// the table that is provided (empty until the first image of the camera)
+    std::vector<std::uint8_t> active;
+    /// the table that is being built
+    std::vector<std::uint8_t> pending;
+    /// the number of entries of the pending table that have been built
+    std::size_t pendingEntries = 0;
+    /// the FieldColor revision of the active table
+    unsigned int activeRevision = 0;
+    /// the FieldColor revision at the start of the pending update
+    unsigned int pendingRevision = 0;
+  };
+
+  /**
+   * @brief buildEntries classifies a range of table entries
+   * @param table the table that is filled
+   * @param begin the first entry that is classified
+   * @param end the entry after the last entry that is classified
+   */
+  void buildEntries(std::vector<std::uint8_t>& table, std::size_t begin, std::size_t end) const;
+
+  /// the maximum number of entries that are classified per cycle during an update
+  const Parameter<unsigned int> maxEntriesPerCycle_;
+  /// the image that is currently being processed
+  const Dependency<ImageData> imageData_;
+  /// the field color classification from which the table is built
+  const Dependency<FieldColor> fieldColor_;
+  /// the tables of the top and bottom camera
+  std::array<CameraTables, 2> cameraTables_;
+  /// the table for the current image
+  Production<ColorClassTable> colorClassTable_;
+};
@@ -1,9 +1,10 @@
+#include <algorithm>
+
 #include "FieldBorderDetection.hpp"
 
 #include "Tools/Chronometer.hpp"
 #include "Tools/Math/ColorConverter.hpp"
 #include "Tools/Math/Geometry.hpp"
-#include "Tools/Math/Random.hpp"
 #include "Tools/Storage/Image.hpp"
 
 #include "Definitions/windows_definition_fix.hpp"
@@ -12,6 +13,7 @@ FieldBorderDetection::FieldBorderDetection(const ModuleManagerInterface& manager
   : Module(manager)
   , angleThreshold_(*this, "angleThreshold", [] {})
   , minPointsPerLine_(*this, "minPointsPerLine", [] {})
+  , maxCandidateLines_(*this, "maxCandidateLines", [] {})
   , drawVerticalFilteredSegments_(*this, "drawVerticalFilteredSegments", [] {})
   , drawHorizontalFilteredSegments_(*this, "drawHorizontalFilteredSegments", [] {})
   , drawVerticalEdges_(*this, "drawVerticalEdges", [] {})
@@ -91,136 +93,130 @@ void FieldBorderDetection::findBorderPoints()
   }
 }
 
-void FieldBorderDetection::findBorderLines()
+void FieldBorderDetection::findUpperHull()
 {
-  VecVector2i firstLinePoints, secondLinePoints, firstUnusedPoints, secondUnusedPoints;
-  // Find points for the first line
-  Line<int> line; // temporary dummy line
-  if (!ransac(line, borderPoints_, firstLinePoints, firstUnusedPoints, 20, 2))
+  upperHull_.clear();
+  for (const auto& point : borderPoints_)
   {
-    return;
-  }
-
-  if (static_cast<int>(firstLinePoints.size()) >= minPointsPerLine_())
-  {
-    // Accept line
-    Line<int> first;
-    first = bestFitLine(firstLinePoints);
-    fieldBorder_->borderLines.push_back(first);
-
-    // If enough points are left, check if second line exists
-    if (static_cast<int>(firstUnusedPoints.size()) >= minPointsPerLine_() &&
-        ransac(line, firstUnusedPoints, secondLinePoints, secondUnusedPoints, 20, 4))
+    // The previous hull point is removed if it is not above the line from its predecessor to the
+    // new point (the y axis points downwards in the image).
+    while (upperHull_.size() >= 2)
     {
-      if (static_cast<int>(secondLinePoints.size()) >= minPointsPerLine_())
+      const Vector2i& a = upperHull_[upperHull_.size() - 2];
+      const Vector2i& b = upperHull_.back();
+      const int cross =
+          (b.x() - a.x()) * (point.y() - a.y()) - (b.y() - a.y()) * (point.x() - a.x());
+      if (cross > 0)
       {
-        Line<int> second;
-        second = bestFitLine(secondLinePoints);
-        // Check if second line is orthogonal to first
-        if (isOrthogonal(first, second))
-        {
-          // Accept line
-          fieldBorder_->borderLines.push_back(second);
-          // Two have been found
-        }
-        else
-        {
-          // Only one line has been found
-        }
+        break;
       }
+      upperHull_.pop_back();
     }
-  }
-  else
-  {
-    // Only one line has been found
+    upperHull_.push_back(point);
   }
 }
 
-bool FieldBorderDetection::ransac(Line<int>& bestLine, const VecVector2<int>& points,
-                                  VecVector2<int>& best, VecVector2<int>& unused,
-                                  unsigned int iterations, int max_distance)
+void FieldBorderDetection::findCandidateLines()
 {
-  bool valid = false;
-  Line<int> line;
-  int distance;
-  const int sqr_max_distance = max_distance * max_distance;
-  // Keep a buffer and a back-buffer, if we found the best line,
-  // just swap the buffer and add to the other, until we find a better one.
-  VecVector2<int> current_used_1, current_unused_1;
-  VecVector2<int> current_used_2, current_unused_2;
-
-  VecVector2<int>* current_used = &current_used_1;
-  VecVector2<int>* current_unused = &current_unused_1;
-
-  unsigned int max_score = 0;
-  if (points.size() < 2)
-  {
-    best.clear();
-    unused = points;
-    return valid;
-  }
-
-  current_used_1.reserve(points.size());
-  current_used_2.reserve(points.size());
-  current_unused_1.reserve(points.size());
-  current_unused_2.reserve(points.size());
-
-  for (unsigned int i = 0; i < iterations; i++)
+  candidateLines_.clear();
+  for (std::size_t i = 0; i + 1 < upperHull_.size(); i++)
   {
-    line.p1 = points[Random::uniformInt(0, points.size() - 1)];
-    line.p2 = points[Random::uniformInt(0, points.size() - 1)];
-
-    if (line.p1 == line.p2)
+    candidateLines_.emplace_back(upperHull_[i], upperHull_[i + 1]);
+    if (i + 2 < upperHull_.size())
     {
-      continue;
+      candidateLines_.emplace_back(upperHull_[i], upperHull_[i + 2]);
     }
-    current_used->clear();
-    current_unused->clear();
+  }
+  // Long candidates are supported by many border points, short ones are mostly caused by noise.
+  const std::size_t numberOfCandidates =
+      std::min<std::size_t>(maxCandidateLines_(), candidateLines_.size());
+  std::partial_sort(candidateLines_.begin(), candidateLines_.begin() + numberOfCandidates,
+                    candidateLines_.end(), [](const Line<int>& l1, const Line<int>& l2) {
+                      return (l1.p2.x() - l1.p1.x()) > (l2.p2.x() - l2.p1.x());
+                    });
+  candidateLines_.resize(numberOfCandidates);
+}
 
+unsigned int FieldBorderDetection::findBestCandidate(const VecVector2i& points,
+                                                     const int maxDistance,
+                                                     Line<int>& bestLine) const
+{
+  const int squaredMaxDistance = maxDistance * maxDistance;
+  unsigned int bestScore = 0;
+  for (const auto& line : candidateLines_)
+  {
+    unsigned int score = 0;
     for (const auto& point : points)
     {
-      distance = Geometry::getSquaredLineDistance(line, point);
-      assert(distance >= 0);
-
-      if (distance <= sqr_max_distance)
-      {
-        current_used->push_back(point);
-      }
-      else
-      {
-        current_unused->push_back(point);
-      }
+      score += Geometry::getSquaredLineDistance(line, point) <= squaredMaxDistance;
     }
-
-    if (current_used->size() > max_score)
+    if (score > bestScore)
     {
-      max_score = current_used->size();
+      bestScore = score;
       bestLine = line;
-      if (current_used == &current_used_1)
-      {
-        current_used = &current_used_2;
-        current_unused = &current_unused_2;
-      }
-      else
-      {
-        current_used = &current_used_1;
-        current_unused = &current_unused_1;
-      }
     }
   }
+  return bestScore;
+}
 
-  best = current_used == &current_used_1 ? current_used_2 : current_used_1;
-  unused = current_unused == &current_unused_1 ? current_unused_2 : current_unused_1;
+void FieldBorderDetection::splitPoints(const Line<int>& line, const VecVector2i& points,
+                                       const int maxDistance, VecVector2i& inliers,
+                                       VecVector2i& outliers) const
+{
+  const int squaredMaxDistance = maxDistance * maxDistance;
+  inliers.clear();
+  outliers.clear();
+  for (const auto& point : points)
+  {
+    if (Geometry::getSquaredLineDistance(line, point) <= squaredMaxDistance)
+    {
+      inliers.push_back(point);
+    }
+    else
+    {
+      outliers.push_back(point);
+    }
+  }
+}
 
-  if (best.empty() || bestLine.p1 == bestLine.p2)
+void FieldBorderDetection::findBorderLines()
+{
+  // The vertical scanlines are ordered from left to right, so this is usually only a check.
+  if (!std::is_sorted(borderPoints_.begin(), borderPoints_.end(),
+                      [](const Vector2i& p1, const Vector2i& p2) { return p1.x() < p2.x(); }))
   {
-    best.clear();
-    unused = points;
-    return valid;
+    std::sort(borderPoints_.begin(), borderPoints_.end(),
+              [](const Vector2i& p1, const Vector2i& p2) { return p1.x() < p2.x(); });
   }
+  findUpperHull();
+  findCandidateLines();
 
-  valid = true;
-  return valid;
+  // Find points for the first line
+  Line<int> line;
+  if (static_cast<int>(findBestCandidate(borderPoints_, 2, line)) < minPointsPerLine_())
+  {
+    return;
+  }
+  splitPoints(line, borderPoints_, 2, firstLinePoints_, remainingPoints_);
+  // Accept line
+  const Line<int> first = bestFitLine(firstLinePoints_);
+  fieldBorder_->borderLines.push_back(first);
+
+  // If enough points are left, check if second line exists
+  if (static_cast<int>(remainingPoints_.size()) < minPointsPerLine_() ||
+      static_cast<int>(findBestCandidate(remainingPoints_, 4, line)) < minPointsPerLine_())
+  {
+    // Only one line has been found
+    return;
+  }
+  splitPoints(line, remainingPoints_, 4, secondLinePoints_, unusedPoints_);
+  const Line<int> second = bestFitLine(secondLinePoints_);
+  // Check if second line is orthogonal to first
+  if (isOrthogonal(first, second))
+  {
+    // Accept line
+    fieldBorder_->borderLines.push_back(second);
+  }
 }
 
 void FieldBorderDetection::createFilteredSegments()
@@ -244,7 +240,7 @@ void FieldBorderDetection::createFilteredSegments()
   {
     bool foundField = false;
     bool noOtherInterestingSegments = false;
-    for (const auto& segment : scanline.segments)
+    for (const auto& segment : imageSegments_->getSegments(scanline))
     {
       if (noOtherInterestingSegments)
       {
@@ -286,8 +282,12 @@ void FieldBorderDetection::cycle()
     fieldBorder_->imageSize = imageData_->image422.size;
     // Find border points
     findBorderPoints();
-    // Find the border lines
-    findBorderLines();
+    {
+      Chronometer borderTime(debug(),
+                             mount_ + "." + imageData_->identification + "_border_lines_time");
+      // Find the border lines
+      findBorderLines();
+    }
     createFilteredSegments();
   }
   sendImagesForDebug();
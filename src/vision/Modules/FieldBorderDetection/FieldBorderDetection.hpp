@@ -18,8 +18,11 @@ class Brain;
  * @brief The FieldBorderDetection class
  *
  * This class takes all found field segments and marks the top points as potential field border
- * points. Using the RANSAC algorithm, the best line for all field border points is determined. If
- * there are enought points left, a second and a third line will be detected.
+ * points. The upper convex hull of these points provides a bounded number of candidate lines. The
+ * candidate with the most supporting points becomes the first border line. If there are enough
+ * points left, a second line that is orthogonal to the first one is searched among the candidates.
+ * The runtime is linear in the number of border points and does not depend on the clutter in the
+ * image.
  *
  * @author Florian Bergmann
  */
@@ -39,7 +42,7 @@ public:
   /**
    * @brief cycle
    *
-   * Determines the border points and uses RANSAC to find the field border lines
+   * Determines the border points and fits the field border lines to their upper convex hull
    *
    * @author Florian Bergmann
    */
@@ -100,19 +103,48 @@ private:
    * @author Florian Bergmann
    */
   Line<int> bestFitLine(VecVector2i points);
+  /**
+   * @brief findUpperHull computes the upper convex hull of the border points (monotone chain)
+   *
+   * The field below the border is convex in the image. Border points that are too low (e.g.
+   * because a robot occludes the field border) lie inside of the hull.
+   */
+  void findUpperHull();
+  /**
+   * @brief findCandidateLines creates the candidate border lines from the upper convex hull
+   *
+   * Candidates are the edges of the hull and the lines that skip one hull point (such that a
+   * single point above the field border does not hide the line). Only the candidates with the
+   * largest horizontal extent are kept.
+   */
+  void findCandidateLines();
+  /**
+   * @brief findBestCandidate finds the candidate line that has the most points close to it
+   * @param points the points that may support a candidate
+   * @param maxDistance the maximum distance (in pixels) of a supporting point to the line
+   * @param bestLine the candidate with the most supporting points
+   * @return the number of supporting points of the best candidate
+   */
+  unsigned int findBestCandidate(const VecVector2i& points, int maxDistance,
+                                 Line<int>& bestLine) const;
+  /**
+   * @brief splitPoints splits points into the points close to a line and the others
+   * @param line the line to which the distance is computed
+   * @param points the points to split
+   * @param maxDistance the maximum distance (in pixels) of a point close to the line
+   * @param inliers the points close to the line (in the order of points)
+   * @param outliers the remaining points (in the order of points)
+   */
+  void splitPoints(const Line<int>& line, const VecVector2i& points, int maxDistance,
+                   VecVector2i& inliers, VecVector2i& outliers) const;
   /**
    * @brief findBorderLines
    *
-   * Searches for the possible field lines using the RANSAC algorithm
+   * Fits up to two orthogonal field border lines to the border points
    *
    * @author Florian Bergmann
    */
   void findBorderLines();
-  /**
-   * ransac for lines
-   */
-  bool ransac(Line<int>& bestLine, const VecVector2<int>& points, VecVector2<int>& best,
-              VecVector2<int>& unused, unsigned int iterations, int max_distance);
   /**
    * @brief createFilteredSegments creates a version of the segments that contains only
    * the segments below the field border and that are not part of the field
@@ -128,10 +160,24 @@ private:
   void sendImagesForDebug();
   /// holds all found border points
   VecVector2i borderPoints_;
+  /// the upper convex hull of the border points (from left to right)
+  VecVector2i upperHull_;
+  /// the candidate lines for the field border
+  std::vector<Line<int>> candidateLines_;
+  /// the points that are close to the first border line
+  VecVector2i firstLinePoints_;
+  /// the points that are not close to the first border line
+  VecVector2i remainingPoints_;
+  /// the points that are close to the second border line
+  VecVector2i secondLinePoints_;
+  /// the points that are not close to either border line
+  VecVector2i unusedPoints_;
   /// deviaten threshold for the 90 degree corners of the field borders
   const Parameter<int> angleThreshold_;
   /// the minimum amount of points a line has to contain to be considered as field border
   const Parameter<int> minPointsPerLine_;
+  /// the maximum number of candidate lines that are evaluated (bounds the runtime)
+  const Parameter<unsigned int> maxCandidateLines_;
   const Parameter<bool> drawVerticalFilteredSegments_;
   const Parameter<bool> drawHorizontalFilteredSegments_;
   const Parameter<bool> drawVerticalEdges_;
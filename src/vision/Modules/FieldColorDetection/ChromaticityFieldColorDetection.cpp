@@ -42,6 +42,7 @@ void ChromaticityFieldColorDetection::setIsFieldColorFunction()
     }
     return 0.f;
   };
+  fieldColor_->revision++;
 }
 
 void ChromaticityFieldColorDetection::cycle()
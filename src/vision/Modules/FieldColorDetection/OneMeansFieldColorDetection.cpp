@@ -3,6 +3,9 @@
 
 #include "OneMeansFieldColorDetection.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
 #include <limits>
 
 using OMFCD = OneMeansFieldColorDetection;
@@ -22,6 +25,7 @@ OMFCD::OneMeansFieldColorDetection(const ModuleManagerInterface& manager)
   , initialGuessBottom_(*this, "initialGuessBottom", [] {})
   , thresholdYParam_(*this, "thresholdY", [] {})
   , thresholdUV_(*this, "thresholdUV", [] {})
+  , revisionThreshold_(*this, "revisionThreshold", [] {})
   , sampleRate_(10)
   , imageData_(*this)
   , cameraMatrix_(*this)
@@ -42,6 +46,8 @@ void OMFCD::cycle()
 {
   Chronometer time(debug(), mount_ + ".cycleTime");
   const Image422& image = imageData_->image422;
+  ClassificationRevision& lastRevision = revisions_[static_cast<std::size_t>(imageData_->camera)];
+  fieldColor_->revision = lastRevision.revision;
 
   horizonY_ = cameraMatrix_->getHorizonHeight();
   if (horizonY_ >= image.size.y())
@@ -50,13 +56,15 @@ void OMFCD::cycle()
     sendImageForDebug(image);
     return;
   }
+  // All further steps work on the same samples, so the image is only read once.
+  collectSamples(image, horizonY_);
   Vector2f initialGuess;
   if (imageData_->camera == Camera::TOP)
   {
     if (updateInitialGuessTop_)
     {
       Uni::Value value;
-      value << initialStep(imageData_->image422, 200, horizonY_);
+      value << initialStep(200);
       configuration().set(mount_, "initialGuessTop", value);
       updateInitialGuessTop_ = false;
     }
@@ -67,7 +75,7 @@ void OMFCD::cycle()
     if (updateInitialGuessBottom_)
     {
       Uni::Value value;
-      value << initialStep(imageData_->image422, 200, horizonY_);
+      value << initialStep(200);
       configuration().set(mount_, "initialGuessBottom", value);
       updateInitialGuessBottom_ = false;
     }
@@ -81,7 +89,7 @@ void OMFCD::cycle()
   const int iterCount = 3;
   for (int i = 0; i < iterCount; i++)
   {
-    const FieldColorCluster newColor = updateStep(image, color, thresholdUVSquared, horizonY_);
+    const FieldColorCluster newColor = updateStep(color, thresholdUVSquared);
     if ((initialColor.mean - newColor.mean).squaredNorm() > thresholdUVSquared)
     {
       color = initialColor;
@@ -93,25 +101,62 @@ void OMFCD::cycle()
   thresholdY_ = color.yThresh;
   meanCb_ = static_cast<int>(color.mean.x());
   meanCr_ = static_cast<int>(color.mean.y());
+  // The cluster moves a little in nearly every image. Consumers that cache the classification
+  // (e.g. the ColorClassTable) only have to update it when it moved noticeably. Each camera has its
+  // own cluster, so the revisions are kept per camera.
+  if (lastRevision.thresholdUvSquared != thresholdUvSquared_ ||
+      std::abs(lastRevision.thresholdY - thresholdY_) > revisionThreshold_() ||
+      std::abs(lastRevision.meanCb - meanCb_) > revisionThreshold_() ||
+      std::abs(lastRevision.meanCr - meanCr_) > revisionThreshold_())
+  {
+    lastRevision = {meanCb_, meanCr_, thresholdY_, thresholdUvSquared_, lastRevision.revision + 1};
+    fieldColor_->revision = lastRevision.revision;
+  }
   fieldColor_->valid = true;
 
   sendImageForDebug(image);
 }
 
-Vector2f OMFCD::initialStep(const Image422& image, const int yThresh, const int startY) const
+void OMFCD::collectSamples(const Image422& image, const int startY)
+{
+  samplesY_.clear();
+  samplesCb_.clear();
+  samplesCr_.clear();
+  for (int y = std::max(startY, 0); y < image.size.y(); y += sampleRate_)
+  {
+    for (int x = 0; x < image.size.x(); x += sampleRate_ / 2)
+    {
+      const auto& pixel = image.at(y, x);
+      samplesY_.push_back(pixel.y1_);
+      samplesCb_.push_back(pixel.cb_);
+      samplesCr_.push_back(pixel.cr_);
+    }
+  }
+}
+
+Vector2f OMFCD::initialStep(const int yThresh) const
 {
+  // Consecutive samples often have the same color. Distributing them over several sub-histograms
+  // avoids that consecutive increments have to wait for each other.
+  constexpr std::size_t numberOfSubHistograms = 4;
+  std::array<std::array<int, 256>, numberOfSubHistograms> subHistCb = {{}};
+  std::array<std::array<int, 256>, numberOfSubHistograms> subHistCr = {{}};
+  for (std::size_t i = 0; i < samplesY_.size(); i++)
+  {
+    if (samplesY_[i] < yThresh)
+    {
+      subHistCb[i % numberOfSubHistograms][samplesCb_[i]]++;
+      subHistCr[i % numberOfSubHistograms][samplesCr_[i]]++;
+    }
+  }
   std::array<int, 256> histCb = {{}};
   std::array<int, 256> histCr = {{}};
-  for (int y = startY; y < image.size.y(); y += sampleRate_)
+  for (std::size_t j = 0; j < numberOfSubHistograms; j++)
   {
-    for (int x = 0; x < image.size.x(); x += sampleRate_ / 2)
+    for (std::size_t i = 0; i < histCb.size(); i++)
     {
-      const auto pixel = image.at(y, x);
-      if (pixel.y1_ < yThresh)
-      {
-        histCb[pixel.cb_]++;
-        histCr[pixel.cr_]++;
-      }
+      histCb[i] += subHistCb[j][i];
+      histCr[i] += subHistCr[j][i];
     }
   }
 
@@ -134,35 +179,37 @@ Vector2f OMFCD::initialStep(const Image422& image, const int yThresh, const int
   return initialCluster;
 }
 
-OMFCD::FieldColorCluster OMFCD::updateStep(const Image422& image,
-                                           const FieldColorCluster initCluster, const int maxDist,
-                                           const int startY)
+OMFCD::FieldColorCluster OMFCD::updateStep(const FieldColorCluster initCluster,
+                                           const int maxDist) const
 {
-  Vector2f mean(0, 0);
-  int meanY = 0;
+  // Only the distance is computed in float, all sums are integral. The loop does not branch such
+  // that the compiler can vectorize it.
+  const int yThresh = initCluster.yThresh;
+  const float meanCb = initCluster.mean.x();
+  const float meanCr = initCluster.mean.y();
+  const float maxDistance = static_cast<float>(maxDist);
+  const int* samplesY = samplesY_.data();
+  const int* samplesCb = samplesCb_.data();
+  const int* samplesCr = samplesCr_.data();
+  int sumCb = 0;
+  int sumCr = 0;
+  int sumY = 0;
   int count = 0;
-  for (int y = startY; y < image.size.y(); y += sampleRate_)
+  for (std::size_t i = 0; i < samplesY_.size(); i++)
   {
-    for (int x = 0; x < image.size.x(); x += sampleRate_ / 2)
-    {
-      auto pixel = image.at(y, x);
-      if (pixel.y1_ < initCluster.yThresh)
-      {
-        const Vector2f pixelColor = Vector2f(pixel.cb_, pixel.cr_);
-        const Vector2f colorErr = initCluster.mean - pixelColor;
-        const int dist = static_cast<int>(colorErr.x() * colorErr.x() + colorErr.y() * colorErr.y() * 2);
-        if (dist < maxDist)
-        {
-          mean += pixelColor;
-          meanY += pixel.y1_;
-          count++;
-        }
-      }
-    }
+    const float errorCb = meanCb - static_cast<float>(samplesCb[i]);
+    const float errorCr = meanCr - static_cast<float>(samplesCr[i]);
+    const float dist = errorCb * errorCb + errorCr * errorCr * 2;
+    const int inCluster = (samplesY[i] < yThresh) & (dist < maxDistance);
+    sumCb += inCluster * samplesCb[i];
+    sumCr += inCluster * samplesCr[i];
+    sumY += inCluster * samplesY[i];
+    count += inCluster;
   }
   if (count > 0)
   {
-    return {mean / count, (int)(meanY / count * thresholdYParam_())};
+    return {Vector2f(static_cast<float>(sumCb), static_cast<float>(sumCr)) / count,
+            (int)(sumY / count * thresholdYParam_())};
   }
   return initCluster;
 }
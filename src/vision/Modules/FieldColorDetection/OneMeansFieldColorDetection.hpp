@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "Framework/Module.hpp"
 #include "Tools/Storage/Image.hpp"
 #include "Tools/Storage/UniValue/UniValue.h"
@@ -29,6 +32,15 @@ private:
     Vector2f mean;
     int yThresh;
   };
+  /// the classification of one camera at its last FieldColor revision
+  struct ClassificationRevision
+  {
+    int meanCb = 0;
+    int meanCr = 0;
+    int thresholdY = 0;
+    int thresholdUvSquared = 0;
+    unsigned int revision = 0;
+  };
   /// determines the initial guess using initialStep() and saves it to config
   Parameter<bool> calculateInitialGuess_;
   /// the initial guess
@@ -38,6 +50,8 @@ private:
   const Parameter<float> thresholdYParam_;
   /// the maximal distance from (y)uv origin
   const Parameter<int> thresholdUV_;
+  /// the change of the cluster mean (cb and cr) or of the Y threshold that leads to a new revision
+  const Parameter<int> revisionThreshold_;
   /// the stepsize when sampling the image
   const int sampleRate_;
   /// threshold for the Y channel
@@ -46,6 +60,8 @@ private:
   int thresholdUvSquared_;
   int meanCb_;
   int meanCr_;
+  /// the classification of the top and bottom camera at their last revision
+  std::array<ClassificationRevision, 2> revisions_;
   /// the image that is currently being processed
   const Dependency<ImageData> imageData_;
   /// a reference to the camera matrix
@@ -59,11 +75,18 @@ private:
   /// list of cameras, whether the initial guess has to be recalculated
   bool updateInitialGuessTop_;
   bool updateInitialGuessBottom_;
-  /// Calculates the initial guess of (cb,cr)
-  Vector2f initialStep(const Image422& image, const int yThresh, const int startY) const;
+  /// the y1 channel of the pixels that have been sampled below the horizon
+  std::vector<int> samplesY_;
+  /// the cb channel of the pixels that have been sampled below the horizon
+  std::vector<int> samplesCb_;
+  /// the cr channel of the pixels that have been sampled below the horizon
+  std::vector<int> samplesCr_;
+  /// Samples the image below startY once into the contiguous sample buffers
+  void collectSamples(const Image422& image, const int startY);
+  /// Calculates the initial guess of (cb,cr) from the samples
+  Vector2f initialStep(const int yThresh) const;
   /// Updates the cluster by moving the mean to the mean of the samples within the old cluster
-  FieldColorCluster updateStep(const Image422& image, const FieldColorCluster initCluster,
-                               const int maxDist, const int startY);
+  FieldColorCluster updateStep(const FieldColorCluster initCluster, const int maxDist) const;
   /// Sends debug image and results of (cb,cr)
   void sendImageForDebug(const Image422& image);
 };
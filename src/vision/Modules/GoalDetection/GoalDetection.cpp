@@ -1,16 +1,215 @@
+#include <algorithm>
+#include <cstdlib>
+
 #include "Tools/Chronometer.hpp"
 
 #include "GoalDetection.hpp"
 
 GoalDetection::GoalDetection(const ModuleManagerInterface& manager)
   : Module(manager)
+  , minPostY_(*this, "minPostY", [] {})
+  , maxPostChroma_(*this, "maxPostChroma", [] {})
+  , maxFootDifference_(*this, "maxFootDifference", [] {})
+  , maxCandidates_(*this, "maxCandidates", [] {})
+  , maxWidthRatio_(*this, "maxWidthRatio", [] {})
+  , minHeightRatio_(*this, "minHeightRatio", [] {})
+  , maxDetectionDistance_(*this, "maxDetectionDistance", [] {})
+  , cameraMatrix_(*this)
+  , fieldBorder_(*this)
+  , fieldDimensions_(*this)
+  , imageData_(*this)
+  , imageSegments_(*this)
   , goalData_(*this)
 {
 }
 
 void GoalDetection::cycle()
 {
-  // Chronometer time(debug(), mount_ + ".cycle_time");
-  // blank module
-  goalData_->valid = false;
+  if (!imageSegments_->valid || !fieldBorder_->valid || !cameraMatrix_->valid)
+  {
+    return;
+  }
+  {
+    Chronometer time(debug(), mount_ + "." + imageData_->identification + "_cycle_time");
+    postSegments_.clear();
+    candidates_.clear();
+    findPostSegments();
+    findCandidates();
+    verifyCandidates();
+    goalData_->timestamp = imageData_->timestamp;
+    // The detection ran, so an empty list of posts is a valid result.
+    goalData_->valid = true;
+  }
+  debug().update(mount_ + "." + imageData_->identification + "_candidates", candidates_.size());
+  sendImageForDebug();
+}
+
+bool GoalDetection::isPostColor(const Segment& segment) const
+{
+  const int chroma = std::abs(segment.ycbcr422.cb_ - 128) + std::abs(segment.ycbcr422.cr_ - 128);
+  return segment.field <= 0.f && segment.ycbcr422.averagedY() >= minPostY_() &&
+         chroma <= maxPostChroma_();
+}
+
+void GoalDetection::findPostSegments()
+{
+  for (const auto& scanline : imageSegments_->verticalScanlines)
+  {
+    const auto& segments = scanline.segments;
+    // the first segment of the current white run (segments.size() if there is none)
+    std::size_t runStart = segments.size();
+    bool found = false;
+    PostSegment lowest{scanline.id, scanline.pos, 0, 0};
+    for (std::size_t i = 0; i < segments.size(); i++)
+    {
+      if (isPostColor(segments[i]))
+      {
+        runStart = std::min(runStart, i);
+        continue;
+      }
+      // A run only belongs to a goal post if the post stands on the field below it and if it
+      // reaches above the field border.
+      if (runStart < i && segments[i].field > 0.f &&
+          !fieldBorder_->isInsideField(segments[runStart].start) &&
+          fieldBorder_->isInsideField(segments[i - 1].end))
+      {
+        lowest.top = segments[runStart].start.y();
+        lowest.foot = segments[i - 1].end.y();
+        found = true;
+      }
+      runStart = segments.size();
+    }
+    if (found)
+    {
+      postSegments_.push_back(lowest);
+    }
+  }
+}
+
+void GoalDetection::findCandidates()
+{
+  const PostSegment* previous = nullptr;
+  for (const auto& postSegment : postSegments_)
+  {
+    if (previous != nullptr && postSegment.scanlineId == previous->scanlineId + 1 &&
+        std::abs(postSegment.foot - previous->foot) <= maxFootDifference_())
+    {
+      auto& candidate = candidates_.back();
+      candidate.right = postSegment.x;
+      candidate.top = std::min(candidate.top, postSegment.top);
+      candidate.foot = std::max(candidate.foot, postSegment.foot);
+    }
+    else
+    {
+      candidates_.push_back(
+          {postSegment.x, postSegment.x, postSegment.top, postSegment.foot, false});
+    }
+    previous = &postSegment;
+  }
+}
+
+void GoalDetection::verifyCandidates()
+{
+  // The closest candidates (lowest in the image) are the most reliable ones. Only they are
+  // verified, the others are dropped to bound the runtime.
+  const std::size_t candidatesToVerify =
+      std::min<std::size_t>(candidates_.size(), maxCandidates_());
+  std::partial_sort(candidates_.begin(), candidates_.begin() + candidatesToVerify,
+                    candidates_.end(), [](const PostCandidate& a, const PostCandidate& b) {
+                      return a.foot > b.foot;
+                    });
+  for (std::size_t i = 0; i < candidatesToVerify; i++)
+  {
+    Vector2f position;
+    if (verifyCandidate(candidates_[i], position))
+    {
+      candidates_[i].accepted = true;
+      goalData_->posts.push_back(position);
+    }
+  }
+}
+
+bool GoalDetection::verifyCandidate(const PostCandidate& candidate, Vector2f& position) const
+{
+  const Vector2i footPixel((candidate.left + candidate.right) / 2, candidate.foot);
+  Vector2f foot;
+  if (!cameraMatrix_->pixelToRobot(footPixel, foot))
+  {
+    return false;
+  }
+  const float distance = foot.norm();
+  if (distance > maxDetectionDistance_() || distance == 0.f)
+  {
+    return false;
+  }
+
+  // The expected width is the projection of the post diameter perpendicular to the view ray.
+  const float postRadius = fieldDimensions_->goalPostDiameter / 2.f;
+  const Vector2f perpendicular = Vector2f(-foot.y(), foot.x()) / distance * postRadius;
+  Vector2i leftPixel, rightPixel;
+  if (!cameraMatrix_->robotToPixel(foot + perpendicular, leftPixel) ||
+      !cameraMatrix_->robotToPixel(foot - perpendicular, rightPixel))
+  {
+    return false;
+  }
+  const int expectedWidth = std::abs(leftPixel.x() - rightPixel.x());
+  // A candidate is at least one scanline wide, although the post may be much thinner.
+  const int scanlineSpacing =
+      imageSegments_->imageSize.x() / std::max(imageSegments_->numVerticalScanlines, 1);
+  const int measuredWidth = candidate.right - candidate.left;
+  if (measuredWidth > maxWidthRatio_() * expectedWidth + scanlineSpacing)
+  {
+    return false;
+  }
+
+  // The post may leave the image at the top, so only the visible part is compared.
+  Vector2i topPixel;
+  if (cameraMatrix_->robotWithZToPixel(
+          Vector3f(foot.x(), foot.y(), fieldDimensions_->goalHeight), topPixel))
+  {
+    const int expectedHeight = std::min(candidate.foot - topPixel.y(), candidate.foot);
+    if (candidate.foot - candidate.top < minHeightRatio_() * expectedHeight)
+    {
+      return false;
+    }
+  }
+
+  // The foot is on the front surface of the post.
+  position = foot + foot / distance * postRadius;
+  return true;
+}
+
+void GoalDetection::sendImageForDebug()
+{
+  auto mount = mount_ + "." + imageData_->identification + "_image";
+  if (!debug().isSubscribed(mount))
+  {
+    return;
+  }
+  Image image(imageData_->image422.to444Image());
+  for (const auto& postSegment : postSegments_)
+  {
+    image.line(Image422::get444From422Vector(Vector2i(postSegment.x, postSegment.top)),
+               Image422::get444From422Vector(Vector2i(postSegment.x, postSegment.foot)),
+               Color::YELLOW);
+  }
+  for (const auto& candidate : candidates_)
+  {
+    const Rectangle<int> box(Vector2i(candidate.left, candidate.top),
+                             Vector2i(candidate.right, candidate.foot));
+    image.rectangle(box.from422to444(), candidate.accepted ? Color::BLUE : Color::RED);
+  }
+  for (const auto& post : goalData_->posts)
+  {
+    Vector2i pixel;
+    if (cameraMatrix_->robotToPixel(post, pixel))
+    {
+      image.cross(Image422::get444From422Vector(pixel), 10, Color::PINK);
+    }
+  }
+  for (const auto& bp : fieldBorder_->getBorderPoints())
+  {
+    image[Image422::get444From422Vector(bp)] = Color::RED;
+  }
+  debug().sendImage(mount, image);
 }
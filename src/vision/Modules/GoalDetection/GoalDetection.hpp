@@ -1,17 +1,129 @@
 #pragma once
 
+#include <vector>
+
+#include "Data/CameraMatrix.hpp"
+#include "Data/FieldBorder.hpp"
+#include "Data/FieldDimensions.hpp"
 #include "Data/GoalData.hpp"
+#include "Data/ImageData.hpp"
+#include "Data/ImageSegments.hpp"
 #include "Framework/Module.hpp"
 
 class Brain;
 
+/**
+ * @brief GoalDetection detects goal posts on the vertical scanlines of the image segmentation
+ *
+ * A goal post appears as a white run of segments that starts above the field border and ends on
+ * the field. Such runs of adjacent scanlines are combined to candidates. Only the closest
+ * maxCandidates candidates are verified with the projected size of a goal post, so the runtime is
+ * bounded by one pass over the vertical segments.
+ */
 class GoalDetection : public Module<GoalDetection, Brain>
 {
 public:
+  /// the name of this module
   ModuleName name = "GoalDetection";
+  /**
+   * @brief the constructor of this module
+   * @param manager the module manager interface
+   */
   GoalDetection(const ModuleManagerInterface& manager);
-  void cycle();
+  /**
+   * @brief cycle writes the positions of the detected goal posts to the production
+   */
+  void cycle() override;
 
 private:
+  /// a white run on a vertical scanline that reaches from above the field border into the field
+  struct PostSegment
+  {
+    /// the id of the scanline
+    int scanlineId;
+    /// the x coordinate of the scanline
+    int x;
+    /// the y coordinate of the upper end of the run
+    int top;
+    /// the y coordinate of the lower end of the run (where the post stands on the field)
+    int foot;
+  };
+
+  /// post segments of adjacent scanlines that may belong to the same goal post
+  struct PostCandidate
+  {
+    /// the x coordinates of the left and right most scanline
+    int left, right;
+    /// the smallest y coordinate of all post segments
+    int top;
+    /// the largest y coordinate of all post segments
+    int foot;
+    /// whether the candidate has been accepted as goal post
+    bool accepted;
+  };
+
+  /// the minimum luminance of a goal post segment
+  const Parameter<int> minPostY_;
+  /// the maximum sum of the chroma deviations (cb and cr) of a goal post segment
+  const Parameter<int> maxPostChroma_;
+  /// the maximum difference of the feet of post segments on adjacent scanlines in pixels
+  const Parameter<int> maxFootDifference_;
+  /// the number of candidates (closest first) that are verified per image
+  const Parameter<unsigned int> maxCandidates_;
+  /// the maximum ratio of the measured to the expected width of a goal post
+  const Parameter<float> maxWidthRatio_;
+  /// the minimum ratio of the visible to the expected height of a goal post
+  const Parameter<float> minHeightRatio_;
+  /// the maximum distance of a goal post in m
+  const Parameter<float> maxDetectionDistance_;
+
+  /// the camera matrix of the current image
+  const Dependency<CameraMatrix> cameraMatrix_;
+  /// the field border of the current image
+  const Dependency<FieldBorder> fieldBorder_;
+  /// the field dimensions (for the size of the goal posts)
+  const Dependency<FieldDimensions> fieldDimensions_;
+  /// the currently processed image
+  const Dependency<ImageData> imageData_;
+  /// the result of the image segmentation
+  const Dependency<ImageSegments> imageSegments_;
+
+  /// the positions of the detected goal posts
   Production<GoalData> goalData_;
+
+  /// the post segments of the current image (at most one per scanline)
+  std::vector<PostSegment> postSegments_;
+  /// the candidates of the current image
+  std::vector<PostCandidate> candidates_;
+
+  /**
+   * @brief isPostColor checks whether a segment may be part of a goal post
+   * @param segment the segment
+   * @return true if the segment is white
+   */
+  bool isPostColor(const Segment& segment) const;
+  /**
+   * @brief findPostSegments finds the lowest post segment on every vertical scanline
+   */
+  void findPostSegments();
+  /**
+   * @brief findCandidates combines post segments of adjacent scanlines to candidates
+   */
+  void findCandidates();
+  /**
+   * @brief verifyCandidates checks the closest candidates against the expected size of a goal post
+   * and adds the accepted ones to the production
+   */
+  void verifyCandidates();
+  /**
+   * @brief verifyCandidate checks a candidate against the expected size of a goal post
+   * @param candidate the candidate
+   * @param position the position of the goal post center in robot coordinates
+   * @return true if the candidate is a goal post
+   */
+  bool verifyCandidate(const PostCandidate& candidate, Vector2f& position) const;
+  /**
+   * @brief sendImageForDebug sends an image with the candidates and the detected goal posts
+   */
+  void sendImageForDebug();
 };
@@ -77,6 +77,8 @@ void FakeImageReceiver::cycle()
     // do some calculations here because they are needed in other functions that may be called often
     fakeCameraMatrix_->camera2torsoInv = fakeCameraMatrix_->camera2torso.invert();
     fakeCameraMatrix_->camera2groundInv = fakeCameraMatrix_->camera2ground.invert();
+    // the cached projection needs the scaled fc and cc
+    fakeCameraMatrix_->updateProjection();
     const auto rM = fakeCameraMatrix_->camera2ground.rotM.toRotationMatrix();
     if (rM(2, 2) == 0.f)
     {
@@ -28,6 +28,9 @@ void ImageReceiver::cycle()
   auto& image422 = image_data_->image422;
   CameraInterface& camera = robotInterface().getNextCamera();
   image_data_->wait_time = camera.waitForImage();
+  // Hold the buffer of this image until the next image is received so that the camera does not
+  // reuse it while it is still being processed.
+  image_data_->frame = camera.acquireFrame();
   image_data_->timestamp = camera.readImage(image422);
 
   // This needs to be the first call to debug in the ModuleManager per cycle
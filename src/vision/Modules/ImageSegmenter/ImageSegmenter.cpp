@@ -12,6 +12,9 @@ ImageSegmenter::ImageSegmenter(const ModuleManagerInterface& manager)
   : Module(manager)
   , updateScanlines_(false)
   , scanGridsValid_({{false, false}})
+  , scanGridImageSize_(0, 0)
+  , scanGridFc_({{Vector2f::Zero(), Vector2f::Zero()}})
+  , scanGridCc_({{Vector2f::Zero(), Vector2f::Zero()}})
   , drawFullImage_(*this, "drawFullImage", [] {})
   , edgeThresholdHorizontal_(*this, "edgeThresholdHorizontal", [] {})
   , edgeThresholdVertical_(*this, "edgeThresholdVertical", [] {})
@@ -19,12 +22,41 @@ ImageSegmenter::ImageSegmenter(const ModuleManagerInterface& manager)
   , drawEdges_(*this, "drawEdges", [] {})
   , useMedianVerticalTop_(*this, "useMedianVerticalTop", [] {})
   , useMedianVerticalBottom_(*this, "useMedianVerticalBottom", [] {})
+  , useCameraPose_(*this, "useCameraPose", [this] { clearScanGridCache(); })
+  , scanGridPitchResolution_(*this, "scanGridPitchResolution",
+                             [this] {
+                               scanGridPitchResolution_() *= TO_RAD;
+                               clearScanGridCache();
+                             })
+  , scanGridYawResolution_(*this, "scanGridYawResolution",
+                           [this] {
+                             scanGridYawResolution_() *= TO_RAD;
+                             clearScanGridCache();
+                           })
+  , scanGridRollResolution_(*this, "scanGridRollResolution",
+                            [this] {
+                              scanGridRollResolution_() *= TO_RAD;
+                              clearScanGridCache();
+                            })
+  , scanGridHeightResolution_(*this, "scanGridHeightResolution",
+                              [this] { clearScanGridCache(); })
+  , scanGridCacheSize_(*this, "scanGridCacheSize", [] {})
   , imageData_(*this)
   , cameraMatrix_(*this)
-  , fieldColor_(*this)
+  , colorClassTable_(*this)
   , robotProjection_(*this)
   , imageSegments_(*this)
 {
+  scanGridPitchResolution_() *= TO_RAD;
+  scanGridYawResolution_() *= TO_RAD;
+  scanGridRollResolution_() *= TO_RAD;
+}
+
+void ImageSegmenter::clearScanGridCache()
+{
+  scanGridCache_.clear();
+  scanGridRecency_.clear();
+  scanGridsValid_ = {{false, false}};
 }
 
 void ImageSegmenter::cycle()
@@ -49,59 +81,117 @@ void ImageSegmenter::cycle()
   sendDebug();
 }
 
-void ImageSegmenter::calculateScanGrids()
+void ImageSegmenter::updateScanGrid()
 {
+  const int camera = static_cast<int>(imageData_->camera);
   if (!imageData_->is_provided || !cameraMatrix_->valid)
   {
+    scanGridsValid_[camera] = false;
     return;
   }
-  const int camera = static_cast<int>(imageData_->camera);
-  const KinematicMatrix& camera2ground = cameraMatrix_->cam2groundStand;
-  const KinematicMatrix& camera2ground_inv = camera2ground.invert();
-  Vector2i pixel(imageData_->image422.size.x() / 2, 0);
-  imageSegments_->scanGrids[camera].clear();
-  // Distance of the sample points in meter
-  const float samplePointDistance = 0.02f;
-  for (int y = 0; y < imageData_->image422.size.y(); y++)
+  if (imageData_->image422.size != scanGridImageSize_ ||
+      cameraMatrix_->fc != scanGridFc_[camera] || cameraMatrix_->cc != scanGridCc_[camera])
   {
-    pixel.y() = y;
-    Vector2f robot(Vector2f::Zero());
-    if (!cameraMatrix_->pixelToRobot(pixel, robot, camera2ground))
-    {
-      imageSegments_->scanGrids[camera].emplace_back(1, 2);
-      continue;
-    }
-    Vector2i pixelX = Vector2i::Zero(), pixelY = Vector2i::Zero();
-    if (!cameraMatrix_->robotToPixel({robot.x() - samplePointDistance, robot.y()}, pixelY,
-                                     camera2ground_inv))
+    // all cached grids have been calculated for another image size or other intrinsics
+    clearScanGridCache();
+    scanGridImageSize_ = imageData_->image422.size;
+    scanGridFc_[camera] = cameraMatrix_->fc;
+    scanGridCc_[camera] = cameraMatrix_->cc;
+  }
+  const KinematicMatrix& camera2ground =
+      useCameraPose_() ? cameraMatrix_->camera2ground : cameraMatrix_->cam2groundStand;
+  // The optical axis of the camera in robot coordinates determines pitch and yaw of the camera.
+  const Vector3f opticalAxis = camera2ground.rotM * Vector3f::UnitX();
+  const float pitch =
+      std::atan2(-opticalAxis.z(), std::hypot(opticalAxis.x(), opticalAxis.y()));
+  const float yaw = std::atan2(opticalAxis.y(), opticalAxis.x());
+  // The roll is the rotation around the optical axis, it tilts the horizontal image axis.
+  const float roll = std::atan2((camera2ground.rotM * Vector3f::UnitY()).z(),
+                                (camera2ground.rotM * Vector3f::UnitZ()).z());
+  const float height = camera2ground.posV.z();
+  const ScanGridKey key{camera, static_cast<int>(std::round(pitch / scanGridPitchResolution_())),
+                        static_cast<int>(std::round(yaw / scanGridYawResolution_())),
+                        static_cast<int>(std::round(roll / scanGridRollResolution_())),
+                        static_cast<int>(std::round(height / scanGridHeightResolution_()))};
+  if (scanGridsValid_[camera] && key == scanGridKeys_[camera])
+  {
+    // the grid of the last image of this camera can be reused
+    return;
+  }
+  auto grid = scanGridCache_.find(key);
+  if (grid == scanGridCache_.end())
+  {
+    while (!scanGridRecency_.empty() &&
+           static_cast<int>(scanGridCache_.size()) >= scanGridCacheSize_())
     {
-      imageSegments_->scanGrids[camera].emplace_back(1, 2);
-      continue;
+      // evict the grid that has not been used for the longest time
+      scanGridCache_.erase(scanGridRecency_.back());
+      scanGridRecency_.pop_back();
     }
-    if (!cameraMatrix_->robotToPixel({robot.x(), robot.y() - samplePointDistance}, pixelX,
-                                     camera2ground_inv))
+    scanGridRecency_.push_front(key);
+    grid = scanGridCache_.emplace(key, CachedScanGrid{{}, scanGridRecency_.begin()}).first;
+    calculateScanGrid(camera2ground, grid->second.scanGrid);
+  }
+  else
+  {
+    // mark the grid as most recently used
+    scanGridRecency_.splice(scanGridRecency_.begin(), scanGridRecency_, grid->second.recency);
+  }
+  const std::vector<Vector2i>& scanGrid = grid->second.scanGrid;
+  // assign reuses the capacity of the production
+  imageSegments_->scanGrids[camera].assign(scanGrid.begin(), scanGrid.end());
+  scanGridKeys_[camera] = key;
+  scanGridsValid_[camera] =
+      static_cast<int>(imageSegments_->scanGrids[camera].size()) == imageData_->image422.size.y();
+}
+
+void ImageSegmenter::calculateScanGrid(const KinematicMatrix& camera2ground,
+                                       std::vector<Vector2i>& scanGrid) const
+{
+  const int rows = imageData_->image422.size.y();
+  // Project all rows of the middle column at once.
+  const Matrix34f robot2pixel = cameraMatrix_->getRobot2PixelProjection(camera2ground.invert());
+  const Matrix3f pixel2ground = CameraMatrix::getPixel2GroundHomography(robot2pixel);
+  Matrix2Xf pixels(2, rows);
+  pixels.row(0).setConstant(static_cast<float>(imageData_->image422.size.x() / 2));
+  pixels.row(1).setLinSpaced(rows, 0.f, static_cast<float>(rows - 1));
+  Matrix2Xf robot;
+  ArrayXb robotValid;
+  cameraMatrix_->pixelToRobot(pixels, robot, robotValid, pixel2ground);
+  // Distance of the sample points in meter
+  const float samplePointDistance = 0.02f;
+  Matrix2Xf pixelsX, pixelsY;
+  ArrayXb pixelsXValid, pixelsYValid;
+  cameraMatrix_->robotToPixel(robot.colwise() - Vector2f(0.f, samplePointDistance), pixelsX,
+                              pixelsXValid, robot2pixel);
+  cameraMatrix_->robotToPixel(robot.colwise() - Vector2f(samplePointDistance, 0.f), pixelsY,
+                              pixelsYValid, robot2pixel);
+  scanGrid.clear();
+  scanGrid.reserve(rows);
+  for (int y = 0; y < rows; y++)
+  {
+    if (!robotValid[y] || !pixelsXValid[y] || !pixelsYValid[y])
     {
-      imageSegments_->scanGrids[camera].emplace_back(1, 2);
+      scanGrid.emplace_back(1, 2);
       continue;
     }
-    imageSegments_->scanGrids[camera].emplace_back(std::max(pixelX.x() - pixel.x(), 1),
-                                                   std::max(pixelY.y() - pixel.y(), 2));
+    // add 0.5 for mathematical rounding like the scalar projection does
+    const int pixelXx = static_cast<int>(pixelsX(0, y) + 0.5f);
+    const int pixelYy = static_cast<int>(pixelsY(1, y) + 0.5f);
+    scanGrid.emplace_back(std::max(pixelXx - static_cast<int>(pixels(0, y)), 1),
+                          std::max(pixelYy - y, 2));
   }
-  scanGridsValid_[camera] =
-      static_cast<int>(imageSegments_->scanGrids[camera].size()) == imageData_->image422.size.y();
 }
 
-void ImageSegmenter::addSegment(const Vector2i& peak, Scanline& scanline, EdgeType edgeType,
-                                int scanPoints)
+void ImageSegmenter::addSegment(const Vector2i& peak, std::vector<Segment>& segments,
+                                ScanlineType scanlineType, EdgeType edgeType, int scanPoints)
 {
-  ScanlineType& scanlineType = scanline.scanlineType;
-  Segment& segment = scanline.segments.back();
+  Segment& segment = segments.back();
   assert(peak.x() >= 0 && peak.y() >= 0);
-  assert(scanline.scanlineType == ScanlineType::VERTICAL
-             ? peak.y() < imageData_->image422.size.y()
-             : peak.x() < imageData_->image422.size.x());
-  assert(scanline.scanlineType == ScanlineType::VERTICAL ? peak.y() >= segment.start.y()
-                                                         : peak.x() >= segment.start.x());
+  assert(scanlineType == ScanlineType::VERTICAL ? peak.y() < imageData_->image422.size.y()
+                                                : peak.x() < imageData_->image422.size.x());
+  assert(scanlineType == ScanlineType::VERTICAL ? peak.y() >= segment.start.y()
+                                                : peak.x() >= segment.start.x());
   segment.end = peak;
   segment.endEdgeType = edgeType;
   assert(scanPoints >= 0);
@@ -136,10 +226,10 @@ void ImageSegmenter::addSegment(const Vector2i& peak, Scanline& scanline, EdgeTy
   {
     segment.ycbcr422 = imageData_->image422.at((segment.start + segment.end).unaryExpr(shift));
   }
-  segment.field = fieldColor_->isFieldColor(segment.ycbcr422);
+  segment.field = colorClassTable_->fieldColor(segment.ycbcr422);
   if (edgeType != EdgeType::BORDER && edgeType != EdgeType::END)
   {
-    scanline.segments.emplace_back(peak, edgeType);
+    segments.emplace_back(peak, edgeType);
   }
 }
 
@@ -253,8 +343,8 @@ void ImageSegmenter::createVerticalScanlines()
       {
         if (state.gMin < -edgeThreshold)
         {
-          addSegment(Vector2i(state.scanline->pos, state.yPeak), (*state.scanline),
-                     EdgeType::FALLING, state.scanPoints);
+          addSegment(Vector2i(state.scanline->pos, state.yPeak), state.scanline->segments,
+                     ScanlineType::VERTICAL, EdgeType::FALLING, state.scanPoints);
           state.scanPoints = 0;
         }
         state.gMax = diff;
@@ -265,8 +355,8 @@ void ImageSegmenter::createVerticalScanlines()
       {
         if (state.gMax > edgeThreshold)
         {
-          addSegment(Vector2i(state.scanline->pos, state.yPeak), (*state.scanline),
-                     EdgeType::RISING, state.scanPoints);
+          addSegment(Vector2i(state.scanline->pos, state.yPeak), state.scanline->segments,
+                     ScanlineType::VERTICAL, EdgeType::RISING, state.scanPoints);
           state.scanPoints = 0;
         }
         state.gMin = diff;
@@ -285,7 +375,8 @@ void ImageSegmenter::createVerticalScanlines()
     scanPoints /= 2;
     if (vScanline.yMax > vScanline.segments.front().start.y())
     {
-      addSegment(Vector2i(vScanline.pos, vScanline.yMax), vScanline, EdgeType::BORDER, scanPoints);
+      addSegment(Vector2i(vScanline.pos, vScanline.yMax), vScanline.segments,
+                 ScanlineType::VERTICAL, EdgeType::BORDER, scanPoints);
     }
     else
     {
@@ -312,10 +403,7 @@ void ImageSegmenter::createHorizontalScanlines()
 {
   // reinitialize scanlines if the image changes
   const int camera = static_cast<int>(imageData_->camera);
-  if (imageData_->image422.size != imageSegments_->imageSize || !scanGridsValid_[camera])
-  {
-    calculateScanGrids();
-  }
+  updateScanGrid();
   if (!scanGridsValid_[camera])
   {
     return;
@@ -335,14 +423,14 @@ void ImageSegmenter::createHorizontalScanlines()
   ScanlineStateHorizontal scanlineState;
   const std::vector<Vector2i>& scanGrid = imageSegments_->scanGrids[camera];
   Vector2i step = scanGrid[horizon];
+  // all segments are appended to the arena of the production which keeps its capacity across
+  // cycles, each scanline only remembers where its segments start
+  std::vector<Segment>& segments = imageSegments_->horizontalSegments;
   for (int y = horizon + 1; y < imageData_->image422.size.y(); y += step.y())
   {
     step = scanGrid[y];
     const int lookupX = imageSegments_->scanGrids[camera][y].x();
-    HorizontalScanline scanline;
-    scanline.segments.reserve(imageData_->image422.size.x());
-    scanline.pos = y;
-    scanline.step = step;
+    const std::size_t segmentOffset = segments.size();
     bool wasOnRobot = false;
     int lastValidPoint = 0;
     Vector2i pixel(0, y);
@@ -363,16 +451,17 @@ void ImageSegmenter::createHorizontalScanlines()
           // if the current pixel is the first hit on the robot, end the segment.
           // TODO (pixel - step) would be more correct but requires extra handling at image
           // borders
-          if (!scanline.segments.empty())
+          if (segments.size() > segmentOffset)
           {
-            addSegment(pixel, scanline, EdgeType::END, scanlineState.scanPoints);
+            addSegment(pixel, segments, ScanlineType::HORIZONTAL, EdgeType::END,
+                       scanlineState.scanPoints);
           }
         }
         wasOnRobot = true;
         continue;
       }
       lastValidPoint = x;
-      if (scanline.segments.empty())
+      if (segments.size() == segmentOffset)
       {
         // first pixel that is not on a robot
         Vector2i startPixel = pixel;
@@ -380,8 +469,7 @@ void ImageSegmenter::createHorizontalScanlines()
         {
           startPixel.x() = 0;
         }
-        scanline.segments.emplace_back(startPixel,
-                                       startPixel.x() == 0 ? EdgeType::BORDER : EdgeType::START);
+        segments.emplace_back(startPixel, startPixel.x() == 0 ? EdgeType::BORDER : EdgeType::START);
         scanlineState.reset(edgeThreshold, &imageData_->image422[startPixel]);
         wasOnRobot = false;
         continue;
@@ -389,7 +477,7 @@ void ImageSegmenter::createHorizontalScanlines()
       if (wasOnRobot)
       {
         // The previous sample point was the last one on the robot so start a new segment.
-        scanline.segments.emplace_back(pixel, EdgeType::START);
+        segments.emplace_back(pixel, EdgeType::START);
         scanlineState.reset(edgeThreshold, &imageData_->image422[pixel]);
         wasOnRobot = false;
         continue;
@@ -402,8 +490,8 @@ void ImageSegmenter::createHorizontalScanlines()
       {
         if (scanlineState.gMin < -edgeThreshold)
         {
-          addSegment(Vector2i(scanlineState.xPeak, y), scanline, EdgeType::FALLING,
-                     scanlineState.scanPoints);
+          addSegment(Vector2i(scanlineState.xPeak, y), segments, ScanlineType::HORIZONTAL,
+                     EdgeType::FALLING, scanlineState.scanPoints);
           scanlineState.scanPoints = 0;
         }
         scanlineState.gMax = diff;
@@ -415,8 +503,8 @@ void ImageSegmenter::createHorizontalScanlines()
       {
         if (scanlineState.gMax > edgeThreshold)
         {
-          addSegment(Vector2i(scanlineState.xPeak, y), scanline, EdgeType::RISING,
-                     scanlineState.scanPoints);
+          addSegment(Vector2i(scanlineState.xPeak, y), segments, ScanlineType::HORIZONTAL,
+                     EdgeType::RISING, scanlineState.scanPoints);
           scanlineState.scanPoints = 0;
         }
         scanlineState.gMin = diff;
@@ -426,20 +514,26 @@ void ImageSegmenter::createHorizontalScanlines()
       }
       scanlineState.lastYCbCr422 = ycbcr422;
     }
-    if (!scanline.segments.empty())
+    if (segments.size() > segmentOffset)
     {
       // Add the last segment
       if (wasOnRobot)
       {
-        addSegment(Vector2i(lastValidPoint, y), scanline, EdgeType::BORDER,
-                   scanlineState.scanPoints);
+        addSegment(Vector2i(lastValidPoint, y), segments, ScanlineType::HORIZONTAL,
+                   EdgeType::BORDER, scanlineState.scanPoints);
       }
       else
       {
-        addSegment(Vector2i(imageData_->image422.size.x() - 1, y), scanline, EdgeType::BORDER,
-                   scanlineState.scanPoints);
+        addSegment(Vector2i(imageData_->image422.size.x() - 1, y), segments,
+                   ScanlineType::HORIZONTAL, EdgeType::BORDER, scanlineState.scanPoints);
       }
-      imageSegments_->horizontalScanlines.push_back(scanline);
+      imageSegments_->horizontalScanlines.emplace_back();
+      HorizontalScanline& scanline = imageSegments_->horizontalScanlines.back();
+      scanline.id = static_cast<int>(imageSegments_->horizontalScanlines.size());
+      scanline.pos = y;
+      scanline.step = step;
+      scanline.segmentOffset = segmentOffset;
+      scanline.segmentCount = segments.size() - segmentOffset;
     }
   }
 }
@@ -513,7 +607,7 @@ void ImageSegmenter::sendDebug()
     }
     for (const auto& scanline : imageSegments_->horizontalScanlines)
     {
-      for (const auto& segment : scanline.segments)
+      for (const auto& segment : imageSegments_->getSegments(scanline))
       {
         debugImage.line(Image422::get444From422Vector(segment.start),
                         Image422::get444From422Vector(segment.end),
@@ -3,13 +3,16 @@
 #include "Framework/Module.hpp"
 
 #include "Data/CameraMatrix.hpp"
-#include "Data/FieldColor.hpp"
+#include "Data/ColorClassTable.hpp"
 #include "Data/ImageData.hpp"
 #include "Data/ImageSegments.hpp"
 #include "Data/RobotProjection.hpp"
 #include <Modules/Projection/ProjectionCamera.hpp>
 #include <Tools/Kinematics/ForwardKinematics.h>
+#include <list>
+#include <map>
 #include <set>
+#include <tuple>
 
 
 class Brain;
@@ -88,11 +91,14 @@ private:
   /**
    * @brief addSegment is a handler for edges that manages segment creation
    * @param peak the coordinate at which the edge has been found
-   * @param scanline the scanline on which the edge has been found
+   * @param segments the segments of the scanline on which the edge has been found, the last one
+   * is the segment that is ended by this edge
+   * @param scanlineType whether the edge has been found on a vertical or horizontal scanline
    * @param type whether this is a falling, rising, robot or image border edge
    * @param scanPoints the number of sampled points within this segment
    */
-  void addSegment(const Vector2i& peak, Scanline& scanline, EdgeType type, int scanPoints);
+  void addSegment(const Vector2i& peak, std::vector<Segment>& segments, ScanlineType scanlineType,
+                  EdgeType type, int scanPoints);
 
   /**
    * @brief isOnRobot checks whether a pixel is on himself
@@ -111,8 +117,30 @@ private:
    * of similar color
    */
   void createHorizontalScanlines();
-  /// Calculates the lookup tables {@link scanGrids_}.
-  void calculateScanGrids();
+  /// the key of a cached scan grid: camera, quantized pitch, yaw, roll and height of the camera
+  using ScanGridKey = std::tuple<int, int, int, int, int>;
+  /// a cached scan grid together with its position in the recency list
+  struct CachedScanGrid
+  {
+    std::vector<Vector2i> scanGrid;
+    std::list<ScanGridKey>::iterator recency;
+  };
+  /**
+   * @brief updateScanGrid makes the scan grid of the current camera pose available in the
+   * production, it is only calculated if there is no cached grid for the quantized pose
+   */
+  void updateScanGrid();
+  /**
+   * @brief calculateScanGrid calculates the horizontal scanline distances for every image row
+   * @param camera2ground the camera pose for which to calculate the grid
+   * @param scanGrid the result is stored here
+   */
+  void calculateScanGrid(const KinematicMatrix& camera2ground,
+                         std::vector<Vector2i>& scanGrid) const;
+  /**
+   * @brief clearScanGridCache removes all cached scan grids
+   */
+  void clearScanGridCache();
   /**
    * @brief sendDebug
    * @param image the camera image in which to draw the segments
@@ -127,6 +155,18 @@ private:
   bool updateScanlines_;
   /// @brief whether the scangrid for a camera is valid
   std::array<bool, 2> scanGridsValid_;
+  /// the keys of the scan grids that are currently in the production
+  std::array<ScanGridKey, 2> scanGridKeys_;
+  /// scan grids that have been calculated for quantized camera poses
+  std::map<ScanGridKey, CachedScanGrid> scanGridCache_;
+  /// the keys of the cached scan grids, the most recently used one first
+  std::list<ScanGridKey> scanGridRecency_;
+  /// the image size for which the cached scan grids have been calculated
+  Vector2i scanGridImageSize_;
+  /// the focal lengths of both cameras for which the cached scan grids have been calculated
+  std::array<Vector2f, 2> scanGridFc_;
+  /// the optical centers of both cameras for which the cached scan grids have been calculated
+  std::array<Vector2f, 2> scanGridCc_;
 
   const Parameter<bool> drawFullImage_;
   const Parameter<std::array<int, 2>> edgeThresholdHorizontal_;
@@ -135,10 +175,22 @@ private:
   const Parameter<bool> drawEdges_;
   const Parameter<bool> useMedianVerticalTop_;
   const Parameter<bool> useMedianVerticalBottom_;
+  /// whether the scan grid follows the actual camera pose instead of the stand pose
+  const Parameter<bool> useCameraPose_;
+  /// the pitch resolution of cached scan grids (in deg, converted to rad)
+  Parameter<float> scanGridPitchResolution_;
+  /// the yaw resolution of cached scan grids (in deg, converted to rad)
+  Parameter<float> scanGridYawResolution_;
+  /// the roll resolution of cached scan grids (in deg, converted to rad)
+  Parameter<float> scanGridRollResolution_;
+  /// the camera height resolution of cached scan grids (in m)
+  const Parameter<float> scanGridHeightResolution_;
+  /// the maximum number of cached scan grids, the least recently used one is evicted beyond it
+  const Parameter<int> scanGridCacheSize_;
 
   const Dependency<ImageData> imageData_;
   const Dependency<CameraMatrix> cameraMatrix_;
-  const Dependency<FieldColor> fieldColor_;
+  const Dependency<ColorClassTable> colorClassTable_;
   const Dependency<RobotProjection> robotProjection_;
 
   Production<ImageSegments> imageSegments_;
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 
 #include "LineDetection.hpp"
@@ -16,6 +17,10 @@ LineDetection::LineDetection(const ModuleManagerInterface& manager)
   , checkLineSegmentsProjection_(*this, "checkLineSegmentsProjection", [] {})
   , maxProjectedLineSegmentLength_(*this, "maxProjectedLineSegmentLength", [] {})
   , daylightThreshold_(*this, "daylightThreshold", [] {})
+  , maxNumberOfLines_(*this, "maxNumberOfLines", [] {})
+  , ransacMaxIterations_(*this, "ransacMaxIterations", [] {})
+  , ransacHypothesisBudget_(*this, "ransacHypothesisBudget", [] {})
+  , ransacConfidence_(*this, "ransacConfidence", [] {})
   , imageData_(*this)
   , cameraMatrix_(*this)
   , filteredSegments_(*this)
@@ -201,108 +206,178 @@ bool LineDetection::correctLine(Line<int> detectedLine, VecVector2i& linePoints,
 void LineDetection::ransacHandler()
 {
   lines_.clear();
-  VecVector2i best, unused;
-  for (unsigned int i = 0; i < 5 && linePoints_.size() > 5; i++)
+  reusableHypotheses_.clear();
+  unsigned int hypothesisBudget = ransacHypothesisBudget_();
+  for (unsigned int i = 0;
+       i < maxNumberOfLines_() && linePoints_.size() > 5 && hypothesisBudget > 0; i++)
   {
-    /// decreasing ransac iterations since unused getting smaller
+    updatePointCoordinates();
     Line<int> line;
-    if (ransac(line, linePoints_, best, unused, 20 - 4 * i, maxDistFromLine_()))
+    if (!ransac(line, hypothesisBudget))
     {
-      correctLine(line, best, unused);
-      linePoints_ = unused;
-    }
-    else
-    {
-      --i;
+      // Either fewer than two points are left, no hypothesis had more than minScore inliers or
+      // the hypothesis budget ran out before one did. In all cases no further line can be found.
+      break;
     }
+    extractInliers(line);
+    // points of line parts that are too short are given back to the remaining line points
+    correctLine(line, lineInliers_, linePoints_);
   }
 }
 
-bool LineDetection::ransac(Line<int>& bestLine, const VecVector2<int>& points,
-                           VecVector2<int>& best, VecVector2<int>& unused, unsigned int iterations,
-                           int max_distance)
+bool LineDetection::ransac(Line<int>& bestLine, unsigned int& hypothesisBudget)
 {
-  bool valid = false;
-  Line<int> line;
-  int distance;
-  const int sqr_max_distance = max_distance * max_distance;
-  // Keep a buffer and a back-buffer, if we found the best line,
-  // just swap the buffer and add to the other, until we find a better one.
-  VecVector2<int> current_used_1, current_unused_1;
-  VecVector2<int> current_used_2, current_unused_2;
-
-  VecVector2<int>* current_used = &current_used_1;
-  VecVector2<int>* current_unused = &current_unused_1;
-
-  unsigned int max_score = 0;
-  if (points.size() < 2)
+  const int numberOfPoints = static_cast<int>(linePoints_.size());
+  if (numberOfPoints < 2)
   {
-    best.clear();
-    unused = points;
-    return valid;
+    return false;
   }
+  // A hypothesis with less inliers than this can never become a line.
+  const unsigned int minScore = std::max(minNumberOfPointsOnLine_(), 2u) - 1;
+  const std::size_t maxReusableHypotheses = 4;
+  unsigned int bestScore = 0;
+  unsigned int requiredIterations = ransacMaxIterations_();
+  nextReusableHypotheses_.clear();
 
-  current_used_1.reserve(points.size());
-  current_used_2.reserve(points.size());
-  current_unused_1.reserve(points.size());
-  current_unused_2.reserve(points.size());
-
-  for (unsigned int i = 0; i < iterations; i++)
-  {
-    line.p1 = points[Random::uniformInt(0, points.size() - 1)];
-    line.p2 = points[Random::uniformInt(0, points.size() - 1)];
-
-    if (line.p1 == line.p2)
+  const auto evaluate = [&](const Line<int>& line) {
+    hypothesisBudget--;
+    bool preempted = false;
+    const unsigned int score = countInliers(line, std::max(bestScore, minScore), preempted);
+    if (preempted || score <= minScore)
     {
-      continue;
+      return;
     }
-    current_used->clear();
-    current_unused->clear();
-
-    for (const auto& point : points)
+    if (score > bestScore)
     {
-      distance = Geometry::getSquaredLineDistance(line, point);
-      assert(distance >= 0);
-
-      if (distance <= sqr_max_distance)
+      if (bestScore > minScore && nextReusableHypotheses_.size() < maxReusableHypotheses)
       {
-        current_used->push_back(point);
+        nextReusableHypotheses_.push_back(bestLine);
       }
-      else
-      {
-        current_unused->push_back(point);
-      }
-    }
-
-    if (current_used->size() > max_score)
-    {
-      max_score = current_used->size();
+      bestScore = score;
       bestLine = line;
-      if (current_used == &current_used_1)
+      // Adapt the number of iterations such that a hypothesis with two inliers has been drawn with
+      // the requested confidence (assuming the inlier ratio of the best line).
+      const float inlierRatio = static_cast<float>(score) / static_cast<float>(numberOfPoints);
+      const float outlierProbability = 1.f - inlierRatio * inlierRatio;
+      if (outlierProbability <= 0.f)
       {
-        current_used = &current_used_2;
-        current_unused = &current_unused_2;
+        requiredIterations = 0;
       }
-      else
+      else if (outlierProbability < 1.f)
       {
-        current_used = &current_used_1;
-        current_unused = &current_unused_1;
+        const float iterations =
+            std::ceil(std::log(1.f - ransacConfidence_()) / std::log(outlierProbability));
+        requiredIterations = std::min(static_cast<unsigned int>(std::max(iterations, 0.f)),
+                                      ransacMaxIterations_());
       }
     }
+    else if (nextReusableHypotheses_.size() < maxReusableHypotheses)
+    {
+      nextReusableHypotheses_.push_back(line);
+    }
+  };
+
+  // The good hypotheses of the previous extraction still describe lines in the remaining points and
+  // allow to preempt the new random hypotheses early.
+  for (const auto& line : reusableHypotheses_)
+  {
+    if (hypothesisBudget == 0)
+    {
+      break;
+    }
+    evaluate(line);
+  }
+  for (unsigned int i = 0; i < requiredIterations && hypothesisBudget > 0; i++)
+  {
+    // two distinct indices
+    const int firstIndex = Random::uniformInt(0, numberOfPoints - 1);
+    int secondIndex = Random::uniformInt(0, numberOfPoints - 2);
+    if (secondIndex >= firstIndex)
+    {
+      secondIndex++;
+    }
+    const Line<int> line(linePoints_[firstIndex], linePoints_[secondIndex]);
+    if (line.p1 == line.p2)
+    {
+      // This still consumes the iteration such that ransac terminates on duplicate points.
+      continue;
+    }
+    evaluate(line);
   }
+  std::swap(reusableHypotheses_, nextReusableHypotheses_);
 
-  best = current_used == &current_used_1 ? current_used_2 : current_used_1;
-  unused = current_unused == &current_unused_1 ? current_unused_2 : current_unused_1;
+  return bestScore > 0;
+}
 
-  if (best.empty() || bestLine.p1 == bestLine.p2)
+unsigned int LineDetection::countInliers(const Line<int>& line, const unsigned int scoreToBeat,
+                                         bool& preempted) const
+{
+  // The line is represented in Hesse normal form such that the distance of a point is the
+  // absolute value of a single fused multiply add. This loop is vectorized by the compiler.
+  const Vector2f direction = (line.p2 - line.p1).cast<float>();
+  const Vector2f normal = Vector2f(-direction.y(), direction.x()) / direction.norm();
+  const float offset = normal.dot(line.p1.cast<float>());
+  const float nx = normal.x();
+  const float ny = normal.y();
+  const float maxDistance = static_cast<float>(maxDistFromLine_());
+  const float* x = pointsX_.data();
+  const float* y = pointsY_.data();
+  const std::size_t size = pointsX_.size();
+  const std::size_t blockSize = 64;
+
+  preempted = false;
+  unsigned int inliers = 0;
+  for (std::size_t blockStart = 0; blockStart < size; blockStart += blockSize)
   {
-    best.clear();
-    unused = points;
-    return valid;
+    const std::size_t blockEnd = std::min(blockStart + blockSize, size);
+    unsigned int blockInliers = 0;
+    for (std::size_t i = blockStart; i < blockEnd; i++)
+    {
+      blockInliers += std::abs(nx * x[i] + ny * y[i] - offset) <= maxDistance;
+    }
+    inliers += blockInliers;
+    if (blockEnd < size && inliers + (size - blockEnd) <= scoreToBeat)
+    {
+      preempted = true;
+      break;
+    }
   }
+  return inliers;
+}
 
-  valid = true;
-  return valid;
+void LineDetection::extractInliers(const Line<int>& line)
+{
+  const Vector2f direction = (line.p2 - line.p1).cast<float>();
+  const Vector2f normal = Vector2f(-direction.y(), direction.x()) / direction.norm();
+  const float offset = normal.dot(line.p1.cast<float>());
+  const float maxDistance = static_cast<float>(maxDistFromLine_());
+
+  lineInliers_.clear();
+  // The outliers are compacted in place and stay the line points for the next extraction.
+  std::size_t numberOfOutliers = 0;
+  for (std::size_t i = 0; i < linePoints_.size(); i++)
+  {
+    if (std::abs(normal.x() * pointsX_[i] + normal.y() * pointsY_[i] - offset) <= maxDistance)
+    {
+      lineInliers_.push_back(linePoints_[i]);
+    }
+    else
+    {
+      linePoints_[numberOfOutliers++] = linePoints_[i];
+    }
+  }
+  linePoints_.resize(numberOfOutliers);
+}
+
+void LineDetection::updatePointCoordinates()
+{
+  pointsX_.resize(linePoints_.size());
+  pointsY_.resize(linePoints_.size());
+  for (std::size_t i = 0; i < linePoints_.size(); i++)
+  {
+    pointsX_[i] = static_cast<float>(linePoints_[i].x());
+    pointsY_[i] = static_cast<float>(linePoints_[i].y());
+  }
 }
 
 void LineDetection::createLineData()
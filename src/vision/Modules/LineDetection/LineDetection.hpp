@@ -79,10 +79,37 @@ private:
    */
   void ransacHandler();
   /**
-   * ransac for lines
+   * @brief ransac searches the line with the most inliers among the remaining line points
+   *
+   * The number of hypotheses is adapted to the inlier ratio of the best line so far and is limited
+   * by the remaining hypothesis budget of this cycle. Hypotheses that were good but not the best
+   * in the previous extraction are evaluated first.
+   * @param bestLine the line with the most inliers
+   * @param hypothesisBudget the number of hypotheses that may still be evaluated in this cycle
+   * @return true iff a line has been found
    */
-  bool ransac(Line<int>& bestLine, const VecVector2<int>& points, VecVector2<int>& best,
-              VecVector2<int>& unused, unsigned int iterations, int max_distance);
+  bool ransac(Line<int>& bestLine, unsigned int& hypothesisBudget);
+  /**
+   * @brief countInliers counts the line points that are close to a line
+   *
+   * The points are processed in blocks. The counting is stopped as soon as the line can not get
+   * more than scoreToBeat inliers.
+   * @param line the line (with distinct end points)
+   * @param scoreToBeat the score that a line needs to exceed to be of any interest
+   * @param preempted is set to true iff the counting has been stopped early
+   * @return the number of inliers (only a lower bound if the counting has been preempted)
+   */
+  unsigned int countInliers(const Line<int>& line, unsigned int scoreToBeat,
+                            bool& preempted) const;
+  /**
+   * @brief extractInliers moves the inliers of a line from the line points to lineInliers_
+   * @param line the line (with distinct end points)
+   */
+  void extractInliers(const Line<int>& line);
+  /**
+   * @brief updatePointCoordinates copies the coordinates of the line points into the SoA buffers
+   */
+  void updatePointCoordinates();
   /**
    * @brief createLineData converts the internallty found lines to the exposed LineData class
    */
@@ -107,6 +134,14 @@ private:
   const Parameter<float> maxProjectedLineSegmentLength_;
   /// lower threshold to classify more illuminated areas as field
   const Parameter<double> daylightThreshold_;
+  /// the maximum number of lines that are extracted per image
+  const Parameter<unsigned int> maxNumberOfLines_;
+  /// the maximum number of ransac hypotheses per extracted line
+  const Parameter<unsigned int> ransacMaxIterations_;
+  /// the maximum number of ransac hypotheses for all lines of an image
+  const Parameter<unsigned int> ransacHypothesisBudget_;
+  /// the probability with which ransac should have drawn an outlier free hypothesis before it stops
+  const Parameter<float> ransacConfidence_;
   /// a reference to the image
   const Dependency<ImageData> imageData_;
   /// a reference to the camera matrix
@@ -119,6 +154,16 @@ private:
   VecVector2i debugLinePoints_;
   /// candidate points on lines
   VecVector2i linePoints_;
+  /// the x coordinates of the candidate points (SoA for the inlier counting)
+  std::vector<float> pointsX_;
+  /// the y coordinates of the candidate points (SoA for the inlier counting)
+  std::vector<float> pointsY_;
+  /// the inliers of the most recently extracted line
+  VecVector2i lineInliers_;
+  /// good hypotheses of the previous extraction that are evaluated first in the next extraction
+  std::vector<Line<int>> reusableHypotheses_;
+  /// the good hypotheses of the current extraction
+  std::vector<Line<int>> nextReusableHypotheses_;
   /// detected lines
   std::vector<Line<int>> lines_;
 };
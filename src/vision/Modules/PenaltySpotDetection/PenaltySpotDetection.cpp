@@ -24,7 +24,7 @@ PenaltySpotDetection::PenaltySpotDetection(const ModuleManagerInterface& manager
   , cameraMatrix_(*this)
   , filteredSegments_(*this)
   , ballData_(*this)
-  , fieldColor_(*this)
+  , colorClassTable_(*this)
   , penaltySpotData_(*this)
 {
 }
@@ -218,7 +218,7 @@ void PenaltySpotDetection::detectPenaltySpot()
           minimumRequirementsFulfilled = false;
           break;
         }
-        if (requireFieldColor_() && !fieldColor_->isFieldColor(pointColor))
+        if (requireFieldColor_() && !colorClassTable_->fieldColor(pointColor))
         {
           minimumRequirementsFulfilled = false;
           break;
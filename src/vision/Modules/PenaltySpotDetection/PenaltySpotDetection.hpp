@@ -4,7 +4,7 @@
 
 #include "Data/BallData.hpp"
 #include "Data/CameraMatrix.hpp"
-#include "Data/FieldColor.hpp"
+#include "Data/ColorClassTable.hpp"
 #include "Data/FieldDimensions.hpp"
 #include "Data/FilteredSegments.hpp"
 #include "Data/ImageData.hpp"
@@ -71,7 +71,7 @@ private:
   /// a reference to the ball data
   const Dependency<BallData> ballData_;
   /// a reference to the image segments
-  const Dependency<FieldColor> fieldColor_;
+  const Dependency<ColorClassTable> colorClassTable_;
   // the detected penalty spot for other mpdules
   Production<PenaltySpotData> penaltySpotData_;
   /// all of the detected penalty spots without clustering
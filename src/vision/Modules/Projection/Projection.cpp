@@ -1,4 +1,8 @@
+#include <algorithm>
+#include <cmath>
+
 #include "Framework/Module.hpp"
+#include "Tools/Chronometer.hpp"
 #include "Tools/Kinematics/KinematicMatrix.h"
 
 #ifdef REPLAY
@@ -13,6 +17,11 @@ Projection::Projection(const ModuleManagerInterface& manager)
   , torsoCalibration_(*this, "torsoCalibration", [this] { updateTorsoCalibrationMatrix(); })
   , cam2groundStand_(*this, "cam2groundStand", []{})
   , fov_(*this, "fov", []{})
+  , interpolateHeadMatrix_(*this, "interpolateHeadMatrix", []{})
+  , imageTimestampOffsetRatio_(*this, "imageTimestampOffsetRatio", []{})
+  , frameDurationLowPassAlpha_(*this, "frameDurationLowPassAlpha", []{})
+  , frameDurationMaxRejections_(*this, "frameDurationMaxRejections", []{})
+  , cameraFps_(*this, "cameraFps", [this] { resetFrameDurations(); })
   , imageData_(*this)
   , headMatrixBuffer_(*this)
   , cameraMatrix_(*this)
@@ -20,53 +29,87 @@ Projection::Projection(const ModuleManagerInterface& manager)
   , bottomCamera_(*this, Camera::BOTTOM)
 {
   updateTorsoCalibrationMatrix();
+  resetFrameDurations();
 }
 
 void Projection::cycle()
 {
   ProjectionCamera& camera = (imageData_->camera == Camera::TOP) ? topCamera_ : bottomCamera_;
   // TODO: continue only if the robot is approximately upright
-  if (headMatrixBuffer_->buffer.empty())
+  if (headMatrixBuffer_->empty())
   {
     return;
   }
+  Chronometer time(debug(), mount_ + "." + imageData_->identification + "_cycle_time");
 #ifndef REPLAY
   const TimePoint timestamp = imageData_->timestamp;
 #else
   const TimePoint timestamp = reinterpret_cast<ReplayInterface&>(robotInterface()).getRealFrameTime();
 #endif
-  // Get the camera matrix for 17 milliseconds after image recording (17 is approximately 1000/30/2)
-  const HeadMatrixWithTimestamp& bufferEntry = headMatrixBuffer_->getBestMatch(timestamp
+  camera.updateFrameDuration(timestamp, frameDurationLowPassAlpha_(),
+                             frameDurationMaxRejections_());
+  // The image timestamp belongs to the first pixel. The camera matrix is calculated for a time point
+  // during the readout of the image, given as part of the measured time between two images.
+  const TimePoint matrixTimestamp = timestamp
   // Except when in SimRobot because camera images are captured at one exact time point there.
 #ifndef SIMROBOT
-  + std::chrono::milliseconds(17)
+  + static_cast<int>(std::round(imageTimestampOffsetRatio_() * camera.frameDuration * 1000.f))
 #endif
-  );
-  // This is a calibrated head to ground matrix (the camera to head part is applied a few lines below).
-  cameraMatrix_->camera2torso = torsoCalibrationMatrix_ * bufferEntry.head2torso;
-  cameraMatrix_->camera2ground = bufferEntry.torso2ground * cameraMatrix_->camera2torso;
+  ;
+  const HeadMatrixWithTimestamp bufferEntry = interpolateHeadMatrix_()
+                                                  ? headMatrixBuffer_->getInterpolatedMatch(matrixTimestamp)
+                                                  : headMatrixBuffer_->getBestMatch(matrixTimestamp);
+  // The intrinsics only change with the calibration or the image size.
+  camera.updateIntrinsics(imageData_->image422.size);
+  cameraMatrix_->fc = camera.scaledFc;
+  cameraMatrix_->cc = camera.scaledCc;
+  cameraMatrix_->fov = fov_();
   cameraMatrix_->cam2groundStand = cam2groundStand_()[static_cast<int>(imageData_->camera)];
+  cameraMatrix_->timestamp = matrixTimestamp;
+  cameraMatrix_->frameDuration = camera.frameDuration;
+  updateExtrinsics(bufferEntry, camera);
+  cameraMatrix_->valid = true;
+  debug().update(mount_ + "." + imageData_->identification + "_imageTimestampOffset",
+                 matrixTimestamp - timestamp);
+}
+
+void Projection::updateExtrinsics(const HeadMatrixWithTimestamp& headMatrix,
+                                  ProjectionCamera& camera)
+{
+  Matrix3f camera2headRotation;
+  Vector3f camera2headTranslation;
   {
     std::lock_guard<std::mutex> lg(camera.camera2head_lock);
-    // This matrix transforms a vector in the camera coordinate system to a vector in the robot coordinate system.
-    cameraMatrix_->camera2ground *= camera.camera2head;
-    cameraMatrix_->camera2torso *= camera.camera2head;
+    camera2headRotation = camera.camera2headRotation;
+    camera2headTranslation = camera.camera2headTranslation;
   }
-  // divide position by 1000 because we want it in meters but the head matrix buffer stores them in millimeters.
-  cameraMatrix_->camera2torso.posV /= 1000.f;
-  cameraMatrix_->camera2ground.posV /= 1000.f;
-  // do some calculations here because they are needed in other functions that may be called often
-  cameraMatrix_->camera2torsoInv = cameraMatrix_->camera2torso.invert();
-  cameraMatrix_->camera2groundInv = cameraMatrix_->camera2ground.invert();
-  // fc and cc have to be scaled for the image resolution
-  cameraMatrix_->fc = camera.fc();
-  cameraMatrix_->fc.x() *= imageData_->image422.size.x();
-  cameraMatrix_->fc.y() *= imageData_->image422.size.y();
-  cameraMatrix_->cc = camera.cc();
-  cameraMatrix_->cc.x() *= imageData_->image422.size.x();
-  cameraMatrix_->cc.y() *= imageData_->image422.size.y();
-  cameraMatrix_->fov = fov_();
-  const auto rM = cameraMatrix_->camera2ground.rotM.toRotationMatrix();
+  // The head matrix buffer stores positions in millimeters but the camera matrix is in meters.
+  const Matrix3f head2torsoRotation = headMatrix.head2torso.rotM.toRotationMatrix();
+  const Matrix3f torso2groundRotation = headMatrix.torso2ground.rotM.toRotationMatrix();
+  // camera2torso = torsoCalibration * head2torso * camera2head
+  const Matrix3f camera2torsoRotation =
+      torsoCalibrationRotation_ * head2torsoRotation * camera2headRotation;
+  const Vector3f camera2torsoTranslation =
+      torsoCalibrationRotation_ *
+      (head2torsoRotation * camera2headTranslation + headMatrix.head2torso.posV / 1000.f);
+  // camera2ground = torso2ground * camera2torso
+  const Matrix3f camera2groundRotation = torso2groundRotation * camera2torsoRotation;
+  const Vector3f camera2groundTranslation =
+      torso2groundRotation * camera2torsoTranslation + headMatrix.torso2ground.posV / 1000.f;
+  // The inverse of a rigid transformation consists of the transposed rotation and the negated,
+  // rotated translation. Inverting the angle axis rotations is cheap.
+  const Matrix3f ground2cameraRotation = camera2groundRotation.transpose();
+  const Vector3f ground2cameraTranslation = -(ground2cameraRotation * camera2groundTranslation);
+  cameraMatrix_->camera2torso =
+      KinematicMatrix(AngleAxisf(camera2torsoRotation), camera2torsoTranslation);
+  cameraMatrix_->camera2torsoInv =
+      KinematicMatrix(cameraMatrix_->camera2torso.rotM.inverse(),
+                      -(camera2torsoRotation.transpose() * camera2torsoTranslation));
+  cameraMatrix_->camera2ground =
+      KinematicMatrix(AngleAxisf(camera2groundRotation), camera2groundTranslation);
+  cameraMatrix_->camera2groundInv =
+      KinematicMatrix(cameraMatrix_->camera2ground.rotM.inverse(), ground2cameraTranslation);
+  const Matrix3f& rM = camera2groundRotation;
   if (rM(2, 2) == 0.f)
   {
     // Assume that the horizon is above the image.
@@ -80,10 +123,19 @@ void Projection::cycle()
     cameraMatrix_->horizonB =
         cameraMatrix_->cc.y() + cameraMatrix_->fc.y() * (rM(2, 0) + cameraMatrix_->cc.x() * rM(2, 1) / cameraMatrix_->fc.x()) / rM(2, 2);
   }
-  cameraMatrix_->valid = true;
+  cameraMatrix_->updateProjection(ground2cameraRotation, ground2cameraTranslation);
+}
+
+void Projection::resetFrameDurations()
+{
+  const float nominalFrameDuration = 1.f / std::max(cameraFps_(), 1.f);
+  topCamera_.resetFrameDuration(nominalFrameDuration);
+  bottomCamera_.resetFrameDuration(nominalFrameDuration);
 }
 
 void Projection::updateTorsoCalibrationMatrix()
 {
-  torsoCalibrationMatrix_ = KinematicMatrix::rotY(torsoCalibration_().y()) * KinematicMatrix::rotX(torsoCalibration_().x());
+  torsoCalibrationRotation_ = (AngleAxisf(torsoCalibration_().y(), Vector3f::UnitY()) *
+                               AngleAxisf(torsoCalibration_().x(), Vector3f::UnitX()))
+                                  .toRotationMatrix();
 }
@@ -33,12 +33,39 @@ private:
    * @brief updateTorsoCalibrationMatrix recalculates the torso calibration matrix
    */
   void updateTorsoCalibrationMatrix();
+  /**
+   * @brief updateExtrinsics recalculates everything of the camera matrix that depends on the head
+   * matrix (fc and cc have to be set before)
+   *
+   * All constant transformations are cached, so this only consists of a few 3x3 matrix products
+   * and does not allocate memory. It is cheap enough to be evaluated for several head matrices per
+   * image (e.g. for groups of rows of a rolling shutter camera).
+   *
+   * @param headMatrix the head matrix for the time point of the camera matrix
+   * @param camera the camera of the current image
+   */
+  void updateExtrinsics(const HeadMatrixWithTimestamp& headMatrix, ProjectionCamera& camera);
+  /**
+   * @brief resetFrameDurations restarts the frame duration measurement of both cameras at the
+   * nominal frame duration
+   */
+  void resetFrameDurations();
   /// contains an angle around the x axis and an angle around the y axis for calibration of the torso matrix
   const Parameter<Vector2f> torsoCalibration_;
   /// fix cam2ground for both cameras for stand pose
   const Parameter<std::array<KinematicMatrix, 2>> cam2groundStand_;
   /// the field of view of the nao: x: horizontal, y: vertical
   const Parameter<Vector2f> fov_;
+  /// whether the head matrices should be interpolated between buffer entries instead of taking the closest one
+  const Parameter<bool> interpolateHeadMatrix_;
+  /// the time of the camera matrix after the image timestamp relative to the measured frame duration
+  const Parameter<float> imageTimestampOffsetRatio_;
+  /// the weight of the previous estimate when filtering the measured frame duration
+  const Parameter<float> frameDurationLowPassAlpha_;
+  /// the number of consecutive rejected frame intervals after which the measurement starts again
+  const Parameter<unsigned int> frameDurationMaxRejections_;
+  /// the frame rate with which the cameras are configured (the initial frame duration estimate)
+  const Parameter<float> cameraFps_;
   /// the current camera image
   const Dependency<ImageData> imageData_;
   /// the buffer of the last few head matrices
@@ -49,6 +76,6 @@ private:
   ProjectionCamera topCamera_;
   /// the parameters and states of the bottom camera
   ProjectionCamera bottomCamera_;
-  /// a matrix that represents the transformations of the torso calibration
-  KinematicMatrix torsoCalibrationMatrix_;
+  /// the rotation of the torso calibration
+  Matrix3f torsoCalibrationRotation_;
 };
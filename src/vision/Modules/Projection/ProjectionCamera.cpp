@@ -2,8 +2,15 @@
 
 ProjectionCamera::ProjectionCamera(const ModuleBase& module, const Camera camera)
   : ext(module, (camera == Camera::TOP) ? "top_ext" : "bottom_ext", [this] { updateCamera2Head(); })
-  , fc(module, (camera == Camera::TOP) ? "top_fc" : "bottom_fc")
-  , cc(module, (camera == Camera::TOP) ? "top_cc" : "bottom_cc")
+  , fc(module, (camera == Camera::TOP) ? "top_fc" : "bottom_fc",
+       [this] { intrinsicsImageSize = Vector2i::Zero(); })
+  , cc(module, (camera == Camera::TOP) ? "top_cc" : "bottom_cc",
+       [this] { intrinsicsImageSize = Vector2i::Zero(); })
+  , scaledFc(Vector2f::Zero())
+  , scaledCc(Vector2f::Zero())
+  , intrinsicsImageSize(Vector2i::Zero())
+  , frameDuration(0.f)
+  , rejectedIntervals(0)
 {
   // These values are from http://doc.aldebaran.com/2-1/family/robots/video_robot.html
   // They specify the translation and rotation of the cameras to the HEAD_PITCH joint.
@@ -25,4 +32,50 @@ void ProjectionCamera::updateCamera2Head()
   // The order of these multiplications is important.
   std::lock_guard<std::mutex> lg(camera2head_lock);
   camera2head = camera2head_uncalib * KinematicMatrix::rotX(ext().x()) * KinematicMatrix::rotY(ext().y()) * KinematicMatrix::rotZ(ext().z());
+  // The projection works with rotation matrices and meters, so this is only converted when the
+  // calibration changes.
+  camera2headRotation = camera2head.rotM.toRotationMatrix();
+  camera2headTranslation = camera2head.posV / 1000.f;
+}
+
+void ProjectionCamera::updateIntrinsics(const Vector2i& imageSize)
+{
+  if (intrinsicsImageSize == imageSize)
+  {
+    return;
+  }
+  // fc and cc are given relative to the image size
+  scaledFc = fc().cwiseProduct(imageSize.cast<float>());
+  scaledCc = cc().cwiseProduct(imageSize.cast<float>());
+  intrinsicsImageSize = imageSize;
+}
+
+void ProjectionCamera::resetFrameDuration(const float nominalFrameDuration)
+{
+  frameDuration = nominalFrameDuration;
+  rejectedIntervals = 0;
+}
+
+void ProjectionCamera::updateFrameDuration(const TimePoint timestamp, const float lowPassAlpha,
+                                           const unsigned int maxRejectedIntervals)
+{
+  if (lastImageTimestamp.getSystemTime() != 0 && timestamp > lastImageTimestamp)
+  {
+    const float interval = getTimeDiff(timestamp, lastImageTimestamp, TDT::SECS);
+    // Longer intervals are caused by dropped images (or a paused camera) and must not be taken
+    // into account.
+    if (interval < 1.5f * frameDuration)
+    {
+      frameDuration = lowPassAlpha * frameDuration + (1.f - lowPassAlpha) * interval;
+      rejectedIntervals = 0;
+    }
+    else if (++rejectedIntervals > maxRejectedIntervals)
+    {
+      // Images are not dropped that often. Either the frame rate has changed or the estimate is
+      // wrong, so the measurement starts again.
+      frameDuration = interval;
+      rejectedIntervals = 0;
+    }
+  }
+  lastImageTimestamp = timestamp;
 }
@@ -6,6 +6,7 @@
 #include "Hardware/CameraInterface.hpp"
 #include "Tools/Kinematics/KinematicMatrix.h"
 #include "Tools/Math/Eigen.hpp"
+#include "Tools/Time.hpp"
 
 class ProjectionCamera
 {
@@ -20,6 +21,26 @@ public:
    * @brief updateCamera2Head recalculates the calibrated camera2head matrix
    */
   void updateCamera2Head();
+  /**
+   * @brief updateIntrinsics scales fc and cc to the image size if they have not been scaled for it
+   * @param imageSize the (422) size of the current image
+   */
+  void updateIntrinsics(const Vector2i& imageSize);
+  /**
+   * @brief resetFrameDuration restarts the measurement of the time between two images
+   * @param nominalFrameDuration the time between two images according to the configured frame
+   * rate in s
+   */
+  void resetFrameDuration(const float nominalFrameDuration);
+  /**
+   * @brief updateFrameDuration measures the time between two images of this camera
+   * @param timestamp the timestamp of the current image of this camera
+   * @param lowPassAlpha the weight of the previous estimate
+   * @param maxRejectedIntervals the number of consecutive rejected (long) intervals after which the
+   * estimate is restarted from the current interval
+   */
+  void updateFrameDuration(const TimePoint timestamp, const float lowPassAlpha,
+                           const unsigned int maxRejectedIntervals);
   /// angles around x, y, z axes respectively for extrinsic camera calibration
   const Parameter<Vector3f> ext;
   /// the focal length with compensation for pixel size
@@ -30,6 +51,22 @@ public:
   KinematicMatrix camera2head_uncalib;
   /// a transformation matrix that describes the camera to head pitch - updated on calibration change
   KinematicMatrix camera2head;
-  /// mutex for camera2head
+  /// the rotation of camera2head as matrix - updated together with camera2head
+  Matrix3f camera2headRotation;
+  /// the translation of camera2head in m - updated together with camera2head
+  Vector3f camera2headTranslation;
+  /// mutex for camera2head, camera2headRotation and camera2headTranslation
   std::mutex camera2head_lock;
+  /// fc scaled to the image size
+  Vector2f scaledFc;
+  /// cc scaled to the image size
+  Vector2f scaledCc;
+  /// the image size for which scaledFc and scaledCc have been calculated (zero if outdated)
+  Vector2i intrinsicsImageSize;
+  /// the timestamp of the last image of this camera
+  TimePoint lastImageTimestamp;
+  /// the filtered time between two images of this camera in s (starts at the nominal duration)
+  float frameDuration;
+  /// the number of consecutive intervals that have been rejected as too long
+  unsigned int rejectedIntervals;
 };
@@ -54,8 +54,11 @@ void ReplayDataProvider::restoreHeadMatrixBuffer()
   }
   else
   {
-    headMatrixBuffer_->buffer.clear();
-    headMatrixBuffer_->buffer.assign(buffer_.begin(), buffer_.end());
+    headMatrixBuffer_->clear();
+    for (const auto& entry : buffer_)
+    {
+      headMatrixBuffer_->push(entry);
+    }
     headMatrixBuffer_->valid = true;
   }
 }
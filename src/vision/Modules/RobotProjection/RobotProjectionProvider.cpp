@@ -1,18 +1,24 @@
+#include <limits>
+
 #include "RobotProjectionProvider.hpp"
 
+#include "Tools/Chronometer.hpp"
 #include "Tools/Kinematics/ForwardKinematics.h"
 
 
 RobotProjectionProvider::RobotProjectionProvider(const ModuleManagerInterface& manager)
   : Module(manager)
-  , torsoBoundaries_(*this, "torso")
-  , shoulderBoundaries_(*this, "shoulder")
-  , upperArmBoundaries_(*this, "upperArm")
-  , lowerArm1Boundaries_(*this, "lowerArm1")
-  , lowerArm2Boundaries_(*this, "lowerArm2")
-  , upperLeg1Boundaries_(*this, "upperLeg1")
-  , upperLeg2Boundaries_(*this, "upperLeg2")
-  , footBoundaries_(*this, "foot")
+  , torsoBoundaries_(*this, "torso", [this] { invalidateCache(); })
+  , shoulderBoundaries_(*this, "shoulder", [this] { invalidateCache(); })
+  , upperArmBoundaries_(*this, "upperArm", [this] { invalidateCache(); })
+  , lowerArm1Boundaries_(*this, "lowerArm1", [this] { invalidateCache(); })
+  , lowerArm2Boundaries_(*this, "lowerArm2", [this] { invalidateCache(); })
+  , upperLeg1Boundaries_(*this, "upperLeg1", [this] { invalidateCache(); })
+  , upperLeg2Boundaries_(*this, "upperLeg2", [this] { invalidateCache(); })
+  , footBoundaries_(*this, "foot", [this] { invalidateCache(); })
+  , jointAngleTolerance_(*this, "jointAngleTolerance", [] {})
+  , cameraRotationTolerance_(*this, "cameraRotationTolerance", [] {})
+  , cameraTranslationTolerance_(*this, "cameraTranslationTolerance", [] {})
   , imageData_(*this)
   , cameraMatrix_(*this)
   , jointSensorData_(*this)
@@ -21,6 +27,74 @@ RobotProjectionProvider::RobotProjectionProvider(const ModuleManagerInterface& m
 }
 
 void RobotProjectionProvider::cycle()
+{
+  {
+    Chronometer time(debug(), mount_ + ".cycleTime");
+    CachedProjection& cache = cachedProjections_[static_cast<std::size_t>(imageData_->camera)];
+    if (isCacheUsable(cache))
+    {
+      robotProjection_->lines = cache.lines;
+      robotProjection_->firstRowOnRobot = cache.firstRowOnRobot;
+    }
+    else
+    {
+      project();
+      computeFirstRowsOnRobot();
+      cache.valid = true;
+      cache.jointAngles = jointSensorData_->angles;
+      cache.camera2torso = cameraMatrix_->camera2torso;
+      cache.fc = cameraMatrix_->fc;
+      cache.cc = cameraMatrix_->cc;
+      cache.imageSize = imageData_->image422.size;
+      cache.lines = robotProjection_->lines;
+      cache.firstRowOnRobot = robotProjection_->firstRowOnRobot;
+    }
+  }
+
+  if (debug().isSubscribed(mount_ + "." + imageData_->identification))
+  {
+    Image draw = imageData_->image422.to444Image();
+    for (auto& line : robotProjection_->lines)
+    {
+      Line<int> line444;
+      line444.p1 = Image422::get444From422Vector(line.p1);
+      line444.p2 = Image422::get444From422Vector(line.p2);
+      draw.line(line444, Color::RED);
+    }
+    debug().sendImage(mount_ + "." + imageData_->identification, draw);
+  }
+}
+
+void RobotProjectionProvider::invalidateCache()
+{
+  for (auto& cache : cachedProjections_)
+  {
+    cache.valid = false;
+  }
+}
+
+bool RobotProjectionProvider::isCacheUsable(const CachedProjection& cache) const
+{
+  if (!cache.valid || cache.imageSize != imageData_->image422.size ||
+      cache.fc != cameraMatrix_->fc || cache.cc != cameraMatrix_->cc)
+  {
+    return false;
+  }
+  for (std::size_t i = 0; i < cache.jointAngles.size(); i++)
+  {
+    if (std::abs(cache.jointAngles[i] - jointSensorData_->angles[i]) > jointAngleTolerance_())
+    {
+      return false;
+    }
+  }
+  const KinematicMatrix& camera2torso = cameraMatrix_->camera2torso;
+  const AngleAxisf cameraRotation(cache.camera2torso.rotM.toRotationMatrix().transpose() *
+                                  camera2torso.rotM.toRotationMatrix());
+  return std::abs(cameraRotation.angle()) <= cameraRotationTolerance_() &&
+         (cache.camera2torso.posV - camera2torso.posV).norm() <= cameraTranslationTolerance_();
+}
+
+void RobotProjectionProvider::project()
 {
   auto anglesLLeg = jointSensorData_->getLLegAngles();
   auto anglesRLeg = jointSensorData_->getRLegAngles();
@@ -50,19 +124,38 @@ void RobotProjectionProvider::cycle()
   addRobotBoundaries(rightHipPitch2Torso, upperLeg1Boundaries_(), -1);
   addRobotBoundaries(leftHipPitch2Torso, upperLeg2Boundaries_(), 1);
   addRobotBoundaries(rightHipPitch2Torso, upperLeg2Boundaries_(), -1);
+}
 
-
-  if (debug().isSubscribed(mount_ + "." + imageData_->identification))
+void RobotProjectionProvider::computeFirstRowsOnRobot()
+{
+  const int width = imageData_->image422.size.x();
+  std::vector<int>& firstRows = robotProjection_->firstRowOnRobot;
+  firstRows.assign(width, std::numeric_limits<int>::max());
+  for (const auto& line : robotProjection_->lines)
   {
-    Image draw = imageData_->image422.to444Image();
-    for (auto& line : robotProjection_->lines)
+    const int minX = std::max(std::min(line.p1.x(), line.p2.x()), 0);
+    const int maxX = std::min(std::max(line.p1.x(), line.p2.x()), width - 1);
+    const int minY = std::min(line.p1.y(), line.p2.y());
+    const int maxY = std::max(line.p1.y(), line.p2.y());
+    for (int x = minX; x <= maxX; x++)
     {
-      Line<int> line444;
-      line444.p1 = Image422::get444From422Vector(line.p1);
-      line444.p2 = Image422::get444From422Vector(line.p2);
-      draw.line(line444, Color::RED);
+      // The pixels below maxY are always below the line, the ones above minY never.
+      int low = minY;
+      int high = maxY + 1;
+      while (low < high)
+      {
+        const int y = low + (high - low) / 2;
+        if (RobotProjection::isBelowLine(line, Vector2i(x, y)))
+        {
+          high = y;
+        }
+        else
+        {
+          low = y + 1;
+        }
+      }
+      firstRows[x] = std::min(firstRows[x], low);
     }
-    debug().sendImage(mount_ + "." + imageData_->identification, draw);
   }
 }
 
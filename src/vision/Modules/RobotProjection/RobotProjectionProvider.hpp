@@ -9,6 +9,7 @@
 #include "Tools/Math/Eigen.hpp"
 #include "Tools/Math/Line.hpp"
 
+#include <array>
 #include <vector>
 
 class Brain;
@@ -32,6 +33,10 @@ public:
   void cycle();
 
 private:
+  /**
+   * @brief project projects the outline of all robot parts into the image
+   */
+  void project();
   /**
    * @brief addRobotBoundaries projects points into the image
    * @param kinMatrix Kinematic matrix for the points of the robot part
@@ -39,7 +44,47 @@ private:
    * @param sign 1 if left, -1 if right
    */
   void addRobotBoundaries(const KinematicMatrix& kinMatrix, const VecVector3f& robotPart, int sign);
+  /**
+   * @brief computeFirstRowsOnRobot computes the first row on the robot of every image column
+   *
+   * The pixels of a column that are below a line of the outline form a (possibly empty) range that
+   * reaches to the bottom of the image. Its first row is found by a binary search with the same
+   * test as in RobotProjection::isOnRobot.
+   */
+  void computeFirstRowsOnRobot();
+
+  /// the inputs and results of the last projection for one camera
+  struct CachedProjection
+  {
+    /// whether this cache has been filled
+    bool valid = false;
+    /// the joint angles of the projection
+    std::array<float, keys::joints::JOINTS_MAX> jointAngles;
+    /// the camera pose of the projection
+    KinematicMatrix camera2torso;
+    /// the focal lengths of the projection
+    Vector2f fc;
+    /// the optical center of the projection
+    Vector2f cc;
+    /// the image size of the projection
+    Vector2i imageSize;
+    /// the projected lines
+    std::vector<Line<int>> lines;
+    /// the first row on the robot of every column
+    std::vector<int> firstRowOnRobot;
+  };
+  /**
+   * @brief isCacheUsable checks whether the current inputs are within the tolerances of a cache
+   * @param cache the cached projection of the current camera
+   * @return true if the cached projection can be used
+   */
+  bool isCacheUsable(const CachedProjection& cache) const;
+  /**
+   * @brief invalidateCache forces a new projection for both cameras
+   */
+  void invalidateCache();
 
+  /// the outlines of the robot parts (a change invalidates the cached projections)
   const Parameter<VecVector3f> torsoBoundaries_;
   const Parameter<VecVector3f> shoulderBoundaries_;
   const Parameter<VecVector3f> upperArmBoundaries_;
@@ -48,6 +93,12 @@ private:
   const Parameter<VecVector3f> upperLeg1Boundaries_;
   const Parameter<VecVector3f> upperLeg2Boundaries_;
   const Parameter<VecVector3f> footBoundaries_;
+  /// the maximum change of a joint angle [rad] for which the last projection is reused
+  const Parameter<float> jointAngleTolerance_;
+  /// the maximum rotation of the camera [rad] for which the last projection is reused
+  const Parameter<float> cameraRotationTolerance_;
+  /// the maximum translation of the camera [m] for which the last projection is reused
+  const Parameter<float> cameraTranslationTolerance_;
 
   /// the current image
   const Dependency<ImageData> imageData_;
@@ -56,5 +107,8 @@ private:
   /// the current joint sensor data
   const Dependency<JointSensorData> jointSensorData_;
 
+  /// the last projection for the top and bottom camera
+  std::array<CachedProjection, 2> cachedProjections_;
+
   Production<RobotProjection> robotProjection_;
 };
@@ -8,6 +8,7 @@
 SaturationImageProvider::SaturationImageProvider(const ModuleManagerInterface& manager)
   : Module(manager)
   , imageData_(*this)
+  , colorClassTable_(*this)
   , counter_(0)
 
 {
@@ -37,8 +38,7 @@ void SaturationImageProvider::sendImageForDebug(const Image422& image)
     {
       for (int x = 0; x < saturationImage.size_.x(); x++)
       {
-        const RGBColor RGBvalues = image.at(y, x / 2).RGB();
-        if (RGBvalues.isSaturated())
+        if (colorClassTable_->isSaturated(image.at(y, x / 2)))
         {
           saturationImage.at(Vector2i(x, y)) = Color::PINK;
         }
@@ -5,7 +5,7 @@
 #include "Tools/Storage/UniValue/UniValue.h"
 
 #include "Data/CameraMatrix.hpp"
-#include "Data/FieldColor.hpp"
+#include "Data/ColorClassTable.hpp"
 #include "Data/ImageData.hpp"
 
 class Brain;
@@ -24,6 +24,8 @@ public:
 private:
   /// the image that is currently being processed
   const Dependency<ImageData> imageData_;
+  /// the table that tells whether a color is saturated
+  const Dependency<ColorClassTable> colorClassTable_;
   /// debug image counter
   unsigned int counter_;
   /// Sends debug image
@@ -6,7 +6,7 @@ SlidingWindowProvider::SlidingWindowProvider(const ModuleManagerInterface& manag
   , cameraMatrix_(*this)
   , imageData_(*this)
   , imageSegments_(*this)
-  , fieldColor_(*this)
+  , colorClassTable_(*this)
 
   , minWindowSize_(*this, "minWindowSize", [this] { slidingWindowConfigChanged_.fill(true); })
   , samplePointDistance_(*this, "samplePointDistance", [this] {  slidingWindowConfigChanged_.fill(true); })
@@ -105,9 +105,9 @@ void SlidingWindowProvider::calculateScores()
       currentRow--;
     }
     std::vector<SlidingWindow>::iterator currentWindow = currentRow->windows.begin();
-    for (const auto& segment : scanline.segments)
+    for (const auto& segment : imageSegments_->getSegments(scanline))
     {
-      const bool isFieldColor = fieldColor_->isFieldColor(segment.ycbcr422);
+      const bool isFieldColor = colorClassTable_->fieldColor(segment.ycbcr422);
       const auto start = segment.start.x();
       const auto end = segment.end.x();
       while (currentWindow->window.bottomRight.x() < end &&
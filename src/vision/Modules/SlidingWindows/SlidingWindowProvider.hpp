@@ -6,7 +6,7 @@
 #include "Tools/Kinematics/ForwardKinematics.h"
 
 #include "Data/CameraMatrix.hpp"
-#include "Data/FieldColor.hpp"
+#include "Data/ColorClassTable.hpp"
 #include "Data/ImageData.hpp"
 #include "Data/ImageSegments.hpp"
 #include "Data/SlidingWindows.hpp"
@@ -30,7 +30,7 @@ private:
   const Dependency<CameraMatrix> cameraMatrix_;
   const Dependency<ImageData> imageData_;
   const Dependency<ImageSegments> imageSegments_;
-  const Dependency<FieldColor> fieldColor_;
+  const Dependency<ColorClassTable> colorClassTable_;
 
   /// the minimum size of a sliding window in pixel
   const Parameter<int> minWindowSize_;